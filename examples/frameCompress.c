@@ -13,7 +13,7 @@
 #define LIZARD_FOOTER_SIZE 4
 
 static const LizardF_preferences_t lizard_preferences = {
-	{ LizardF_max256KB, LizardF_blockLinked, LizardF_noContentChecksum, LizardF_frame, 0, { 0, 0 } },
+	{ LizardF_max256KB, LizardF_blockLinked, LizardF_noContentChecksum, LizardF_frame, 0, 0, { 0 } },
 	0,   /* compression level */
 	0,   /* autoflush */
 	{ 0, 0, 0, 0 },  /* reserved, must be set to 0 */
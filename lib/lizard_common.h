@@ -64,6 +64,32 @@ extern "C" {
 #define DECOMPLOG_CODEWORDS_LIZv1(...) //printf(__VA_ARGS__)
 
 
+/* LIZARD_PROFILE : cycles and calls of each phase of compression are accumulated into Lizard_stream_t,
+ * see Lizard_getProfile(). A profiled function `f` is wrapped by `f_profiled` (see LIZARD_PROFILE_WRAPPER), which replaces it (#define) in code below. */
+#ifdef LIZARD_PROFILE
+#  if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#    include <intrin.h>
+#    define LIZARD_PROFILE_TICKS() ((U64)__rdtsc())
+#  elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#    define LIZARD_PROFILE_TICKS() ((U64)__builtin_ia32_rdtsc())
+#  elif defined(__GNUC__) && defined(__aarch64__)
+     MEM_STATIC U64 Lizard_profileTicks(void) { U64 t; __asm__ __volatile__ ("mrs %0, cntvct_el0" : "=r" (t)); return t; }
+#    define LIZARD_PROFILE_TICKS() Lizard_profileTicks()
+#  else
+#    include <time.h>   /* clock() : coarse, but portable */
+#    define LIZARD_PROFILE_TICKS() ((U64)clock())
+#  endif
+#  define LIZARD_PROFILE_PHASE(ctx, phase, statement) { U64 const lizardProfileStart = LIZARD_PROFILE_TICKS(); statement; \
+                                                  (ctx)->profile.cycles[phase] += LIZARD_PROFILE_TICKS() - lizardProfileStart; (ctx)->profile.calls[phase]++; }
+#else
+#  define LIZARD_PROFILE_PHASE(ctx, phase, statement) statement
+#endif
+
+/* defines `f_profiled`, taking `params` and calling `f` with `args`, accounted to `phase` of `ctx` ; without LIZARD_PROFILE, it only forwards */
+#define LIZARD_PROFILE_WRAPPER(type, f, ctx, phase, params, args) \
+    FORCE_INLINE type f##_profiled params { type lizardProfileResult; LIZARD_PROFILE_PHASE(ctx, phase, lizardProfileResult = f args); return lizardProfileResult; }
+
+
 
 
 /*-************************************
@@ -151,6 +177,9 @@ struct Lizard_stream_s
     U32   dictLimit;        /* below that point, need extDict */
     U32   lowLimit;         /* below that point, no more dict */
     U32   nextToUpdate;     /* index from which to continue dictionary update */
+    BYTE* ringBuffer;       /* history owned by stream, see Lizard_setRingBuffer() */
+    U32   ringBufferSize;
+    U32   ringBufferPos;    /* next block is appended here */
     U32   allocatedMemory;
     int   compressionLevel;
     Lizard_parameters params;
@@ -190,6 +219,9 @@ struct Lizard_stream_s
     const BYTE* diffBase;
     const BYTE* srcBase;
     const BYTE* destBase;
+#ifdef LIZARD_PROFILE
+    Lizard_profile_t profile;   /* since Lizard_initStream() */
+#endif
 };
 
 struct Lizard_streamDecode_s {
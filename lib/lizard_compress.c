@@ -67,6 +67,39 @@ int Lizard_versionNumber (void) { return LIZARD_VERSION_NUMBER; }
 int Lizard_compressBound(int isize)  { return LIZARD_COMPRESSBOUND(isize); }
 int Lizard_sizeofState_MinLevel() { return Lizard_sizeofState(LIZARD_MIN_CLEVEL); }
 
+const Lizard_profile_t* Lizard_getProfile(const Lizard_stream_t* ctx)
+{
+#ifdef LIZARD_PROFILE
+    return &ctx->profile;
+#else
+    (void)ctx;
+    return NULL;
+#endif
+}
+
+
+
+/* *************************************
+*  Profiled codewords
+***************************************/
+LIZARD_PROFILE_WRAPPER(int, Lizard_encodeSequence_LZ4, ctx, Lizard_phase_encoding,
+                       (Lizard_stream_t* ctx, const BYTE** ip, const BYTE** anchor, size_t matchLength, const BYTE* const match), (ctx, ip, anchor, matchLength, match))
+#define Lizard_encodeSequence_LZ4 Lizard_encodeSequence_LZ4_profiled
+
+LIZARD_PROFILE_WRAPPER(size_t, Lizard_get_price_LZ4, ctx, Lizard_phase_pricing,
+                       (Lizard_stream_t* const ctx, const BYTE *ip, const size_t litLength, U32 offset, size_t matchLength), (ctx, ip, litLength, offset, matchLength))
+#define Lizard_get_price_LZ4 Lizard_get_price_LZ4_profiled
+
+#ifndef USE_LZ4_ONLY
+LIZARD_PROFILE_WRAPPER(int, Lizard_encodeSequence_LIZv1, ctx, Lizard_phase_encoding,
+                       (Lizard_stream_t* ctx, const BYTE** ip, const BYTE** anchor, size_t matchLength, const BYTE* const match), (ctx, ip, anchor, matchLength, match))
+#define Lizard_encodeSequence_LIZv1 Lizard_encodeSequence_LIZv1_profiled
+
+LIZARD_PROFILE_WRAPPER(size_t, Lizard_get_price_LIZv1, ctx, Lizard_phase_pricing,
+                       (Lizard_stream_t* const ctx, int rep, const BYTE *ip, const BYTE *off24pos, size_t litLength, U32 offset, size_t matchLength), (ctx, rep, ip, off24pos, litLength, offset, matchLength))
+#define Lizard_get_price_LIZv1 Lizard_get_price_LIZv1_profiled
+#endif
+
 
 
 /* *************************************
@@ -148,9 +181,9 @@ FORCE_INLINE int Lizard_writeStream(int useHuff, Lizard_stream_t* ctx, BYTE* str
         useHuffBuf = ((size_t)(oend - (*op + 6)) < HUF_compressBound(streamLen)); 
         if (useHuffBuf) {
             if (streamLen > LIZARD_BLOCK_SIZE) { LIZARD_LOG_COMPRESS("streamLen[%d] > LIZARD_BLOCK_SIZE\n", streamLen); return -1; }
-            ctx->comprStreamLen = (U32)HUF_compress(ctx->huffBase, ctx->huffEnd - ctx->huffBase, streamPtr, streamLen);
+            LIZARD_PROFILE_PHASE(ctx, Lizard_phase_entropy, ctx->comprStreamLen = (U32)HUF_compress(ctx->huffBase, ctx->huffEnd - ctx->huffBase, streamPtr, streamLen));
         } else {
-            ctx->comprStreamLen = (U32)HUF_compress(*op + 6, oend - (*op + 6), streamPtr, streamLen);
+            LIZARD_PROFILE_PHASE(ctx, Lizard_phase_entropy, ctx->comprStreamLen = (U32)HUF_compress(*op + 6, oend - (*op + 6), streamPtr, streamLen));
         }
 
         if (!HUF_isError(ctx->comprStreamLen)) {
@@ -235,7 +268,7 @@ int Lizard_writeBlock(Lizard_stream_t* ctx, const BYTE* ip, uint32_t inputSize,
 _write_uncompressed:
     LIZARD_LOG_COMPRESS("%d: total=%d block=%d UNCOMPRESSED inputSize=%u outSize=%d\n", (int)(ip - ctx->srcBase),
             (int)(*op - ctx->destBase), (int)(*op-start), inputSize, (int)(oend-start));
-    if ((uint32_t)(oend - start) < inputSize + 4) goto _output_error;
+    if ((oend < start) || ((uint32_t)(oend - start) < inputSize + 4)) goto _output_error;
     *start = LIZARD_FLAG_UNCOMPRESSED;
     *op = start + 1;
     MEM_writeLE24(*op, inputSize);
@@ -308,13 +341,86 @@ int Lizard_verifyCompressionLevel(int compressionLevel)
 }
 
 
-int Lizard_sizeofState(int compressionLevel) 
-{ 
+static int Lizard_usesChain(Lizard_parser_type parser)
+{
+    return parser == Lizard_parser_hashChain || parser == Lizard_parser_lowestPrice
+        || parser == Lizard_parser_optimalPrice || parser == Lizard_parser_optimalPriceBT;
+}
+
+/* parameters of `compressionLevel`, with non-zero fields of `cParams` (may be NULL) instead of defaults.
+   Another parser starts from parameters of the first level using it with the same codewords.
+   return : 0 if cParams are invalid for this level */
+static int Lizard_getParameters(Lizard_parameters* params, int compressionLevel, const Lizard_cParams_t* cParams)
+{
+    *params = Lizard_defaultParameters[compressionLevel - LIZARD_MIN_CLEVEL];
+    if (!cParams) return 1;
+
+    if (cParams->parser) {
+        Lizard_parser_type const parser = (Lizard_parser_type)(cParams->parser - 1);
+        Lizard_parser_type const baseParser = (parser == Lizard_parser_optimalPrice) ? Lizard_parser_optimalPriceBT : parser;   /* no level uses optimalPrice */
+        size_t u;
+        if (cParams->parser - 1 > Lizard_parser_optimalPriceBT) return 0;
+        for (u=0; u<sizeof(Lizard_defaultParameters)/sizeof(Lizard_defaultParameters[0]); u++)
+            if (Lizard_defaultParameters[u].parserType == baseParser && Lizard_defaultParameters[u].decompressType == params->decompressType) break;
+        if (u == sizeof(Lizard_defaultParameters)/sizeof(Lizard_defaultParameters[0])) return 0;   /* parser doesn't produce these codewords */
+        *params = Lizard_defaultParameters[u];
+        params->parserType = parser;
+    }
+    if (cParams->windowLog) {
+        U32 const windowLogMax = (params->decompressType == Lizard_coderwords_LZ4) ? LIZARD_WINDOWLOG_LZ4 : LIZARD_WINDOWLOG_MAX;   /* 16-bit offsets */
+        if (cParams->windowLog < LIZARD_WINDOWLOG_MIN || cParams->windowLog > windowLogMax) return 0;
+        params->windowLog = cParams->windowLog;
+    }
+    if (cParams->contentLog) {
+        if (cParams->contentLog < LIZARD_CONTENTLOG_MIN || cParams->contentLog > LIZARD_CONTENTLOG_MAX) return 0;
+        if (Lizard_usesChain(params->parserType)) params->contentLog = cParams->contentLog;
+    }
+    if (cParams->hashLog) {
+        if (cParams->hashLog < LIZARD_HASHLOG_MIN || cParams->hashLog > LIZARD_HASHLOG_MAX) return 0;
+        if (params->parserType != Lizard_parser_fastSmall && params->parserType != Lizard_parser_fast)   /* these hash with a fixed hashLog */
+            params->hashLog = cParams->hashLog;
+    }
+    if (cParams->searchNum) {
+        if (cParams->searchNum > LIZARD_SEARCHNUM_MAX) return 0;
+        params->searchNum = cParams->searchNum;
+    }
+    if (cParams->searchLength) {
+        if (cParams->searchLength < LIZARD_SEARCHLENGTH_MIN || cParams->searchLength > LIZARD_SEARCHLENGTH_MAX) return 0;
+        params->searchLength = cParams->searchLength;
+    }
+    if (cParams->sufficientLength) {
+        if (cParams->sufficientLength > LIZARD_SUFFICIENTLENGTH_MAX) return 0;
+        params->sufficientLength = cParams->sufficientLength;
+    }
+    return 1;
+}
+
+int Lizard_getCParams(int compressionLevel, Lizard_cParams_t* cParams)
+{
     Lizard_parameters params;
+    compressionLevel = Lizard_verifyCompressionLevel(compressionLevel);
+    if (!Lizard_getParameters(&params, compressionLevel, cParams)) return 0;
+    memset(cParams, 0, sizeof(*cParams));   /* parameters not read by parser remain 0 */
+    cParams->windowLog = params.windowLog;
+    if (params.parserType != Lizard_parser_fastSmall && params.parserType != Lizard_parser_fast)   /* these hash with a fixed hashLog */
+        cParams->hashLog = params.hashLog;
+    if (Lizard_usesChain(params.parserType)) {
+        cParams->contentLog = params.contentLog;
+        cParams->searchNum = params.searchNum;
+    }
+    if (params.parserType >= Lizard_parser_hashChain)   /* faster parsers hash a fixed length */
+        cParams->searchLength = params.searchLength;
+    if (params.parserType >= Lizard_parser_lowestPrice)
+        cParams->sufficientLength = params.sufficientLength;
+    cParams->parser = (unsigned)params.parserType + 1;
+    return 1;
+}
+
+
+static int Lizard_sizeofState_params(Lizard_parameters params)
+{
     U32 hashTableSize, chainTableSize;
 
-    compressionLevel = Lizard_verifyCompressionLevel(compressionLevel);
-    params = Lizard_defaultParameters[compressionLevel - LIZARD_MIN_CLEVEL];
 //    hashTableSize = (U32)(sizeof(U32)*(((size_t)1 << params.hashLog3)+((size_t)1 << params.hashLog)));
     hashTableSize = (U32)(sizeof(U32)*(((size_t)1 << params.hashLog)));
     chainTableSize = (U32)(sizeof(U32)*((size_t)1 << params.contentLog));
@@ -322,6 +428,22 @@ int Lizard_sizeofState(int compressionLevel)
     return sizeof(Lizard_stream_t) + hashTableSize + chainTableSize + LIZARD_COMPRESS_ADD_BUF + (int)LIZARD_COMPRESS_ADD_HUF;
 }
 
+int Lizard_sizeofState(int compressionLevel) 
+{ 
+    Lizard_parameters params;
+    compressionLevel = Lizard_verifyCompressionLevel(compressionLevel);
+    Lizard_getParameters(&params, compressionLevel, NULL);
+    return Lizard_sizeofState_params(params);
+}
+
+int Lizard_sizeofState_advanced(int compressionLevel, Lizard_cParams_t cParams)
+{
+    Lizard_parameters params;
+    compressionLevel = Lizard_verifyCompressionLevel(compressionLevel);
+    if (!Lizard_getParameters(&params, compressionLevel, &cParams)) return 0;
+    return Lizard_sizeofState_params(params);
+}
+
 
 static void Lizard_init(Lizard_stream_t* ctx, const BYTE* start)
 {
@@ -343,14 +465,11 @@ static void Lizard_init(Lizard_stream_t* ctx, const BYTE* start)
 
 
 /* if ctx==NULL memory is allocated and returned as value */
-Lizard_stream_t* Lizard_initStream(Lizard_stream_t* ctx, int compressionLevel) 
+static Lizard_stream_t* Lizard_initStream_params(Lizard_stream_t* ctx, int compressionLevel, Lizard_parameters params) 
 { 
-    Lizard_parameters params;
     U32 hashTableSize, chainTableSize;
     void *tempPtr;
 
-    compressionLevel = Lizard_verifyCompressionLevel(compressionLevel);
-    params = Lizard_defaultParameters[compressionLevel - LIZARD_MIN_CLEVEL];
 //    hashTableSize = (U32)(sizeof(U32)*(((size_t)1 << params.hashLog3)+((size_t)1 << params.hashLog)));
     hashTableSize = (U32)(sizeof(U32)*(((size_t)1 << params.hashLog)));
     chainTableSize = (U32)(sizeof(U32)*((size_t)1 << params.contentLog));
@@ -371,6 +490,9 @@ Lizard_stream_t* Lizard_initStream(Lizard_stream_t* ctx, int compressionLevel)
     ctx->chainTableSize = chainTableSize;
     ctx->params = params;
     ctx->compressionLevel = (unsigned)compressionLevel;
+#ifdef LIZARD_PROFILE
+    memset(&ctx->profile, 0, sizeof(ctx->profile));
+#endif
     if (compressionLevel < 30)
         ctx->huffType = 0;
     else
@@ -387,12 +509,25 @@ Lizard_stream_t* Lizard_initStream(Lizard_stream_t* ctx, int compressionLevel)
     return ctx;
 }
 
+Lizard_stream_t* Lizard_initStream(Lizard_stream_t* ctx, int compressionLevel) 
+{ 
+    Lizard_parameters params;
+    compressionLevel = Lizard_verifyCompressionLevel(compressionLevel);
+    Lizard_getParameters(&params, compressionLevel, NULL);
+    return Lizard_initStream_params(ctx, compressionLevel, params);
+}
+
 
 
 Lizard_stream_t* Lizard_createStream(int compressionLevel) 
 { 
     Lizard_stream_t* ctx = Lizard_initStream(NULL, compressionLevel);
-    if (ctx) ctx->base = NULL;
+    if (ctx) {
+        ctx->base = NULL;
+        ctx->ringBuffer = NULL;   /* ring buffer fields are only set by streams : Lizard_initStream() keeps them, for states provided by caller */
+        ctx->ringBufferSize = 0;
+        ctx->ringBufferPos = 0;
+    }
     return ctx; 
 }
 
@@ -402,14 +537,20 @@ Lizard_stream_t* Lizard_resetStream(Lizard_stream_t* ctx, int compressionLevel)
 {
     size_t wanted = Lizard_sizeofState(compressionLevel);
 
+    BYTE* const ringBuffer = ctx->ringBuffer;   /* ring buffer survives reset and reallocation */
+    U32 const ringBufferSize = ctx->ringBufferSize;
+
     if (ctx->allocatedMemory < wanted) {
-        Lizard_freeStream(ctx);
+        free(ctx);
         ctx = Lizard_createStream(compressionLevel);
+        if (!ctx) { free(ringBuffer); return NULL; }
     } else {
         Lizard_initStream(ctx, compressionLevel);
     }
-
-    if (ctx) ctx->base = NULL;
+    ctx->ringBuffer = ringBuffer;
+    ctx->ringBufferSize = ringBufferSize;
+    ctx->ringBufferPos = 0;
+    ctx->base = NULL;
     return ctx;
 }
 
@@ -417,6 +558,7 @@ Lizard_stream_t* Lizard_resetStream(Lizard_stream_t* ctx, int compressionLevel)
 int Lizard_freeStream(Lizard_stream_t* ctx) 
 { 
     if (ctx) {
+        free(ctx->ringBuffer);
         free(ctx);
     }
     return 0; 
@@ -485,11 +627,12 @@ FORCE_INLINE int Lizard_compress_generic (
 
     (void)dictSize;
     LIZARD_LOG_COMPRESS("Lizard_compress_generic source=%p inputSize=%d dest=%p maxOutputSize=%d cLevel=%d dictBase=%p dictSize=%d\n", source, inputSize, dest, maxOutputSize, ctx->compressionLevel, ctx->dictBase, (int)dictSize); 
-    *op++ = (BYTE)ctx->compressionLevel;
-    maxOutputSize--; // can be lower than 0
     ctx->end += inputSize;
     ctx->srcBase = ctx->off24pos = ip;
     ctx->destBase = (BYTE*)dest;
+    if (maxOutputSize < 1) return 0;   /* no room for level byte : input is still part of history, as on other errors */
+    *op++ = (BYTE)ctx->compressionLevel;
+    maxOutputSize--; // can be lower than 0
 
     while (inputSize > 0)
     {
@@ -546,6 +689,41 @@ _output_error:
     return 0;
 }
 
+LIZARD_PROFILE_WRAPPER(int, Lizard_compress_generic, (Lizard_stream_t*)ctxvoid, Lizard_phase_total,
+                       (void* ctxvoid, const char* source, char* dest, int inputSize, int maxOutputSize), (ctxvoid, source, dest, inputSize, maxOutputSize))
+#define Lizard_compress_generic Lizard_compress_generic_profiled
+
+
+/* Lizard_rebase() :
+ * Moves all indices down by a multiple of LIZARD_REBASE_STEP, so index space never overflows in long streams.
+ * Chain tables store distances, and are addressed by (index & contentMask), so they remain valid as long as
+ * the step is a multiple of chain table size : only hashTable, which stores indices, has to be updated.
+ * History older than LIZARD_DICT_SIZE is dropped (set below lowLimit). */
+#define LIZARD_REBASE_STEP (1U<<30)
+static void Lizard_rebase(Lizard_stream_t* ctxPtr)
+{
+    U32 const endIndex = (U32)(ctxPtr->end - ctxPtr->base);
+    U32 const delta = (endIndex - 2*LIZARD_DICT_SIZE) & ~(LIZARD_REBASE_STEP-1);
+    U32 const minIndex = endIndex - LIZARD_DICT_SIZE;
+    U32* const hashTable = ctxPtr->hashTable;
+    size_t const hashTableSize = ctxPtr->hashTableSize / sizeof(U32);
+    size_t i;
+
+    for (i=0; i<hashTableSize; i++) {   /* branchless, vectorized by compiler */
+        U32 const index = hashTable[i];
+        hashTable[i] = (index < delta) ? 0 : index - delta;
+    }
+
+    if (ctxPtr->lowLimit < minIndex) ctxPtr->lowLimit = minIndex;
+    if (ctxPtr->dictLimit < ctxPtr->lowLimit) ctxPtr->dictLimit = ctxPtr->lowLimit;
+    if (ctxPtr->nextToUpdate < ctxPtr->lowLimit) ctxPtr->nextToUpdate = ctxPtr->lowLimit;
+    ctxPtr->base += delta;
+    ctxPtr->dictBase += delta;
+    ctxPtr->lowLimit -= delta;
+    ctxPtr->dictLimit -= delta;
+    ctxPtr->nextToUpdate -= delta;
+}
+
 
 int Lizard_compress_continue (Lizard_stream_t* ctxPtr,
                                             const char* source, char* dest,
@@ -555,11 +733,7 @@ int Lizard_compress_continue (Lizard_stream_t* ctxPtr,
     if (ctxPtr->base == NULL) Lizard_init(ctxPtr, (const BYTE*) source);
 
     /* Check overflow */
-    if ((size_t)(ctxPtr->end - ctxPtr->base) > 2 GB) {
-        size_t dictSize = (size_t)(ctxPtr->end - ctxPtr->base) - ctxPtr->dictLimit;
-        if (dictSize > LIZARD_DICT_SIZE) dictSize = LIZARD_DICT_SIZE;
-        Lizard_loadDict((Lizard_stream_t*)ctxPtr, (const char*)(ctxPtr->end) - dictSize, (int)dictSize);
-    }
+    if ((size_t)(ctxPtr->end - ctxPtr->base) > 2 GB) Lizard_rebase(ctxPtr);
 
     /* Check if blocks follow each other */
     if ((const BYTE*)source != ctxPtr->end) 
@@ -580,6 +754,47 @@ int Lizard_compress_continue (Lizard_stream_t* ctxPtr,
 }
 
 
+/* ring buffer streaming */
+int Lizard_setRingBuffer(Lizard_stream_t* ctxPtr, int ringBufferSize)
+{
+    free(ctxPtr->ringBuffer);
+    ctxPtr->ringBuffer = NULL;
+    ctxPtr->ringBufferSize = 0;
+    ctxPtr->ringBufferPos = 0;
+    ctxPtr->base = NULL;   /* start a new stream */
+    if ((ringBufferSize <= 0) || (ringBufferSize > LIZARD_MAX_INPUT_SIZE)) return 0;
+
+    ctxPtr->ringBuffer = (BYTE*)malloc((size_t)ringBufferSize);
+    if (!ctxPtr->ringBuffer) return 0;
+    ctxPtr->ringBufferSize = (U32)ringBufferSize;
+    return ringBufferSize;
+}
+
+
+char* Lizard_getRingBuffer(Lizard_stream_t* ctxPtr, int srcSize)
+{
+    if ((ctxPtr->ringBuffer == NULL) || (srcSize < 0) || ((U32)srcSize > ctxPtr->ringBufferSize)) return NULL;
+    if (ctxPtr->ringBufferPos + (U32)srcSize > ctxPtr->ringBufferSize) return (char*)ctxPtr->ringBuffer;   /* wraparound */
+    return (char*)ctxPtr->ringBuffer + ctxPtr->ringBufferPos;
+}
+
+
+int Lizard_compress_ringBuffer(Lizard_stream_t* ctxPtr, const char* src, char* dst, int srcSize, int maxDstSize)
+{
+    char* const block = Lizard_getRingBuffer(ctxPtr, srcSize);
+    int cSize;
+    if (block == NULL) return 0;
+
+    /* data appended in place costs nothing; otherwise only the new block is copied, whatever the history size */
+    if (src != block) memmove(block, src, (size_t)srcSize);
+
+    /* after wraparound, previous content of ring buffer becomes extDict, overwritten part is excluded by Lizard_compress_continue() */
+    cSize = Lizard_compress_continue(ctxPtr, block, dst, srcSize, maxDstSize);
+    ctxPtr->ringBufferPos = (U32)(block - (char*)ctxPtr->ringBuffer) + (U32)srcSize;
+    return cSize;
+}
+
+
 int Lizard_compress_extState (void* state, const char* src, char* dst, int srcSize, int maxDstSize, int compressionLevel)
 {
     Lizard_stream_t* ctx = (Lizard_stream_t*) state;
@@ -593,6 +808,22 @@ int Lizard_compress_extState (void* state, const char* src, char* dst, int srcSi
 }
 
 
+int Lizard_compress_advanced (void* state, const char* src, char* dst, int srcSize, int maxDstSize, int compressionLevel, Lizard_cParams_t cParams)
+{
+    Lizard_stream_t* ctx = (Lizard_stream_t*) state;
+    Lizard_parameters params;
+    if (((size_t)(state)&(sizeof(void*)-1)) != 0) return 0;   /* Error : state is not aligned for pointers (32 or 64 bits) */
+
+    /* initialize stream */
+    compressionLevel = Lizard_verifyCompressionLevel(compressionLevel);
+    if (!Lizard_getParameters(&params, compressionLevel, &cParams)) return 0;
+    Lizard_initStream_params(ctx, compressionLevel, params);
+    Lizard_init(ctx, (const BYTE*)src);
+
+    return Lizard_compress_generic (state, src, dst, srcSize, maxDstSize);
+}
+
+
 int Lizard_compress(const char* src, char* dst, int srcSize, int maxDstSize, int compressionLevel)
 {
     int cSize;
@@ -143,12 +143,68 @@ Lizard_compress_extState() :
     Use Lizard_sizeofState() to know how much memory must be allocated,
     and allocate it on 8-bytes boundaries (using malloc() typically).
     Then, provide it as 'void* state' to compression function.
+    A stream created by Lizard_createStream() can also be provided : its ring buffer, if any, is kept.
 */
 LIZARDLIB_API int Lizard_sizeofState(int compressionLevel); 
 
 LIZARDLIB_API int Lizard_compress_extState(void* state, const char* src, char* dst, int srcSize, int maxDstSize, int compressionLevel);
 
 
+/*!
+Lizard_compress_advanced() :
+    Same as Lizard_compress_extState(), with parameters of compressionLevel replaced by `cParams`.
+    Fields left to 0 keep the default of compressionLevel :
+        hashLog          : [LIZARD_HASHLOG_MIN-LIZARD_HASHLOG_MAX] hash table of 2^hashLog entries : larger == more memory, faster search.
+                           Ignored by fastSmall and fast parsers (levels 10, 11, 30 and 31), whose hash table has a fixed size.
+        searchNum        : [1-LIZARD_SEARCHNUM_MAX] nb of candidate matches searched : larger == more compression, slower.
+                           Only used by parsers with a chain (hashChain, lowestPrice, optimalPrice, optimalPriceBT).
+        windowLog        : [LIZARD_WINDOWLOG_MIN-LIZARD_WINDOWLOG_MAX] largest match distance is 2^windowLog.
+                           Up to 16 for levels 10-19 and 30-39, whose offsets are 16-bit.
+        contentLog       : [LIZARD_CONTENTLOG_MIN-LIZARD_CONTENTLOG_MAX] chain or binary tree of 2^contentLog entries.
+                           Only used by parsers with a chain.
+        searchLength     : [LIZARD_SEARCHLENGTH_MIN-LIZARD_SEARCHLENGTH_MAX] nb of bytes hashed : larger == faster, shorter matches are missed.
+        sufficientLength : [1-LIZARD_SUFFICIENTLENGTH_MAX] matches this long are taken without further search (lowestPrice, optimal parsers).
+        parser           : 1 + Lizard_parser_type (1 fastSmall, 2 fast, 3 fastBig, 4 noChain, 5 hashChain, 6 priceFast,
+                           7 lowestPrice, 8 optimalPrice, 9 optimalPriceBT). Other fields then default to those of the first level
+                           using this parser. Codewords are those of compressionLevel : fastSmall, fast, noChain and hashChain
+                           produce those of levels 10-19 and 30-39 only, fastBig, priceFast and lowestPrice those of levels 20-29 and 40-49.
+    Output is decoded by regular decompression functions.
+    `state` must be Lizard_sizeofState_advanced() bytes, allocated on 8-bytes boundaries.
+    Return : compressed size, or 0 on error (including cParams invalid for compressionLevel, for which Lizard_sizeofState_advanced() is 0)
+*/
+#define LIZARD_WINDOWLOG_MIN          10
+#define LIZARD_WINDOWLOG_MAX          24
+#define LIZARD_CONTENTLOG_MIN         10
+#define LIZARD_CONTENTLOG_MAX         26
+#define LIZARD_HASHLOG_MIN            10
+#define LIZARD_HASHLOG_MAX            26
+#define LIZARD_SEARCHNUM_MAX          (1<<16)
+#define LIZARD_SEARCHLENGTH_MIN       4
+#define LIZARD_SEARCHLENGTH_MAX       7
+#define LIZARD_SUFFICIENTLENGTH_MAX   (1<<12)
+typedef struct {
+    unsigned hashLog;
+    unsigned searchNum;
+    unsigned windowLog;
+    unsigned contentLog;
+    unsigned searchLength;
+    unsigned sufficientLength;
+    unsigned parser;
+} Lizard_cParams_t;
+
+LIZARDLIB_API int Lizard_sizeofState_advanced(int compressionLevel, Lizard_cParams_t cParams);
+
+LIZARDLIB_API int Lizard_compress_advanced(void* state, const char* src, char* dst, int srcSize, int maxDstSize, int compressionLevel, Lizard_cParams_t cParams);
+
+/*! Lizard_getCParams() :
+ *  Replaces fields of `cParams` left to 0 by values used by Lizard_compress_advanced() with compressionLevel,
+ *  so that all parameters of a level can be read (from a zeroed `cParams`), then modified.
+ *  Parameters without meaning for a level (e.g. contentLog of fast levels) are 0.
+ *  Return : 1, or 0 if cParams are invalid for compressionLevel
+ */
+LIZARDLIB_API int Lizard_getCParams(int compressionLevel, Lizard_cParams_t* cParams);
+
+
 
 /*-*********************************************
 *  Streaming Compression Functions
@@ -198,6 +254,58 @@ LIZARDLIB_API int Lizard_compress_continue (Lizard_stream_t* streamPtr, const ch
 LIZARDLIB_API int Lizard_saveDict (Lizard_stream_t* streamPtr, char* safeBuffer, int dictSize);
 
 
+/*! Lizard_setRingBuffer() :
+ *  Allocates a ring buffer of 'ringBufferSize' bytes owned by 'streamPtr' and starts a new stream using it as history.
+ *  Input appended into the ring buffer never needs Lizard_saveDict() : on wraparound, previous content remains referenced,
+ *  so history is bounded by ringBufferSize (and by window size of compression level).
+ *  A size of 0 releases the ring buffer.
+ *  'streamPtr' must be created by Lizard_createStream() : states only initialized by Lizard_compress_extState() have no ring buffer fields.
+ *  Return : ringBufferSize, or 0 if released or if error.
+ */
+LIZARDLIB_API int Lizard_setRingBuffer (Lizard_stream_t* streamPtr, int ringBufferSize);
+
+/*! Lizard_getRingBuffer() :
+ *  Provides position within ring buffer where next block of 'srcSize' bytes will be appended.
+ *  Writing input directly there avoids any copy within Lizard_compress_ringBuffer().
+ *  Return : NULL if no ring buffer is set or if srcSize > ringBufferSize.
+ */
+LIZARDLIB_API char* Lizard_getRingBuffer (Lizard_stream_t* streamPtr, int srcSize);
+
+/*! Lizard_compress_ringBuffer() :
+ *  Appends 'src' into ring buffer (nothing is copied if 'src' was provided by Lizard_getRingBuffer())
+ *  and compresses it, using previous content of ring buffer as dictionary.
+ *  Return : compressed size, or 0 if compression fails.
+ */
+LIZARDLIB_API int Lizard_compress_ringBuffer (Lizard_stream_t* streamPtr, const char* src, char* dst, int srcSize, int maxDstSize);
+
+
+/*-*********************************************
+*  Profiling
+***********************************************/
+typedef enum {
+    Lizard_phase_matchFinding,  /* hash chain, binary tree and lowest price searches */
+    Lizard_phase_pricing,       /* Lizard_get_price_LIZv1(), Lizard_get_price_LZ4() */
+    Lizard_phase_encoding,      /* sequences written into streams */
+    Lizard_phase_entropy,       /* HUF_compress() of streams */
+    Lizard_phase_total,         /* whole compression calls */
+    Lizard_phase_count
+} Lizard_phase_e;
+
+typedef struct {
+    unsigned long long cycles[Lizard_phase_count];   /* time stamp counter ticks (x86, arm64), clock() ticks elsewhere */
+    unsigned long long calls[Lizard_phase_count];
+} Lizard_profile_t;
+
+/*! Lizard_getProfile() :
+ *  Provides cycles and calls of each phase since `streamPtr` was initialized (Lizard_createStream(), Lizard_resetStream(),
+ *  Lizard_compress_extState()). Phases can nest : price evaluation within lowest-price searches is also match finding.
+ *  Parsing not attributed to a phase (e.g. inlined searches of fast levels) is the remainder of Lizard_phase_total.
+ *  Only available when the library is compiled with LIZARD_PROFILE, which also makes each profiled call slower.
+ *  Return : NULL otherwise.
+ */
+LIZARDLIB_API const Lizard_profile_t* Lizard_getProfile (const Lizard_stream_t* streamPtr);
+
+
 
 
 
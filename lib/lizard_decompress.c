@@ -36,10 +36,6 @@
 /**************************************
 *  Includes
 **************************************/
-//#define LIZARD_STATS 1 // 0=simple stats, 1=more, 2=full
-#ifdef LIZARD_STATS
-    #include "test/lizard_stats.h"
-#endif
 #include "lizard_compress.h"
 #include "lizard_decompress.h"
 #include "lizard_common.h"
@@ -69,7 +65,7 @@ typedef enum { full = 0, partial = 1 } earlyEnd_directive;
 *  Decompression functions
 *******************************/
 
-FORCE_INLINE size_t Lizard_readStream(int flag, const BYTE** ip, const BYTE* const iend, BYTE* op, BYTE* const oend, const BYTE** streamPtr, const BYTE** streamEnd, int streamFlag)
+FORCE_INLINE size_t Lizard_readStream(int flag, const BYTE** ip, const BYTE* const iend, BYTE* op, BYTE* const oend, const BYTE** streamPtr, const BYTE** streamEnd)
 {
     if (!flag) {
         if (*ip > iend - 3) return 0;
@@ -77,11 +73,6 @@ FORCE_INLINE size_t Lizard_readStream(int flag, const BYTE** ip, const BYTE* con
         *streamEnd = *streamPtr + MEM_readLE24(*ip);
         if (*streamEnd < *streamPtr) return 0;
         *ip = *streamEnd;
-#ifdef LIZARD_STATS
-        uncompr_stream[streamFlag] += *streamEnd-*streamPtr;
-#else
-        (void)streamFlag;
-#endif
         return 1;
     } else {
 #ifndef LIZARD_NO_HUFFMAN
@@ -98,10 +89,6 @@ FORCE_INLINE size_t Lizard_readStream(int flag, const BYTE** ip, const BYTE* con
         *ip += comprStreamLen + 6;
         *streamPtr = op;
         *streamEnd = *streamPtr + streamLen;
-#ifdef LIZARD_STATS
-        compr_stream[streamFlag] += comprStreamLen + 6;
-        decompr_stream[streamFlag] += *streamEnd-*streamPtr;
-#endif
         return 1;
 #else
         fprintf(stderr, "compiled with LIZARD_NO_HUFFMAN\n");
@@ -153,9 +140,6 @@ FORCE_INLINE int Lizard_decompress_generic(
     decompOff24Base = decompFlagsBase + LIZARD_HUF_BLOCK_SIZE;
     decompOff16Base = decompOff24Base + LIZARD_HUF_BLOCK_SIZE;
 
-#ifdef LIZARD_STATS
-    init_stats();
-#endif
     (void)istart;
 
     while (ip < iend)
@@ -173,9 +157,6 @@ FORCE_INLINE int Lizard_decompress_generic(
             op += length;
             ip += length;
             if ((partialDecoding) && (op >= oexit)) break;
-#ifdef LIZARD_STATS
-            uncompr_stream[LIZARD_STREAM_UNCOMPRESSED] += length;
-#endif
             continue;
         }
         
@@ -187,9 +168,6 @@ FORCE_INLINE int Lizard_decompress_generic(
         ctx.lenPtr = (const BYTE*)ip + 3;
         ctx.lenEnd = ctx.lenPtr + MEM_readLE24(ip);
         if (ctx.lenEnd < ctx.lenPtr || (ctx.lenEnd > iend - 3)) goto _output_error;
-#ifdef LIZARD_STATS
-        uncompr_stream[LIZARD_STREAM_LEN] += ctx.lenEnd-ctx.lenPtr + 3;
-#endif
         ip = ctx.lenEnd;
 
         {   size_t streamLen;
@@ -197,25 +175,25 @@ FORCE_INLINE int Lizard_decompress_generic(
             const BYTE* ipos;
             size_t comprFlagsLen, comprLiteralsLen, total;
 #endif
-            streamLen = Lizard_readStream(res&LIZARD_FLAG_OFFSET16, &ip, iend, decompOff16Base, decompOff16Base + LIZARD_HUF_BLOCK_SIZE, &ctx.offset16Ptr, &ctx.offset16End, LIZARD_STREAM_OFFSET16);
+            streamLen = Lizard_readStream(res&LIZARD_FLAG_OFFSET16, &ip, iend, decompOff16Base, decompOff16Base + LIZARD_HUF_BLOCK_SIZE, &ctx.offset16Ptr, &ctx.offset16End);
             if (streamLen == 0) goto _output_error;
 
-            streamLen = Lizard_readStream(res&LIZARD_FLAG_OFFSET24, &ip, iend, decompOff24Base, decompOff24Base + LIZARD_HUF_BLOCK_SIZE, &ctx.offset24Ptr, &ctx.offset24End, LIZARD_STREAM_OFFSET24);
+            streamLen = Lizard_readStream(res&LIZARD_FLAG_OFFSET24, &ip, iend, decompOff24Base, decompOff24Base + LIZARD_HUF_BLOCK_SIZE, &ctx.offset24Ptr, &ctx.offset24End);
             if (streamLen == 0) goto _output_error;
 
 #ifdef LIZARD_USE_LOGS
             ipos = ip;
-            streamLen = Lizard_readStream(res&LIZARD_FLAG_FLAGS, &ip, iend, decompFlagsBase, decompFlagsBase + LIZARD_HUF_BLOCK_SIZE, &ctx.flagsPtr, &ctx.flagsEnd, LIZARD_STREAM_FLAGS);
+            streamLen = Lizard_readStream(res&LIZARD_FLAG_FLAGS, &ip, iend, decompFlagsBase, decompFlagsBase + LIZARD_HUF_BLOCK_SIZE, &ctx.flagsPtr, &ctx.flagsEnd);
             if (streamLen == 0) goto _output_error;
             streamLen = (size_t)(ctx.flagsEnd-ctx.flagsPtr);
             comprFlagsLen = ((size_t)(ip - ipos) + 3 >= streamLen) ? 0 : (size_t)(ip - ipos);
             ipos = ip;
 #else
-            streamLen = Lizard_readStream(res&LIZARD_FLAG_FLAGS, &ip, iend, decompFlagsBase, decompFlagsBase + LIZARD_HUF_BLOCK_SIZE, &ctx.flagsPtr, &ctx.flagsEnd, LIZARD_STREAM_FLAGS);
+            streamLen = Lizard_readStream(res&LIZARD_FLAG_FLAGS, &ip, iend, decompFlagsBase, decompFlagsBase + LIZARD_HUF_BLOCK_SIZE, &ctx.flagsPtr, &ctx.flagsEnd);
             if (streamLen == 0) goto _output_error;
 #endif
 
-            streamLen = Lizard_readStream(res&LIZARD_FLAG_LITERALS, &ip, iend, decompLiteralsBase, decompLiteralsBase + LIZARD_HUF_BLOCK_SIZE, &ctx.literalsPtr, &ctx.literalsEnd, LIZARD_STREAM_LITERALS);
+            streamLen = Lizard_readStream(res&LIZARD_FLAG_LITERALS, &ip, iend, decompLiteralsBase, decompLiteralsBase + LIZARD_HUF_BLOCK_SIZE, &ctx.literalsPtr, &ctx.literalsEnd);
             if (streamLen == 0) goto _output_error;
 #ifdef LIZARD_USE_LOGS
             streamLen = (size_t)(ctx.literalsEnd-ctx.literalsPtr);
@@ -249,10 +227,6 @@ FORCE_INLINE int Lizard_decompress_generic(
         if ((partialDecoding) && (op >= oexit)) break;
     }
 
-#ifdef LIZARD_STATS
-    print_stats();
-#endif
-
     LIZARD_LOG_DECOMPRESS("Lizard_decompress_generic total=%d\n", (int)(op-(BYTE*)dest));
     free(decompLiteralsBase);
     return (int)(op-(BYTE*)dest);
@@ -370,3 +344,74 @@ int Lizard_decompress_safe_forceExtDict(const char* source, char* dest, int comp
     return Lizard_decompress_generic(source, dest, compressedSize, maxOutputSize, full, 0, usingExtDict, (BYTE*)dest, (const BYTE*)dictStart, dictSize);
 }
 
+
+/*===== block statistics =====*/
+
+int Lizard_getBlockStats(const char* source, int compressedSize, Lizard_blockStats_t* stats)
+{
+    static const int streamFlags[4] = { LIZARD_FLAG_OFFSET16, LIZARD_FLAG_OFFSET24, LIZARD_FLAG_FLAGS, LIZARD_FLAG_LITERALS };
+    static const Lizard_streamType_e streamTypes[4] = { Lizard_stream_offset16, Lizard_stream_offset24, Lizard_stream_flags, Lizard_stream_literals };
+    const BYTE* ip = (const BYTE*) source;
+    const BYTE* const iend = ip + compressedSize;
+    const BYTE* streamPtr, *streamEnd;
+    BYTE* huffBuffer;   /* Huffman-coded streams are decoded here */
+    int compressionLevel, lastOffsetCodes;
+
+    if (compressedSize < 1) return -1;
+    compressionLevel = *ip++;
+    if (compressionLevel < LIZARD_MIN_CLEVEL || compressionLevel > LIZARD_MAX_CLEVEL) return -1;
+    lastOffsetCodes = (Lizard_defaultParameters[compressionLevel - LIZARD_MIN_CLEVEL].decompressType == Lizard_coderwords_LIZv1);
+    huffBuffer = (BYTE*)malloc(LIZARD_HUF_BLOCK_SIZE);
+    if (!huffBuffer) return -1;
+    stats->compressionLevel = compressionLevel;
+    stats->nbBlocks++;
+
+    while (ip < iend)
+    {
+        int const header = *ip++;
+        const BYTE* start = ip;
+        int n;
+
+        stats->nbSubBlocks++;
+        if (header == LIZARD_FLAG_UNCOMPRESSED) {
+            uint32_t length;
+            if (ip > iend - 3) goto _output_error;
+            length = MEM_readLE24(ip);
+            if (length > (size_t)(iend - (ip + 3))) goto _output_error;
+            ip += 3 + length;
+            stats->nbUncompressedSubBlocks++;
+            stats->rawSize[Lizard_stream_uncompressed] += length;
+            stats->storedSize[Lizard_stream_uncompressed] += 3 + length;
+            continue;
+        }
+        if (header & LIZARD_FLAG_LEN) goto _output_error;
+
+        /* lengths are never Huffman-coded */
+        if (!Lizard_readStream(0, &ip, iend, huffBuffer, huffBuffer + LIZARD_HUF_BLOCK_SIZE, &streamPtr, &streamEnd) || (ip > iend)) goto _output_error;
+        stats->rawSize[Lizard_stream_lengths] += (size_t)(streamEnd - streamPtr);
+        stats->storedSize[Lizard_stream_lengths] += (size_t)(ip - start);
+
+        for (n=0; n<4; n++) {
+            int const huff = header & streamFlags[n];
+            start = ip;
+            if (!Lizard_readStream(huff, &ip, iend, huffBuffer, huffBuffer + LIZARD_HUF_BLOCK_SIZE, &streamPtr, &streamEnd) || (ip > iend)) goto _output_error;
+            stats->rawSize[streamTypes[n]] += (size_t)(streamEnd - streamPtr);
+            stats->storedSize[streamTypes[n]] += (size_t)(ip - start);
+            stats->huffmanCoded[streamTypes[n]] += (huff != 0);
+            if (streamTypes[n] == Lizard_stream_flags) {   /* one token per sequence */
+                stats->nbSequences += (size_t)(streamEnd - streamPtr);
+                for ( ; streamPtr < streamEnd; streamPtr++) {
+                    stats->tokens[*streamPtr]++;
+                    if (lastOffsetCodes && (*streamPtr >> ML_RUN_BITS)) stats->nbLastOffsets++;   /* [1_MMMM_LLL] */
+                }
+            }
+        }
+    }
+
+    free(huffBuffer);
+    return 0;
+
+_output_error:
+    free(huffBuffer);
+    return -1;
+}
@@ -145,6 +145,42 @@ Advanced decoding functions :
 LIZARDDLIB_API int Lizard_decompress_safe_usingDict (const char* source, char* dest, int compressedSize, int maxDecompressedSize, const char* dictStart, int dictSize);
 
 
+/*-**********************************************
+*  Block statistics
+************************************************/
+typedef enum {
+    Lizard_stream_literals = 0,
+    Lizard_stream_flags,          /* tokens, one per sequence */
+    Lizard_stream_offset16,
+    Lizard_stream_offset24,
+    Lizard_stream_lengths,
+    Lizard_stream_uncompressed,   /* blocks stored as is, when compression does not pay off */
+    Lizard_stream_count
+} Lizard_streamType_e;
+
+typedef struct {
+    unsigned long long rawSize[Lizard_stream_count];      /* before Huffman coding */
+    unsigned long long storedSize[Lizard_stream_count];   /* within compressed data, including stream headers */
+    unsigned long long huffmanCoded[Lizard_stream_count]; /* nb of Huffman-coded streams */
+    unsigned long long nbBlocks;                /* compressed buffers analyzed */
+    unsigned long long nbSubBlocks;             /* blocks of up to LIZARD_BLOCK_SIZE within them, 1 header byte each */
+    unsigned long long nbUncompressedSubBlocks;
+    unsigned long long nbSequences;
+    unsigned long long nbLastOffsets;           /* sequences repeating last offset (levels 20-29 and 40-49) */
+    unsigned long long tokens[256];             /* histogram of tokens, see lizard_Block_format.md */
+    int compressionLevel;                       /* of last block */
+} Lizard_blockStats_t;
+
+/*! Lizard_getBlockStats() :
+ *  Parses a block produced by Lizard_compress*() (also a block of a Lizard frame, when compressed),
+ *  and adds its statistics to `stats`, which must be zeroed before the first block : sizes of each stream,
+ *  sequences and their tokens. Only flags (and other Huffman-coded streams) are decoded : no output buffer is needed.
+ *  storedSize[] + nbSubBlocks + nbBlocks (level byte) == sum of compressedSize.
+ *  Return : 0, or -1 if the block is malformed (stats are then partially updated).
+ */
+LIZARDDLIB_API int Lizard_getBlockStats (const char* source, int compressedSize, Lizard_blockStats_t* stats);
+
+
 #if defined (__cplusplus)
 }
 #endif
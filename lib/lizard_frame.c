@@ -118,6 +118,15 @@ static void LizardF_writeLE64 (BYTE* dstPtr, U64 value64)
 #define LIZARDF_MAGICNUMBER            0x184D2206U
 #define LIZARDF_BLOCKUNCOMPRESSED_FLAG 0x80000000U
 #define LIZARDF_BLOCKSIZEID_DEFAULT LizardF_max128KB
+#define LIZARDF_WINDOWLOG_MIN       11
+#define LIZARDF_WINDOWLOG_MAX       24   /* LIZARD_DICT_SIZE */
+#define LIZARDF_WINDOWLOG_BASE      10   /* BD window field stores (windowLog - LIZARDF_WINDOWLOG_BASE) */
+
+#define LIZARDF_RSYNC_WINDOW        32   /* bytes covered by rolling hash */
+#define LIZARDF_RSYNC_PRIME         2654435761U
+#define LIZARDF_RSYNC_CHAR_OFFSET   10   /* so that runs of zeros don't hash to 0 */
+#define LIZARDF_RSYNC_AVGLOG        1    /* content-defined blocks are ~ maxBlockSize/2 on average ... */
+#define LIZARDF_RSYNC_MINLOG        3    /* ... and at least maxBlockSize/8 */
 
 static const size_t minFHSize = 7;
 static const size_t maxFHSize = 15;
@@ -134,13 +143,17 @@ typedef struct LizardF_cctx_s
     U32    cStage;
     size_t maxBlockSize;
     size_t maxBufferSize;
+    size_t windowSize;
     BYTE*  tmpBuff;
     BYTE*  tmpIn;
     size_t tmpInSize;
     U64    totalInSize;
+    U64    historyCopied;      /* bytes moved into tmpBuff to preserve history of linked blocks */
     XXH32_state_t xxh;
     Lizard_stream_t* lizardCtxPtr;
     U32    lizardCtxLevel;     /* 0: unallocated;  1: Lizard_stream_t;  */
+    BYTE*  zeroBlock;          /* a full block of zeros, compressed as independent block, with its header */
+    size_t zeroBlockSize;      /* 0 : not yet compressed with current parameters */
 } LizardF_cctx_t;
 
 typedef struct LizardF_dctx_s
@@ -151,6 +164,7 @@ typedef struct LizardF_dctx_s
     U64    frameRemainingSize;
     size_t maxBlockSize;
     size_t maxBufferSize;
+    size_t windowSize;
     const BYTE* srcExpect;
     BYTE*  tmpIn;
     size_t tmpInSize;
@@ -161,6 +175,7 @@ typedef struct LizardF_dctx_s
     BYTE*  tmpOut;
     size_t tmpOutSize;
     size_t tmpOutStart;
+    U64    bytesCopied;        /* bytes decoded through tmpOut, or moved into tmpOutBuffer to preserve history of linked blocks */
     XXH32_state_t xxh;
     BYTE   header[16];
 } LizardF_dctx_t;
@@ -217,6 +232,14 @@ static LizardF_blockSizeID_t LizardF_optimalBSID(const LizardF_blockSizeID_t req
 }
 
 
+/* windowID 0 means LIZARD_DICT_SIZE, which is what v1.0 decoders assume (they reject other values) */
+static unsigned LizardF_windowID(unsigned windowLog)
+{
+    if ((windowLog == 0) || (windowLog >= LIZARDF_WINDOWLOG_MAX)) return 0;
+    return windowLog - LIZARDF_WINDOWLOG_BASE;
+}
+
+
 static BYTE LizardF_headerChecksum (const void* header, size_t length)
 {
     U32 xxh = XXH32(header, length, 0);
@@ -347,6 +370,7 @@ LizardF_errorCode_t LizardF_freeCompressionContext(LizardF_compressionContext_t
     if (cctxPtr != NULL) {  /* null pointers can be safely provided to this function, like free() */
        Lizard_freeStream(cctxPtr->lizardCtxPtr);
        FREEMEM(cctxPtr->tmpBuff);
+       FREEMEM(cctxPtr->zeroBlock);
        FREEMEM(LizardF_compressionContext);
     }
 
@@ -368,26 +392,46 @@ size_t LizardF_compressBegin(LizardF_compressionContext_t compressionContext, vo
     BYTE* dstPtr = dstStart;
     BYTE* headerStart;
     size_t requiredBuffSize;
+    int windowRequested;
 
     if (dstMaxSize < maxFHSize) return (size_t)-LizardF_ERROR_dstMaxSize_tooSmall;
     if (cctxPtr->cStage != 0) return (size_t)-LizardF_ERROR_GENERIC;
     memset(&prefNull, 0, sizeof(prefNull));
     if (preferencesPtr == NULL) preferencesPtr = &prefNull;
     cctxPtr->prefs = *preferencesPtr;
+    if (cctxPtr->prefs.rsyncable) cctxPtr->prefs.frameInfo.blockMode = LizardF_blockIndependent;   /* blocks must not depend on previous content */
 
     /* ctx Management */
     if (cctxPtr->lizardCtxLevel == 0) {
         cctxPtr->lizardCtxPtr = Lizard_createStream(cctxPtr->prefs.compressionLevel);
         cctxPtr->lizardCtxLevel = 1;
     }
+    cctxPtr->lizardCtxPtr = Lizard_resetStream((Lizard_stream_t*)(cctxPtr->lizardCtxPtr), cctxPtr->prefs.compressionLevel);
+    if (!cctxPtr->lizardCtxPtr) return (size_t)-LizardF_ERROR_allocation_failed;
+
+    /* Window Management : history is bounded by windowLog of compression level, or by a requested one.
+     * A requested window is the frame window : matches of any level, set later by LizardF_setCompressionLevel(), stay within it.
+     * Window size is written in frame header only when requested : v1.0 decoders reject frames with this field set */
+    {   unsigned windowLog = cctxPtr->lizardCtxPtr->params.windowLog;
+        windowRequested = (cctxPtr->prefs.frameInfo.windowLog != 0);
+        if (windowRequested) {
+            if ((cctxPtr->prefs.frameInfo.windowLog < LIZARDF_WINDOWLOG_MIN) || (cctxPtr->prefs.frameInfo.windowLog > LIZARDF_WINDOWLOG_MAX))
+                return (size_t)-LizardF_ERROR_windowSize_invalid;
+            windowLog = cctxPtr->prefs.frameInfo.windowLog;
+            if (cctxPtr->lizardCtxPtr->params.windowLog > windowLog) cctxPtr->lizardCtxPtr->params.windowLog = windowLog;
+        }
+        if (windowLog > LIZARDF_WINDOWLOG_MAX) windowLog = LIZARDF_WINDOWLOG_MAX;
+        cctxPtr->windowSize = (size_t)1 << windowLog;
+        cctxPtr->prefs.frameInfo.windowLog = (cctxPtr->prefs.frameInfo.blockMode == LizardF_blockLinked) ? windowLog : 0;
+    }
 
     /* Buffer Management */
     if (cctxPtr->prefs.frameInfo.blockSizeID == 0) cctxPtr->prefs.frameInfo.blockSizeID = LIZARDF_BLOCKSIZEID_DEFAULT;
     cctxPtr->maxBlockSize = LizardF_getBlockSize(cctxPtr->prefs.frameInfo.blockSizeID);
-    requiredBuffSize = cctxPtr->maxBlockSize + ((cctxPtr->prefs.frameInfo.blockMode == LizardF_blockLinked) * 2 * LIZARD_DICT_SIZE);
+    requiredBuffSize = cctxPtr->maxBlockSize + ((cctxPtr->prefs.frameInfo.blockMode == LizardF_blockLinked) * 2 * cctxPtr->windowSize);
 
-    if (preferencesPtr->autoFlush)
-        requiredBuffSize = (cctxPtr->prefs.frameInfo.blockMode == LizardF_blockLinked) * LIZARD_DICT_SIZE;   /* just needs dict */
+    if (cctxPtr->prefs.autoFlush)
+        requiredBuffSize = (cctxPtr->prefs.frameInfo.blockMode == LizardF_blockLinked) * cctxPtr->windowSize;   /* just needs dict */
 
     if (cctxPtr->maxBufferSize < requiredBuffSize) {
         cctxPtr->maxBufferSize = requiredBuffSize;
@@ -397,9 +441,9 @@ size_t LizardF_compressBegin(LizardF_compressionContext_t compressionContext, vo
     }
     cctxPtr->tmpIn = cctxPtr->tmpBuff;
     cctxPtr->tmpInSize = 0;
+    cctxPtr->zeroBlockSize = 0;   /* level or block size may have changed */
+    cctxPtr->historyCopied = 0;
     XXH32_reset(&(cctxPtr->xxh), 0);
-    cctxPtr->lizardCtxPtr = Lizard_resetStream((Lizard_stream_t*)(cctxPtr->lizardCtxPtr), cctxPtr->prefs.compressionLevel);
-    if (!cctxPtr->lizardCtxPtr) return (size_t)-LizardF_ERROR_allocation_failed;
 
     /* Magic Number */
     LizardF_writeLE32(dstPtr, LIZARDF_MAGICNUMBER);
@@ -412,7 +456,8 @@ size_t LizardF_compressBegin(LizardF_compressionContext_t compressionContext, vo
         + ((cctxPtr->prefs.frameInfo.contentChecksumFlag & _1BIT ) << 2)   /* Frame checksum */
         + ((cctxPtr->prefs.frameInfo.contentSize > 0) << 3));   /* Frame content size */
     /* BD Byte */
-    *dstPtr++ = (BYTE)((cctxPtr->prefs.frameInfo.blockSizeID & _3BITS) << 4);
+    *dstPtr++ = (BYTE)(((cctxPtr->prefs.frameInfo.blockSizeID & _3BITS) << 4)
+        + (windowRequested ? LizardF_windowID(cctxPtr->prefs.frameInfo.windowLog) & _4BITS : 0));   /* Window size */
     /* Optional Frame content size field */
     if (cctxPtr->prefs.frameInfo.contentSize) {
         LizardF_writeLE64(dstPtr, cctxPtr->prefs.frameInfo.contentSize);
@@ -429,6 +474,28 @@ size_t LizardF_compressBegin(LizardF_compressionContext_t compressionContext, vo
 }
 
 
+/*! LizardF_compressBegin_usingDict() :
+* same as LizardF_compressBegin(), but with linked blocks, first block can also reference
+* the last window of `dict` (data preceding this part of the frame, see lizard_frame_static.h)
+*/
+size_t LizardF_compressBegin_usingDict(LizardF_compressionContext_t compressionContext, void* dstBuffer, size_t dstMaxSize,
+                                       const void* dict, size_t dictSize, const LizardF_preferences_t* preferencesPtr)
+{
+    LizardF_cctx_t* const cctxPtr = (LizardF_cctx_t*)compressionContext;
+    size_t const headerSize = LizardF_compressBegin(compressionContext, dstBuffer, dstMaxSize, preferencesPtr);
+    if (LizardF_isError(headerSize)) return headerSize;
+
+    if ((cctxPtr->prefs.frameInfo.blockMode == LizardF_blockLinked) && (dictSize > 0)) {
+        if (dictSize > cctxPtr->windowSize) {
+            dict = (const BYTE*)dict + (dictSize - cctxPtr->windowSize);
+            dictSize = cctxPtr->windowSize;
+        }
+        Lizard_loadDict(cctxPtr->lizardCtxPtr, (const char*)dict, (int)dictSize);
+    }
+    return headerSize;
+}
+
+
 /* LizardF_compressBound() : gives the size of Dst buffer given a srcSize to handle worst case situations.
 *                        The LizardF_frameInfo_t structure is optional :
 *                        you can provide NULL as argument, preferences will then be set to cover worst case situations.
@@ -446,6 +513,15 @@ size_t LizardF_compressBound(size_t srcSize, const LizardF_preferences_t* prefer
         size_t blockInfo = 4;   /* default, without block CRC option */
         size_t frameEnd = 4 + (prefsPtr->frameInfo.contentChecksumFlag*4);
 
+        if (prefsPtr->rsyncable) {
+            /* content-defined cuts : blocks are at least blockSize >> LIZARDF_RSYNC_MINLOG bytes, except the last one,
+             * and carry input buffered by previous calls (< blockSize) and `srcSize` bytes */
+            size_t const minBlockSize = blockSize >> LIZARDF_RSYNC_MINLOG;
+            size_t const maxInput = srcSize + blockSize;
+            size_t const nbCutBlocks = (maxInput / minBlockSize) + 1;
+            return (blockInfo * nbCutBlocks) + maxInput + frameEnd;
+        }
+
         return (blockInfo * nbBlocks) + (blockSize * (nbBlocks-1)) + lastBlockSize + frameEnd;;
     }
 }
@@ -484,9 +560,56 @@ static compressFunc_t LizardF_selectCompression(LizardF_blockMode_t blockMode)
 
 static int LizardF_localSaveDict(LizardF_cctx_t* cctxPtr)
 {
-    return Lizard_saveDict ((Lizard_stream_t*)(cctxPtr->lizardCtxPtr), (char*)(cctxPtr->tmpBuff), LIZARD_DICT_SIZE);
+    int const dictSize = Lizard_saveDict ((Lizard_stream_t*)(cctxPtr->lizardCtxPtr), (char*)(cctxPtr->tmpBuff), (int)cctxPtr->windowSize);
+    cctxPtr->historyCopied += (U64)dictSize;
+    return dictSize;
 }
 
+/* tmpBuff is used as a ring buffer : when it can hold a window plus 2 blocks,
+ * restarting at its beginning keeps a full window of history in place (referenced as extDict), no memmove needed */
+static void LizardF_wrapTmpIn(LizardF_cctx_t* cctxPtr)
+{
+    if (cctxPtr->maxBufferSize >= cctxPtr->windowSize + 2 * cctxPtr->maxBlockSize) {
+        cctxPtr->tmpIn = cctxPtr->tmpBuff;
+    } else {
+        int realDictSize = LizardF_localSaveDict(cctxPtr);
+        cctxPtr->tmpIn = cctxPtr->tmpBuff + realDictSize;
+    }
+}
+
+/*! LizardF_setCompressionLevel() :
+* changes compression level for next blocks of current frame (see lizard_frame_static.h)
+*/
+size_t LizardF_setCompressionLevel(LizardF_compressionContext_t compressionContext, int compressionLevel)
+{
+    LizardF_cctx_t* const cctxPtr = (LizardF_cctx_t*)compressionContext;
+    int dictSize = 0;
+
+    if (cctxPtr->cStage != 1) return (size_t)-LizardF_ERROR_GENERIC;
+    if (cctxPtr->tmpInSize > 0) return (size_t)-LizardF_ERROR_GENERIC;   /* not at a block boundary */
+    if ((compressionLevel < LIZARD_MIN_CLEVEL) || (compressionLevel > LIZARD_MAX_CLEVEL)) return (size_t)-LizardF_ERROR_compressionLevel_invalid;
+    if (compressionLevel == cctxPtr->prefs.compressionLevel) return 0;
+
+    /* history must survive reset : it is moved into tmpBuff, sized for a window */
+    if ((cctxPtr->prefs.frameInfo.blockMode == LizardF_blockLinked) && cctxPtr->totalInSize)
+        dictSize = LizardF_localSaveDict(cctxPtr);
+
+    cctxPtr->lizardCtxPtr = Lizard_resetStream(cctxPtr->lizardCtxPtr, compressionLevel);
+    if (!cctxPtr->lizardCtxPtr) { cctxPtr->lizardCtxLevel = 0; return (size_t)-LizardF_ERROR_allocation_failed; }
+    cctxPtr->prefs.compressionLevel = compressionLevel;
+    cctxPtr->zeroBlockSize = 0;
+
+    if (cctxPtr->prefs.frameInfo.blockMode == LizardF_blockLinked) {
+        /* window size is already written in frame header */
+        if (cctxPtr->lizardCtxPtr->params.windowLog > cctxPtr->prefs.frameInfo.windowLog)
+            cctxPtr->lizardCtxPtr->params.windowLog = cctxPtr->prefs.frameInfo.windowLog;
+        Lizard_loadDict(cctxPtr->lizardCtxPtr, (const char*)cctxPtr->tmpBuff, dictSize);
+        cctxPtr->tmpIn = cctxPtr->tmpBuff + dictSize;
+    }
+    return 0;
+}
+
+
 typedef enum { notDone, fromTmpBuffer, fromSrcBuffer } LizardF_lastBlockStatus;
 
 /*! LizardF_compressUpdate() :
@@ -498,10 +621,51 @@ typedef enum { notDone, fromTmpBuffer, fromSrcBuffer } LizardF_lastBlockStatus;
 * The result of the function is the number of bytes written into dstBuffer : it can be zero, meaning input data was just buffered.
 * The function outputs an error code if it fails (can be tested using LizardF_isError())
 */
-size_t LizardF_compressUpdate(LizardF_compressionContext_t compressionContext, void* dstBuffer, size_t dstMaxSize, const void* srcBuffer, size_t srcSize, const LizardF_compressOptions_t* compressOptionsPtr)
+/* byte at position `pos` of current block, which starts with `blockPos` bytes within tmpIn, then continues with `src` */
+#define LIZARDF_RSYNC_BYTE(pos) (((pos) < blockPos) ? blockStart[pos] : src[(pos) - blockPos])
+
+/*! LizardF_rsyncBlockEnd() :
+ *  Looks for a content-defined end of current block, where hash of last LIZARDF_RSYNC_WINDOW bytes hits.
+ *  Current block starts within tmpIn (tmpInSize bytes, rsyncable blocks are independent) and continues with `src`.
+ *  Hash only depends on block content, so no state is kept between calls.
+ * @return : nb of bytes of `src` up to end of current block (content-defined, or block full), with *boundary = 1,
+ *           or `srcSize` with *boundary = 0 if current block doesn't end within `src`. */
+static size_t LizardF_rsyncBlockEnd(const LizardF_cctx_t* cctxPtr, const BYTE* src, size_t srcSize, int* boundary)
+{
+    const BYTE* const blockStart = cctxPtr->tmpIn;
+    size_t const blockPos = cctxPtr->tmpInSize;
+    size_t const minBlockSize = cctxPtr->maxBlockSize >> LIZARDF_RSYNC_MINLOG;
+    unsigned const hitShift = 32 - (Lizard_highbit32((U32)cctxPtr->maxBlockSize) - LIZARDF_RSYNC_AVGLOG);
+    size_t const blockEnd = MIN(cctxPtr->maxBlockSize, blockPos + srcSize);
+    size_t pos = ((blockPos < minBlockSize) ? minBlockSize : blockPos + 1) - LIZARDF_RSYNC_WINDOW;   /* window of first possible end */
+    size_t const windowEnd = pos + LIZARDF_RSYNC_WINDOW;
+    U32 primePower = 1;
+    U32 hash = 0;
+    int n;
+
+    *boundary = (blockEnd == cctxPtr->maxBlockSize);   /* block full */
+    if (windowEnd > blockEnd) return blockEnd - blockPos;
+
+    for (n = 0; n < LIZARDF_RSYNC_WINDOW; n++) primePower *= LIZARDF_RSYNC_PRIME;
+    for ( ; pos < windowEnd; pos++)
+        hash = (hash * LIZARDF_RSYNC_PRIME) + LIZARDF_RSYNC_BYTE(pos) + LIZARDF_RSYNC_CHAR_OFFSET;
+
+    while (1) {   /* block could end at pos */
+        if ((hash >> hitShift) == 0) { *boundary = 1; return pos - blockPos; }
+        if (pos == blockEnd) break;
+        hash = (hash * LIZARDF_RSYNC_PRIME) + LIZARDF_RSYNC_BYTE(pos) + LIZARDF_RSYNC_CHAR_OFFSET
+               - ((LIZARDF_RSYNC_BYTE(pos - LIZARDF_RSYNC_WINDOW) + LIZARDF_RSYNC_CHAR_OFFSET) * primePower);
+        pos++;
+    }
+    return blockEnd - blockPos;
+}
+
+
+/*! LizardF_compressUpdate_internal() :
+ *  `endBlock` : also compress input remaining after full blocks, as with autoFlush */
+static size_t LizardF_compressUpdate_internal(LizardF_cctx_t* cctxPtr, void* dstBuffer, const void* srcBuffer, size_t srcSize,
+                                              const LizardF_compressOptions_t* compressOptionsPtr, int endBlock)
 {
-    LizardF_compressOptions_t cOptionsNull;
-    LizardF_cctx_t* cctxPtr = (LizardF_cctx_t*)compressionContext;
     size_t blockSize = cctxPtr->maxBlockSize;
     const BYTE* srcPtr = (const BYTE*)srcBuffer;
     const BYTE* const srcEnd = srcPtr + srcSize;
@@ -510,12 +674,6 @@ size_t LizardF_compressUpdate(LizardF_compressionContext_t compressionContext, v
     LizardF_lastBlockStatus lastBlockCompressed = notDone;
     compressFunc_t compress;
 
-
-    if (cctxPtr->cStage != 1) return (size_t)-LizardF_ERROR_GENERIC;
-    if (dstMaxSize < LizardF_compressBound(srcSize, &(cctxPtr->prefs))) return (size_t)-LizardF_ERROR_dstMaxSize_tooSmall;
-    memset(&cOptionsNull, 0, sizeof(cOptionsNull));
-    if (compressOptionsPtr == NULL) compressOptionsPtr = &cOptionsNull;
-
     /* select compression function */
     compress = LizardF_selectCompression(cctxPtr->prefs.frameInfo.blockMode);
 
@@ -548,7 +706,7 @@ size_t LizardF_compressUpdate(LizardF_compressionContext_t compressionContext, v
         srcPtr += blockSize;
     }
 
-    if ((cctxPtr->prefs.autoFlush) && (srcPtr < srcEnd)) {
+    if ((cctxPtr->prefs.autoFlush || endBlock) && (srcPtr < srcEnd)) {
         /* compress remaining input < blockSize */
         lastBlockCompressed = fromSrcBuffer;
         dstPtr += LizardF_compressBlock(dstPtr, srcPtr, srcEnd - srcPtr, compress, cctxPtr->lizardCtxPtr, cctxPtr->prefs.compressionLevel);
@@ -569,10 +727,7 @@ size_t LizardF_compressUpdate(LizardF_compressionContext_t compressionContext, v
     /* keep tmpIn within limits */
     if ((cctxPtr->tmpIn + blockSize) > (cctxPtr->tmpBuff + cctxPtr->maxBufferSize)   /* necessarily LizardF_blockLinked && lastBlockCompressed==fromTmpBuffer */
         && !(cctxPtr->prefs.autoFlush))
-    {
-        int realDictSize = LizardF_localSaveDict(cctxPtr);
-        cctxPtr->tmpIn = cctxPtr->tmpBuff + realDictSize;
-    }
+        LizardF_wrapTmpIn(cctxPtr);
 
     /* some input data left, necessarily < blockSize */
     if (srcPtr < srcEnd) {
@@ -589,6 +744,101 @@ size_t LizardF_compressUpdate(LizardF_compressionContext_t compressionContext, v
     return dstPtr - dstStart;
 }
 
+size_t LizardF_compressUpdate(LizardF_compressionContext_t compressionContext, void* dstBuffer, size_t dstMaxSize, const void* srcBuffer, size_t srcSize, const LizardF_compressOptions_t* compressOptionsPtr)
+{
+    LizardF_compressOptions_t cOptionsNull;
+    LizardF_cctx_t* cctxPtr = (LizardF_cctx_t*)compressionContext;
+    const BYTE* srcPtr = (const BYTE*)srcBuffer;
+    BYTE* const dstStart = (BYTE*)dstBuffer;
+    BYTE* dstPtr = dstStart;
+
+    if (cctxPtr->cStage != 1) return (size_t)-LizardF_ERROR_GENERIC;
+    if (dstMaxSize < LizardF_compressBound(srcSize, &(cctxPtr->prefs))) return (size_t)-LizardF_ERROR_dstMaxSize_tooSmall;
+    memset(&cOptionsNull, 0, sizeof(cOptionsNull));
+    if (compressOptionsPtr == NULL) compressOptionsPtr = &cOptionsNull;
+
+    if (!cctxPtr->prefs.rsyncable)
+        return LizardF_compressUpdate_internal(cctxPtr, dstBuffer, srcBuffer, srcSize, compressOptionsPtr, 0);
+
+    /* rsyncable : input is cut at block ends, and each piece ending a block is compressed at once */
+    do {
+        int boundary;
+        size_t const pieceSize = LizardF_rsyncBlockEnd(cctxPtr, srcPtr, srcSize, &boundary);
+        size_t const cSize = LizardF_compressUpdate_internal(cctxPtr, dstPtr, srcPtr, pieceSize, compressOptionsPtr, boundary);
+        if (LizardF_isError(cSize)) return cSize;
+        dstPtr += cSize;
+        if (boundary) {   /* block started within tmpIn, not yet full */
+            size_t const flushed = LizardF_flush(cctxPtr, dstPtr, dstMaxSize - (dstPtr - dstStart), compressOptionsPtr);
+            if (LizardF_isError(flushed)) return flushed;
+            dstPtr += flushed;
+        }
+        srcPtr += pieceSize;
+        srcSize -= pieceSize;
+    } while (srcSize);
+
+    return dstPtr - dstStart;
+}
+
+
+/*! LizardF_compressZeros() :
+* same as LizardF_compressUpdate() with `srcSize` zero bytes (see lizard_frame_static.h)
+*/
+size_t LizardF_compressZeros(LizardF_compressionContext_t compressionContext, void* dstBuffer, size_t dstMaxSize, size_t srcSize)
+{
+    static const BYTE zeros[64 KB] = { 0 };
+    LizardF_cctx_t* cctxPtr = (LizardF_cctx_t*)compressionContext;
+    BYTE* const dstStart = (BYTE*)dstBuffer;
+    BYTE* dstPtr = dstStart;
+
+    if (cctxPtr->cStage != 1) return (size_t)-LizardF_ERROR_GENERIC;
+    if (dstMaxSize < LizardF_compressBound(srcSize, &(cctxPtr->prefs))) return (size_t)-LizardF_ERROR_dstMaxSize_tooSmall;
+
+    /* full independent blocks of zeros are all compressed the same way : done once */
+    if ((cctxPtr->prefs.frameInfo.blockMode == LizardF_blockIndependent) && (cctxPtr->tmpInSize == 0) && !cctxPtr->prefs.rsyncable) {
+        while (srcSize >= cctxPtr->maxBlockSize) {
+            size_t hashed;
+            if (cctxPtr->zeroBlockSize == 0) {
+                BYTE* const zeroSrc = (BYTE*)ALLOCATOR(1, cctxPtr->maxBlockSize);
+                FREEMEM(cctxPtr->zeroBlock);
+                cctxPtr->zeroBlock = (BYTE*)ALLOCATOR(1, cctxPtr->maxBlockSize + 4);
+                if ((zeroSrc == NULL) || (cctxPtr->zeroBlock == NULL)) { FREEMEM(zeroSrc); return (size_t)-LizardF_ERROR_allocation_failed; }
+                cctxPtr->zeroBlockSize = LizardF_compressBlock(cctxPtr->zeroBlock, zeroSrc, cctxPtr->maxBlockSize,
+                                            LizardF_selectCompression(LizardF_blockIndependent), cctxPtr->lizardCtxPtr, cctxPtr->prefs.compressionLevel);
+                FREEMEM(zeroSrc);
+            }
+            memcpy(dstPtr, cctxPtr->zeroBlock, cctxPtr->zeroBlockSize);
+            dstPtr += cctxPtr->zeroBlockSize;
+            if (cctxPtr->prefs.frameInfo.contentChecksumFlag == LizardF_contentChecksumEnabled)
+                for (hashed = 0; hashed < cctxPtr->maxBlockSize; hashed += sizeof(zeros))
+                    XXH32_update(&(cctxPtr->xxh), zeros, sizeof(zeros));   /* block sizes are multiples of 64 KB */
+            cctxPtr->totalInSize += cctxPtr->maxBlockSize;
+            srcSize -= cctxPtr->maxBlockSize;
+    }   }
+
+    /* anything else is regular input */
+    if (srcSize) {
+        BYTE* const zeroSrc = (BYTE*)ALLOCATOR(1, srcSize);
+        size_t result;
+        if (zeroSrc == NULL) return (size_t)-LizardF_ERROR_allocation_failed;
+        result = LizardF_compressUpdate(compressionContext, dstPtr, dstMaxSize - (dstPtr - dstStart), zeroSrc, srcSize, NULL);
+        FREEMEM(zeroSrc);
+        if (LizardF_isError(result)) return result;
+        dstPtr += result;
+    }
+
+    return dstPtr - dstStart;
+}
+
+
+/*! LizardF_getHistoryCopied() :
+* bytes copied to preserve history since frame start (see lizard_frame_static.h)
+*/
+unsigned long long LizardF_getHistoryCopied(LizardF_compressionContext_t compressionContext)
+{
+    const LizardF_cctx_t* const cctxPtr = (const LizardF_cctx_t*)compressionContext;
+    return cctxPtr->historyCopied;
+}
+
 
 /*! LizardF_flush() :
 * Should you need to create compressed data immediately, without waiting for a block to be filled,
@@ -620,10 +870,8 @@ size_t LizardF_flush(LizardF_compressionContext_t compressionContext, void* dstB
     cctxPtr->tmpInSize = 0;
 
     /* keep tmpIn within limits */
-    if ((cctxPtr->tmpIn + cctxPtr->maxBlockSize) > (cctxPtr->tmpBuff + cctxPtr->maxBufferSize)) {  /* necessarily LizardF_blockLinked */
-        int realDictSize = LizardF_localSaveDict(cctxPtr);
-        cctxPtr->tmpIn = cctxPtr->tmpBuff + realDictSize;
-    }
+    if ((cctxPtr->tmpIn + cctxPtr->maxBlockSize) > (cctxPtr->tmpBuff + cctxPtr->maxBufferSize))  /* necessarily LizardF_blockLinked */
+        LizardF_wrapTmpIn(cctxPtr);
 
     return dstPtr - dstStart;
 }
@@ -745,6 +993,61 @@ static size_t LizardF_headerSize(const void* src, size_t srcSize)
 }
 
 
+/*! LizardF_getHeaderInfo() :
+*   decodes and checks a whole frame header, without decompression context (see lizard_frame_static.h)
+*/
+size_t LizardF_getHeaderInfo(LizardF_frameInfo_t* frameInfoPtr, const void* srcBuffer, size_t srcSize)
+{
+    BYTE FLG, BD, HC;
+    unsigned version, blockMode, blockChecksumFlag, contentSizeFlag, contentChecksumFlag, blockSizeID, windowID;
+    size_t frameHeaderSize;
+    const BYTE* const srcPtr = (const BYTE*)srcBuffer;
+
+    if (srcSize < minFHSize) return (size_t)-LizardF_ERROR_frameHeader_incomplete;   /* minimal frame header size */
+    if (LizardF_readLE32(srcPtr) != LIZARDF_MAGICNUMBER) return (size_t)-LizardF_ERROR_frameType_unknown;
+
+    /* Flags */
+    FLG = srcPtr[4];
+    version = (FLG>>6) & _2BITS;
+    blockMode = (FLG>>5) & _1BIT;
+    blockChecksumFlag = (FLG>>4) & _1BIT;
+    contentSizeFlag = (FLG>>3) & _1BIT;
+    contentChecksumFlag = (FLG>>2) & _1BIT;
+
+    /* Frame Header Size */
+    frameHeaderSize = contentSizeFlag ? maxFHSize : minFHSize;
+    if (srcSize < frameHeaderSize) return (size_t)-LizardF_ERROR_frameHeader_incomplete;
+
+    BD = srcPtr[5];
+    blockSizeID = (BD>>4) & _3BITS;
+    windowID = BD & _4BITS;
+
+    /* validate */
+    if (version != 1) return (size_t)-LizardF_ERROR_headerVersion_wrong;        /* Version Number, only supported value */
+    if (blockChecksumFlag != 0) return (size_t)-LizardF_ERROR_blockChecksum_unsupported; /* Not supported for the time being */
+    if (((FLG>>0)&_2BITS) != 0) return (size_t)-LizardF_ERROR_reservedFlag_set; /* Reserved bits */
+    if (((BD>>7)&_1BIT) != 0) return (size_t)-LizardF_ERROR_reservedFlag_set;   /* Reserved bit */
+    if (blockSizeID < 1) return (size_t)-LizardF_ERROR_maxBlockSize_invalid;    /* 1-7 only supported values for the time being */
+    if (windowID + LIZARDF_WINDOWLOG_BASE > LIZARDF_WINDOWLOG_MAX) return (size_t)-LizardF_ERROR_windowSize_invalid;   /* 0 (default) and 1-14 only supported values */
+
+    /* check */
+    HC = LizardF_headerChecksum(srcPtr+4, frameHeaderSize-5);
+    if (HC != srcPtr[frameHeaderSize-1]) return (size_t)-LizardF_ERROR_headerChecksum_invalid;   /* Bad header checksum error */
+
+    /* save */
+    memset(frameInfoPtr, 0, sizeof(*frameInfoPtr));
+    frameInfoPtr->frameType = LizardF_frame;
+    frameInfoPtr->blockMode = (LizardF_blockMode_t)blockMode;
+    frameInfoPtr->contentChecksumFlag = (LizardF_contentChecksum_t)contentChecksumFlag;
+    frameInfoPtr->blockSizeID = (LizardF_blockSizeID_t)blockSizeID;
+    if (blockMode == LizardF_blockLinked)
+        frameInfoPtr->windowLog = windowID ? windowID + LIZARDF_WINDOWLOG_BASE : LIZARDF_WINDOWLOG_MAX;
+    if (contentSizeFlag)
+        frameInfoPtr->contentSize = LizardF_readLE64(srcPtr+6);
+    return frameHeaderSize;
+}
+
+
 /*! LizardF_decodeHeader() :
    input   : `srcVoidPtr` points at the **beginning of the frame**
    output  : set internal values of dctx, such as
@@ -755,8 +1058,6 @@ static size_t LizardF_headerSize(const void* src, size_t srcSize)
 */
 static size_t LizardF_decodeHeader(LizardF_dctx_t* dctxPtr, const void* srcVoidPtr, size_t srcSize)
 {
-    BYTE FLG, BD, HC;
-    unsigned version, blockMode, blockChecksumFlag, contentSizeFlag, contentChecksumFlag, blockSizeID;
     size_t bufferNeeded, currentBlockSize;
     size_t frameHeaderSize;
     const BYTE* srcPtr = (const BYTE*)srcVoidPtr;
@@ -783,16 +1084,8 @@ static size_t LizardF_decodeHeader(LizardF_dctx_t* dctxPtr, const void* srcVoidP
     if (LizardF_readLE32(srcPtr) != LIZARDF_MAGICNUMBER) return (size_t)-LizardF_ERROR_frameType_unknown;
     dctxPtr->frameInfo.frameType = LizardF_frame;
 
-    /* Flags */
-    FLG = srcPtr[4];
-    version = (FLG>>6) & _2BITS;
-    blockMode = (FLG>>5) & _1BIT;
-    blockChecksumFlag = (FLG>>4) & _1BIT;
-    contentSizeFlag = (FLG>>3) & _1BIT;
-    contentChecksumFlag = (FLG>>2) & _1BIT;
-
     /* Frame Header Size */
-    frameHeaderSize = contentSizeFlag ? maxFHSize : minFHSize;
+    frameHeaderSize = ((srcPtr[4]>>3) & _1BIT) ? maxFHSize : minFHSize;   /* Content Size flag */
 
     if (srcSize < frameHeaderSize) {
         /* not enough input to fully decode frame header */
@@ -804,35 +1097,20 @@ static size_t LizardF_decodeHeader(LizardF_dctx_t* dctxPtr, const void* srcVoidP
         return srcSize;
     }
 
-    BD = srcPtr[5];
-    blockSizeID = (BD>>4) & _3BITS;
-
-    /* validate */
-    if (version != 1) return (size_t)-LizardF_ERROR_headerVersion_wrong;        /* Version Number, only supported value */
-    if (blockChecksumFlag != 0) return (size_t)-LizardF_ERROR_blockChecksum_unsupported; /* Not supported for the time being */
-    if (((FLG>>0)&_2BITS) != 0) return (size_t)-LizardF_ERROR_reservedFlag_set; /* Reserved bits */
-    if (((BD>>7)&_1BIT) != 0) return (size_t)-LizardF_ERROR_reservedFlag_set;   /* Reserved bit */
-    if (blockSizeID < 1) return (size_t)-LizardF_ERROR_maxBlockSize_invalid;    /* 1-7 only supported values for the time being */
-    if (((BD>>0)&_4BITS) != 0) return (size_t)-LizardF_ERROR_reservedFlag_set;  /* Reserved bits */
-
-    /* check */
-    HC = LizardF_headerChecksum(srcPtr+4, frameHeaderSize-5);
-    if (HC != srcPtr[frameHeaderSize-1]) return (size_t)-LizardF_ERROR_headerChecksum_invalid;   /* Bad header checksum error */
-
-    /* save */
-    dctxPtr->frameInfo.blockMode = (LizardF_blockMode_t)blockMode;
-    dctxPtr->frameInfo.contentChecksumFlag = (LizardF_contentChecksum_t)contentChecksumFlag;
-    dctxPtr->frameInfo.blockSizeID = (LizardF_blockSizeID_t)blockSizeID;
+    /* validate and save */
+    {   size_t const hSize = LizardF_getHeaderInfo(&(dctxPtr->frameInfo), srcPtr, frameHeaderSize);
+        if (LizardF_isError(hSize)) return hSize; }
     currentBlockSize = dctxPtr->maxBlockSize;
-    dctxPtr->maxBlockSize = LizardF_getBlockSize(blockSizeID);
-    if (contentSizeFlag)
-        dctxPtr->frameRemainingSize = dctxPtr->frameInfo.contentSize = LizardF_readLE64(srcPtr+6);
+    dctxPtr->maxBlockSize = LizardF_getBlockSize(dctxPtr->frameInfo.blockSizeID);
+    dctxPtr->windowSize = dctxPtr->frameInfo.windowLog ? ((size_t)1 << dctxPtr->frameInfo.windowLog) : LIZARD_DICT_SIZE;
+    dctxPtr->frameRemainingSize = dctxPtr->frameInfo.contentSize;
+    dctxPtr->bytesCopied = 0;
 
     /* init */
-    if (contentChecksumFlag) XXH32_reset(&(dctxPtr->xxh), 0);
+    if (dctxPtr->frameInfo.contentChecksumFlag) XXH32_reset(&(dctxPtr->xxh), 0);
 
     /* alloc */
-    bufferNeeded = dctxPtr->maxBlockSize + ((dctxPtr->frameInfo.blockMode==LizardF_blockLinked) * 2 * LIZARD_DICT_SIZE);
+    bufferNeeded = dctxPtr->maxBlockSize + ((dctxPtr->frameInfo.blockMode==LizardF_blockLinked) * 2 * dctxPtr->windowSize);
     if (bufferNeeded > dctxPtr->maxBufferSize || dctxPtr->maxBlockSize > currentBlockSize) {   /* tmp buffers too small */
         FREEMEM(dctxPtr->tmpIn);
         FREEMEM(dctxPtr->tmpOutBuffer);
@@ -892,6 +1170,15 @@ LizardF_errorCode_t LizardF_getFrameInfo(LizardF_decompressionContext_t dCtx, Li
     }
 }
 
+/*! LizardF_getDecodedCopied() :
+* bytes copied through internal buffers since frame start (see lizard_frame_static.h)
+*/
+unsigned long long LizardF_getDecodedCopied(LizardF_decompressionContext_t decompressionContext)
+{
+    const LizardF_dctx_t* const dctxPtr = (const LizardF_dctx_t*)decompressionContext;
+    return dctxPtr->bytesCopied;
+}
+
 
 /* trivial redirector, for common prototype */
 static int LizardF_decompress_safe (const char* source, char* dest, int compressedSize, int maxDecompressedSize, const char* dictStart, int dictSize)
@@ -911,7 +1198,7 @@ static void LizardF_updateDict(LizardF_dctx_t* dctxPtr, const BYTE* dstPtr, size
         return;
     }
 
-    if (dstPtr - dstPtr0 + dstSize >= LIZARD_DICT_SIZE) {  /* dstBuffer large enough to become dictionary */
+    if (dstPtr - dstPtr0 + dstSize >= dctxPtr->windowSize) {  /* dstBuffer large enough to become dictionary */
         dctxPtr->dict = (const BYTE*)dstPtr0;
         dctxPtr->dictSize = dstPtr - dstPtr0 + dstSize;
         return;
@@ -925,12 +1212,13 @@ static void LizardF_updateDict(LizardF_dctx_t* dctxPtr, const BYTE* dstPtr, size
 
     if (withinTmp) { /* copy relevant dict portion in front of tmpOut within tmpOutBuffer */
         size_t preserveSize = dctxPtr->tmpOut - dctxPtr->tmpOutBuffer;
-        size_t copySize = LIZARD_DICT_SIZE - dctxPtr->tmpOutSize;
+        size_t copySize = dctxPtr->windowSize - dctxPtr->tmpOutSize;
         const BYTE* oldDictEnd = dctxPtr->dict + dctxPtr->dictSize - dctxPtr->tmpOutStart;
-        if (dctxPtr->tmpOutSize > LIZARD_DICT_SIZE) copySize = 0;
+        if (dctxPtr->tmpOutSize > dctxPtr->windowSize) copySize = 0;
         if (copySize > preserveSize) copySize = preserveSize;
 
         memcpy(dctxPtr->tmpOutBuffer + preserveSize - copySize, oldDictEnd - copySize, copySize);
+        dctxPtr->bytesCopied += copySize;
 
         dctxPtr->dict = dctxPtr->tmpOutBuffer;
         dctxPtr->dictSize = preserveSize + dctxPtr->tmpOutStart + dstSize;
@@ -939,20 +1227,23 @@ static void LizardF_updateDict(LizardF_dctx_t* dctxPtr, const BYTE* dstPtr, size
 
     if (dctxPtr->dict == dctxPtr->tmpOutBuffer) {    /* copy dst into tmp to complete dict */
         if (dctxPtr->dictSize + dstSize > dctxPtr->maxBufferSize) {  /* tmp buffer not large enough */
-            size_t preserveSize = LIZARD_DICT_SIZE - dstSize;   /* note : dstSize < LIZARD_DICT_SIZE */
+            size_t preserveSize = dctxPtr->windowSize - dstSize;   /* note : dstSize < windowSize */
             memcpy(dctxPtr->tmpOutBuffer, dctxPtr->dict + dctxPtr->dictSize - preserveSize, preserveSize);
+            dctxPtr->bytesCopied += preserveSize;
             dctxPtr->dictSize = preserveSize;
         }
         memcpy(dctxPtr->tmpOutBuffer + dctxPtr->dictSize, dstPtr, dstSize);
+        dctxPtr->bytesCopied += dstSize;
         dctxPtr->dictSize += dstSize;
         return;
     }
 
     /* join dict & dest into tmp */
-    {   size_t preserveSize = LIZARD_DICT_SIZE - dstSize;   /* note : dstSize < LIZARD_DICT_SIZE */
+    {   size_t preserveSize = dctxPtr->windowSize - dstSize;   /* note : dstSize < windowSize */
         if (preserveSize > dctxPtr->dictSize) preserveSize = dctxPtr->dictSize;
         memcpy(dctxPtr->tmpOutBuffer, dctxPtr->dict + dctxPtr->dictSize - preserveSize, preserveSize);
         memcpy(dctxPtr->tmpOutBuffer + preserveSize, dstPtr, dstSize);
+        dctxPtr->bytesCopied += preserveSize + dstSize;
         dctxPtr->dict = dctxPtr->tmpOutBuffer;
         dctxPtr->dictSize = preserveSize + dstSize;
     }
@@ -1139,11 +1430,15 @@ size_t LizardF_decompress(LizardF_decompressionContext_t decompressionContext,
             /* fallthrough */
 
         case dstage_decodeCBlock:
-            if ((size_t)(dstEnd-dstPtr) < dctxPtr->maxBlockSize)   /* not enough place into dst : decode into tmpOut */
-                dctxPtr->dStage = dstage_decodeCBlock_intoTmp;
-            else
-                dctxPtr->dStage = dstage_decodeCBlock_intoDst;
-            break;
+            {   size_t maxDecodedSize = dctxPtr->maxBlockSize;
+                /* known content size : last block can be smaller than maxBlockSize, decode it directly into an exactly sized dst */
+                if ((dctxPtr->frameInfo.contentSize) && (dctxPtr->frameRemainingSize < maxDecodedSize)) maxDecodedSize = (size_t)dctxPtr->frameRemainingSize;
+                if ((size_t)(dstEnd-dstPtr) < maxDecodedSize)   /* not enough place into dst : decode into tmpOut */
+                    dctxPtr->dStage = dstage_decodeCBlock_intoTmp;
+                else
+                    dctxPtr->dStage = dstage_decodeCBlock_intoDst;
+                break;
+            }
 
         case dstage_decodeCBlock_intoDst:
             {   int (*decoder)(const char*, char*, int, int, const char*, int);
@@ -1154,7 +1449,10 @@ size_t LizardF_decompress(LizardF_decompressionContext_t decompressionContext,
                 else
                     decoder = LizardF_decompress_safe;
 
-                decodedSize = decoder((const char*)selectedIn, (char*)dstPtr, (int)dctxPtr->tmpInTarget, (int)dctxPtr->maxBlockSize, (const char*)dctxPtr->dict, (int)dctxPtr->dictSize);
+                {   size_t dstCapacity = dstEnd - dstPtr;
+                    if (dstCapacity > dctxPtr->maxBlockSize) dstCapacity = dctxPtr->maxBlockSize;
+                    decodedSize = decoder((const char*)selectedIn, (char*)dstPtr, (int)dctxPtr->tmpInTarget, (int)dstCapacity, (const char*)dctxPtr->dict, (int)dctxPtr->dictSize);
+                }
                 if (decodedSize < 0) return (size_t)-LizardF_ERROR_GENERIC;   /* decompression failed */
                 if (dctxPtr->frameInfo.contentChecksumFlag) XXH32_update(&(dctxPtr->xxh), dstPtr, decodedSize);
                 if (dctxPtr->frameInfo.contentSize) dctxPtr->frameRemainingSize -= decodedSize;
@@ -1181,14 +1479,15 @@ size_t LizardF_decompress(LizardF_decompressionContext_t decompressionContext,
                 /* ensure enough place for tmpOut */
                 if (dctxPtr->frameInfo.blockMode == LizardF_blockLinked) {
                     if (dctxPtr->dict == dctxPtr->tmpOutBuffer) {
-                        if (dctxPtr->dictSize > 2 * LIZARD_DICT_SIZE) {
-                            memcpy(dctxPtr->tmpOutBuffer, dctxPtr->dict + dctxPtr->dictSize - LIZARD_DICT_SIZE, LIZARD_DICT_SIZE);
-                            dctxPtr->dictSize = LIZARD_DICT_SIZE;
+                        if (dctxPtr->dictSize > 2 * dctxPtr->windowSize) {
+                            memcpy(dctxPtr->tmpOutBuffer, dctxPtr->dict + dctxPtr->dictSize - dctxPtr->windowSize, dctxPtr->windowSize);
+                            dctxPtr->bytesCopied += dctxPtr->windowSize;
+                            dctxPtr->dictSize = dctxPtr->windowSize;
                         }
                         dctxPtr->tmpOut = dctxPtr->tmpOutBuffer + dctxPtr->dictSize;
                     } else {  /* dict not within tmp */
                         size_t reservedDictSpace = dctxPtr->dictSize;
-                        if (reservedDictSpace > LIZARD_DICT_SIZE) reservedDictSpace = LIZARD_DICT_SIZE;
+                        if (reservedDictSpace > dctxPtr->windowSize) reservedDictSpace = dctxPtr->windowSize;
                         dctxPtr->tmpOut = dctxPtr->tmpOutBuffer + reservedDictSpace;
                     }
                 }
@@ -1208,6 +1507,7 @@ size_t LizardF_decompress(LizardF_decompressionContext_t decompressionContext,
             {   size_t sizeToCopy = dctxPtr->tmpOutSize - dctxPtr->tmpOutStart;
                 if (sizeToCopy > (size_t)(dstEnd-dstPtr)) sizeToCopy = dstEnd-dstPtr;
                 memcpy(dstPtr, dctxPtr->tmpOut + dctxPtr->tmpOutStart, sizeToCopy);
+                dctxPtr->bytesCopied += sizeToCopy;
 
                 /* dictionary management */
                 if (dctxPtr->frameInfo.blockMode==LizardF_blockLinked)
@@ -1328,21 +1628,23 @@ size_t LizardF_decompress(LizardF_decompressionContext_t decompressionContext,
     {
         if (dctxPtr->dStage == dstage_flushOut) {
             size_t preserveSize = dctxPtr->tmpOut - dctxPtr->tmpOutBuffer;
-            size_t copySize = LIZARD_DICT_SIZE - dctxPtr->tmpOutSize;
+            size_t copySize = dctxPtr->windowSize - dctxPtr->tmpOutSize;
             const BYTE* oldDictEnd = dctxPtr->dict + dctxPtr->dictSize - dctxPtr->tmpOutStart;
-            if (dctxPtr->tmpOutSize > LIZARD_DICT_SIZE) copySize = 0;
+            if (dctxPtr->tmpOutSize > dctxPtr->windowSize) copySize = 0;
             if (copySize > preserveSize) copySize = preserveSize;
 
             memcpy(dctxPtr->tmpOutBuffer + preserveSize - copySize, oldDictEnd - copySize, copySize);
+            dctxPtr->bytesCopied += copySize;
 
             dctxPtr->dict = dctxPtr->tmpOutBuffer;
             dctxPtr->dictSize = preserveSize + dctxPtr->tmpOutStart;
         } else {
             size_t newDictSize = dctxPtr->dictSize;
             const BYTE* oldDictEnd = dctxPtr->dict + dctxPtr->dictSize;
-            if ((newDictSize) > LIZARD_DICT_SIZE) newDictSize = LIZARD_DICT_SIZE;
+            if ((newDictSize) > dctxPtr->windowSize) newDictSize = dctxPtr->windowSize;
 
             memcpy(dctxPtr->tmpOutBuffer, oldDictEnd - newDictSize, newDictSize);
+            dctxPtr->bytesCopied += newDictSize;
 
             dctxPtr->dict = dctxPtr->tmpOutBuffer;
             dctxPtr->dictSize = newDictSize;
@@ -114,14 +114,16 @@ typedef struct {
   LizardF_contentChecksum_t contentChecksumFlag;   /* noContentChecksum, contentChecksumEnabled ; 0 == default  */
   LizardF_frameType_t       frameType;             /* LizardF_frame, skippableFrame ; 0 == default */
   unsigned long long     contentSize;           /* Size of uncompressed (original) content ; 0 == unknown */
-  unsigned               reserved[2];           /* must be zero for forward compatibility */
+  unsigned               windowLog;             /* log2 of history kept by linked blocks (11-24), written in frame header ; 0 == default (from compressionLevel, not written, readable by v1.0 decoders) */
+  unsigned               reserved[1];           /* must be zero for forward compatibility */
 } LizardF_frameInfo_t;
 
 typedef struct {
   LizardF_frameInfo_t frameInfo;
   int      compressionLevel;       /* 0 == default (fast mode); values above 16 count as 16; values below 0 count as 0 */
   unsigned autoFlush;              /* 1 == always flush (reduce need for tmp buffer) */
-  unsigned reserved[4];            /* must be zero for forward compatibility */
+  unsigned rsyncable;              /* 1 == blocks also end at content-defined boundaries (implies independent blocks) */
+  unsigned reserved[3];            /* must be zero for forward compatibility */
 } LizardF_preferences_t;
 
 
@@ -149,7 +151,7 @@ size_t LizardF_compressFrame(void* dstBuffer, size_t dstMaxSize, const void* src
 typedef struct LizardF_cctx_s* LizardF_compressionContext_t;   /* must be aligned on 8-bytes */
 
 typedef struct {
-  unsigned stableSrc;    /* 1 == src content will remain available on future calls to LizardF_compress(); avoid saving src content within tmp buffer as future dictionary */
+  unsigned stableSrc;    /* 1 == src content will remain available on future calls to LizardF_compressUpdate(); avoid saving src content within tmp buffer as future dictionary (see zero-copy mode) */
   unsigned reserved[3];
 } LizardF_compressOptions_t;
 
@@ -197,6 +199,19 @@ size_t LizardF_compressUpdate(LizardF_compressionContext_t cctx, void* dstBuffer
  * The LizardF_compressOptions_t structure is optional : you can provide NULL as argument.
  * The result of the function is the number of bytes written into dstBuffer : it can be zero, meaning input data was just buffered.
  * The function outputs an error code if it fails (can be tested using LizardF_isError())
+ *
+ * Zero-copy mode : set stableSrc=1 and provide whole blocks (srcSize a multiple of block size, or any size with autoFlush=1).
+ * Blocks are then compressed directly from srcBuffer, and in linked mode previous input is referenced in place as dictionary,
+ * instead of being copied into cctx. Nothing is copied, except raw blocks when data is not compressible.
+ * Previous input must remain available and unmodified at its memory position until the frame ends :
+ * when successive srcBuffer are contiguous, up to window size of history is used,
+ * otherwise only the previous srcBuffer is referenced.
+ * Input not forming a whole block (without autoFlush) is still copied into cctx.
+ *
+ * Rsyncable mode (preferences.rsyncable=1) : blocks also end where a rolling hash of the last 32 bytes
+ * hits a fixed pattern (every ~1/2 block size on average, not before 1/8 block size), instead of only when full.
+ * A local change of input then only changes the few blocks around it, and output stays efficient for rsync or dedup.
+ * Boundaries depend on content only if they are not forced by calls : use autoFlush=0 and avoid LizardF_flush().
  */
 
 size_t LizardF_flush(LizardF_compressionContext_t cctx, void* dstBuffer, size_t dstMaxSize, const LizardF_compressOptions_t* cOptPtr);
@@ -229,7 +244,7 @@ size_t LizardF_compressEnd(LizardF_compressionContext_t cctx, void* dstBuffer, s
 typedef struct LizardF_dctx_s* LizardF_decompressionContext_t;   /* must be aligned on 8-bytes */
 
 typedef struct {
-  unsigned stableDst;       /* guarantee that decompressed data will still be there on next function calls (avoid storage into tmp buffers) */
+  unsigned stableDst;       /* guarantee that decompressed data will still be there on next function calls (avoid storage into tmp buffers, see direct decoding) */
   unsigned reserved[3];
 } LizardF_decompressOptions_t;
 
@@ -290,6 +305,11 @@ size_t LizardF_getFrameInfo(LizardF_decompressionContext_t dctx,
  * If decompression failed, function result is an error code, which can be tested using LizardF_isError().
  *
  * After a frame is fully decoded, dctx can be used again to decompress another frame.
+ *
+ * Direct decoding : blocks are decoded straight into dstBuffer, without going through internal tmp buffers,
+ * whenever dstBuffer has room for a full block, or, when frame content size is known, for the rest of the frame.
+ * With linked blocks, history is then referenced in place if each call continues where the previous one ended
+ * (dstBuffer == previous dstBuffer + *dstSizePtr) and stableDst is set, or if dstBuffer holds the whole frame.
  */
 size_t LizardF_decompress(LizardF_decompressionContext_t dctx,
                        void* dstBuffer, size_t* dstSizePtr,
@@ -65,6 +65,7 @@ extern "C" {
         ITEM(ERROR_srcPtr_wrong) \
         ITEM(ERROR_decompressionFailed) \
         ITEM(ERROR_headerChecksum_invalid) ITEM(ERROR_contentChecksum_invalid) \
+        ITEM(ERROR_windowSize_invalid) \
         ITEM(ERROR_maxCode)
 
 //#define LIZARDF_DISABLE_OLD_ENUMS
@@ -76,6 +77,53 @@ extern "C" {
 typedef enum { LIZARDF_LIST_ERRORS(LIZARDF_GENERATE_ENUM) } LizardF_errorCodes;  /* enum is exposed, to handle specific errors; compare function result to -enum value */
 
 
+/**************************************
+ * Advanced compression functions
+ * ************************************/
+/*! LizardF_compressBegin_usingDict() :
+ *  Same as LizardF_compressBegin(), but with linked blocks (LizardF_blockLinked),
+ *  first block may also reference up to window size last bytes of `dict`.
+ *  It allows to compress a frame in separate parts (e.g. in parallel) :
+ *  each part is compressed with previous part as `dict`, and its blocks are concatenated after a single frame header.
+ *  `dict` must remain unmodified while it can be referenced : placing it just before `srcBuffer`,
+ *  and compressing the whole part within a single LizardF_compressUpdate() with stableSrc, is enough.
+ *  The decoder needs nothing special : `dict` is regular history of the frame.
+ *  @return : size of frame header, or an error code (can be tested using LizardF_isError()) */
+size_t LizardF_compressBegin_usingDict(LizardF_compressionContext_t compressionContext, void* dstBuffer, size_t dstMaxSize,
+                                       const void* dict, size_t dictSize, const LizardF_preferences_t* preferencesPtr);
+
+
+/*! LizardF_setCompressionLevel() :
+ *  Changes compression level for next blocks of the frame being compressed, e.g. to adapt to I/O speed.
+ *  Must be called at a block boundary : between LizardF_compressUpdate() calls, with no input buffered
+ *  (using `autoFlush`, or after LizardF_flush()).
+ *  With linked blocks, history is preserved, and new level is bounded by window size of the frame.
+ *  @return : 0, or an error code (can be tested using LizardF_isError()) */
+size_t LizardF_setCompressionLevel(LizardF_compressionContext_t compressionContext, int compressionLevel);
+
+/*! LizardF_compressZeros() :
+ *  Same as LizardF_compressUpdate() with `srcSize` zero bytes, e.g. holes of sparse files, which need not be read.
+ *  With independent blocks, a full block of zeros is compressed once, then its result is repeated : input is not parsed.
+ *  `dstMaxSize` must be >= LizardF_compressBound(srcSize, preferences), as with LizardF_compressUpdate().
+ *  @return : nb of bytes written into `dstBuffer`, or an error code (can be tested using LizardF_isError()) */
+size_t LizardF_compressZeros(LizardF_compressionContext_t compressionContext, void* dstBuffer, size_t dstMaxSize, size_t srcSize);
+
+/*! LizardF_getHeaderInfo() :
+ *  Decodes and checks a whole frame header (including magic number), without decompression context,
+ *  e.g. to decode blocks by other means. With linked blocks, `windowLog` is set even when not written (default : 24).
+ *  @return : size of frame header, or an error code (can be tested using LizardF_isError()) */
+size_t LizardF_getHeaderInfo(LizardF_frameInfo_t* frameInfoPtr, const void* srcBuffer, size_t srcSize);
+
+/*! LizardF_getHistoryCopied() :
+ *  Linked blocks keep up to window size of history : when input is not stable (see `stableSrc`), it is copied into cctx.
+ *  @return : nb of history bytes copied since LizardF_compressBegin() of current frame (0 in zero-copy mode) */
+unsigned long long LizardF_getHistoryCopied(LizardF_compressionContext_t compressionContext);
+
+/*! LizardF_getDecodedCopied() :
+ *  Blocks which don't fit into dstBuffer are decoded into dctx, and history of linked blocks may be moved into it (see direct decoding).
+ *  @return : nb of bytes copied that way since start of current frame (0 when all blocks are decoded directly) */
+unsigned long long LizardF_getDecodedCopied(LizardF_decompressionContext_t decompressionContext);
+
 #if defined (__cplusplus)
 }
 #endif
@@ -105,6 +105,10 @@ FORCE_INLINE int Lizard_InsertAndFindBestMatch (Lizard_stream_t* ctx,   /* Index
     return (int)ml;
 }
 
+LIZARD_PROFILE_WRAPPER(int, Lizard_InsertAndFindBestMatch, ctx, Lizard_phase_matchFinding,
+                       (Lizard_stream_t* ctx, const BYTE* ip, const BYTE* const iLimit, const BYTE** matchpos), (ctx, ip, iLimit, matchpos))
+#define Lizard_InsertAndFindBestMatch Lizard_InsertAndFindBestMatch_profiled
+
 
 FORCE_INLINE int Lizard_InsertAndGetWiderMatch (
     Lizard_stream_t* ctx,
@@ -184,6 +188,10 @@ FORCE_INLINE int Lizard_InsertAndGetWiderMatch (
     return longest;
 }
 
+LIZARD_PROFILE_WRAPPER(int, Lizard_InsertAndGetWiderMatch, ctx, Lizard_phase_matchFinding,
+                       (Lizard_stream_t* ctx, const BYTE* const ip, const BYTE* const iLowLimit, const BYTE* const iHighLimit, int longest, const BYTE** matchpos, const BYTE** startpos), (ctx, ip, iLowLimit, iHighLimit, longest, matchpos, startpos))
+#define Lizard_InsertAndGetWiderMatch Lizard_InsertAndGetWiderMatch_profiled
+
 
 FORCE_INLINE int Lizard_compress_hashChain (
         Lizard_stream_t* const ctx,
@@ -121,6 +121,10 @@ FORCE_INLINE int Lizard_FindMatchLowestPrice (Lizard_stream_t* ctx,   /* Index t
     return (int)ml;
 }
 
+LIZARD_PROFILE_WRAPPER(int, Lizard_FindMatchLowestPrice, ctx, Lizard_phase_matchFinding,
+                       (Lizard_stream_t* ctx, const BYTE* ip, const BYTE* const iLimit, const BYTE** matchpos), (ctx, ip, iLimit, matchpos))
+#define Lizard_FindMatchLowestPrice Lizard_FindMatchLowestPrice_profiled
+
 
 FORCE_INLINE size_t Lizard_GetWiderMatch (
     Lizard_stream_t* ctx,
@@ -250,6 +254,10 @@ FORCE_INLINE size_t Lizard_GetWiderMatch (
     return longest;
 }
 
+LIZARD_PROFILE_WRAPPER(size_t, Lizard_GetWiderMatch, ctx, Lizard_phase_matchFinding,
+                       (Lizard_stream_t* ctx, const BYTE* const ip, const BYTE* const iLowLimit, const BYTE* const iHighLimit, size_t longest, const BYTE** matchpos, const BYTE** startpos), (ctx, ip, iLowLimit, iHighLimit, longest, matchpos, startpos))
+#define Lizard_GetWiderMatch Lizard_GetWiderMatch_profiled
+
 
 
 
@@ -73,6 +73,10 @@ FORCE_INLINE int Lizard_InsertAndFindBestMatchNoChain (Lizard_stream_t* ctx,   /
     return (int)ml;
 }
 
+LIZARD_PROFILE_WRAPPER(int, Lizard_InsertAndFindBestMatchNoChain, ctx, Lizard_phase_matchFinding,
+                       (Lizard_stream_t* ctx, const BYTE* ip, const BYTE* const iLimit, const BYTE** matchpos), (ctx, ip, iLimit, matchpos))
+#define Lizard_InsertAndFindBestMatchNoChain Lizard_InsertAndFindBestMatchNoChain_profiled
+
 
 FORCE_INLINE int Lizard_InsertAndGetWiderMatchNoChain (
     Lizard_stream_t* ctx,
@@ -139,6 +143,10 @@ FORCE_INLINE int Lizard_InsertAndGetWiderMatchNoChain (
     return longest;
 }
 
+LIZARD_PROFILE_WRAPPER(int, Lizard_InsertAndGetWiderMatchNoChain, ctx, Lizard_phase_matchFinding,
+                       (Lizard_stream_t* ctx, const BYTE* const ip, const BYTE* const iLowLimit, const BYTE* const iHighLimit, int longest, const BYTE** matchpos, const BYTE** startpos), (ctx, ip, iLowLimit, iHighLimit, longest, matchpos, startpos))
+#define Lizard_InsertAndGetWiderMatchNoChain Lizard_InsertAndGetWiderMatchNoChain_profiled
+
 
 FORCE_INLINE int Lizard_compress_noChain (
         Lizard_stream_t* const ctx,
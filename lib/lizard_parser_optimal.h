@@ -175,6 +175,10 @@ FORCE_INLINE int Lizard_GetAllMatches (
     return mnum;
 }
 
+LIZARD_PROFILE_WRAPPER(int, Lizard_GetAllMatches, ctx, Lizard_phase_matchFinding,
+                       (Lizard_stream_t* ctx, const BYTE* const ip, const BYTE* const iLowLimit, const BYTE* const iHighLimit, size_t best_mlen, Lizard_match_t* matches), (ctx, ip, iLowLimit, iHighLimit, best_mlen, matches))
+#define Lizard_GetAllMatches Lizard_GetAllMatches_profiled
+
 
 
 
@@ -319,6 +323,10 @@ FORCE_INLINE int Lizard_BinTree_GetAllMatches (
     return mnum;
 }
 
+LIZARD_PROFILE_WRAPPER(int, Lizard_BinTree_GetAllMatches, ctx, Lizard_phase_matchFinding,
+                       (Lizard_stream_t* ctx, const BYTE* const ip, const BYTE* const iHighLimit, size_t best_mlen, Lizard_match_t* matches), (ctx, ip, iHighLimit, best_mlen, matches))
+#define Lizard_BinTree_GetAllMatches Lizard_BinTree_GetAllMatches_profiled
+
 
 #define SET_PRICE(pos, mlen, offset, litlen, price)   \
     {                                                 \
@@ -86,6 +86,10 @@ FORCE_INLINE int Lizard_FindMatchFast(Lizard_stream_t* ctx, intptr_t matchIndex,
     return (int)ml;
 }
 
+LIZARD_PROFILE_WRAPPER(int, Lizard_FindMatchFast, ctx, Lizard_phase_matchFinding,
+                       (Lizard_stream_t* ctx, intptr_t matchIndex, intptr_t matchIndex3, const BYTE* ip, const BYTE* const iLimit, const BYTE** matchpos), (ctx, matchIndex, matchIndex3, ip, iLimit, matchpos))
+#define Lizard_FindMatchFast Lizard_FindMatchFast_profiled
+
 
 FORCE_INLINE int Lizard_FindMatchFaster (Lizard_stream_t* ctx, U32 matchIndex,  /* Index table will be updated */
                                                const BYTE* ip, const BYTE* const iLimit,
@@ -127,6 +131,10 @@ FORCE_INLINE int Lizard_FindMatchFaster (Lizard_stream_t* ctx, U32 matchIndex,
     return (int)ml;
 }
 
+LIZARD_PROFILE_WRAPPER(int, Lizard_FindMatchFaster, ctx, Lizard_phase_matchFinding,
+                       (Lizard_stream_t* ctx, U32 matchIndex, const BYTE* ip, const BYTE* const iLimit, const BYTE** matchpos), (ctx, matchIndex, ip, iLimit, matchpos))
+#define Lizard_FindMatchFaster Lizard_FindMatchFaster_profiled
+
 
 
 FORCE_INLINE int Lizard_compress_priceFast(
@@ -33,6 +33,9 @@
 #if defined(__MINGW32__) && !defined(_POSIX_SOURCE)
 #  define _POSIX_SOURCE 1          /* disable %llu warnings with MinGW on Windows */
 #endif
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#  define _GNU_SOURCE 1            /* sched_setaffinity */
+#endif
 
 
 /* *************************************
@@ -50,6 +53,14 @@
 #include "lizard_decompress.h"
 #define UTIL_WITHOUT_BASIC_TYPES
 #include "util.h"        /* UTIL_GetFileSize, UTIL_sleep */
+#include "threadpool.h"  /* TPOOL_create, TPOOL_add, TPOOL_jobsCompleted */
+#include "bench.h"
+#if defined(__linux__) && defined(LIZARD_MULTITHREAD)
+#  include <sched.h>     /* sched_setaffinity */
+#  define BMK_PIN_THREADS 1
+#else
+#  define BMK_PIN_THREADS 0
+#endif
 
 #define Lizard_isError(errcode) (errcode==0)
 
@@ -65,9 +76,16 @@
 
 #define NBSECONDS             3
 #define TIMELOOP_MICROSEC     1*1000000ULL /* 1 second */
+#define SAMPLE_MICROSEC       10000     /* without --repeat, each timing sample lasts at least 10 ms */
 #define ACTIVEPERIOD_MICROSEC 70*1000000ULL /* 70 seconds */
 #define COOLPERIOD_SEC        10
 #define DECOMP_MULT           2 /* test decompression DECOMP_MULT times longer than compression */
+#define MT_BLOCKSIZE          (4 MB) /* default block size with multiple threads, as compression jobs of lizardio */
+#define LATENCY_MAX_SIZES     16
+#define SWEEP_MAX_VALUES  16
+#define LATENCY_DICTSIZE      (64 KB)   /* without --dict, taken from beginning of input */
+#define LATENCY_MAX_INPUT     (64 MB)   /* messages are taken from at most 64 MB of input */
+#define LATENCY_MAX_SAMPLES   (1 << 22)
 
 #define KB *(1 <<10)
 #define MB *(1 <<20)
@@ -76,6 +94,8 @@
 static const size_t maxMemory = (sizeof(size_t)==4)  ?  (2 GB - 64 MB) : (size_t)(1ULL << ((sizeof(size_t)*8)-31));
 
 static U32 g_compressibilityDefault = 50;
+static RDG_type_e g_syntheticType = RDG_lz;
+static U32 g_syntheticSeed = 0;
 
 
 /* *************************************
@@ -115,6 +135,24 @@ static clock_t g_time = 0;
 ***************************************/
 static U32 g_nbSeconds = NBSECONDS;
 static size_t g_blockSize = 0;
+static unsigned g_nbThreads = 1;
+static unsigned g_scaling = 0;
+static unsigned g_privateInputs = 0;
+static unsigned g_pinThreads = 0;
+static unsigned g_nbRepeats = 0;
+static unsigned g_reuseContext = 0;
+static unsigned g_nbContexts = 1;
+static size_t g_coldCacheSize = 0;   /* 0 : caches are warm */
+static BMK_format_e g_format = BMK_format_human;
+static U32 g_nbRecords = 0;
+static unsigned g_messageSizes[LATENCY_MAX_SIZES];
+static unsigned g_nbMessageSizes = 0;   /* 0 : latency mode disabled */
+static const char* g_dictFileName = NULL;
+static unsigned g_sweepValues[BMK_sweep_count][SWEEP_MAX_VALUES];
+static unsigned g_nbSweepValues[BMK_sweep_count] = { 0 };   /* all 0 : sweep mode disabled */
+static unsigned g_tuneBudget = 0;   /* 0 : tune mode disabled */
+static double g_targetCSpeed = 0., g_targetDSpeed = 0.;   /* MB/s */
+static Lizard_cParams_t g_cParams = { 0, 0, 0, 0, 0, 0, 0 };   /* overrides of level parameters, set by sweep and tune modes */
 int g_additionalParam = 0;
 
 void BMK_setNotificationLevel(unsigned level) { g_displayLevel=level; }
@@ -132,6 +170,70 @@ void BMK_SetBlockSize(size_t blockSize)
     g_blockSize = blockSize;
 }
 
+void BMK_setNbThreads(unsigned nbThreads)
+{
+    g_nbThreads = nbThreads ? nbThreads : 1;
+}
+
+void BMK_setScaling(unsigned scaling) { g_scaling = scaling; }
+
+void BMK_setNbRepeats(unsigned nbRepeats) { g_nbRepeats = nbRepeats; }
+
+void BMK_setReuseContext(unsigned reuse) { g_reuseContext = reuse; }
+
+void BMK_setNbContexts(unsigned nbContexts)
+{
+    g_nbContexts = nbContexts ? nbContexts : 1;
+    if (nbContexts > 1) g_reuseContext = 1;
+}
+
+void BMK_setColdCache(size_t evictionSize) { g_coldCacheSize = evictionSize; }
+
+void BMK_setFormat(BMK_format_e format) { g_format = format; }
+
+void BMK_setLatencyMode(const unsigned* messageSizes, unsigned nbSizes)
+{
+    static const unsigned defaultSizes[] = { 200, 1 KB, 4 KB, 16 KB };
+    unsigned n;
+    if (nbSizes == 0) { messageSizes = defaultSizes; nbSizes = sizeof(defaultSizes) / sizeof(defaultSizes[0]); }
+    if (nbSizes > LATENCY_MAX_SIZES) nbSizes = LATENCY_MAX_SIZES;
+    for (n=0; n<nbSizes; n++) g_messageSizes[n] = messageSizes[n] ? messageSizes[n] : 1;
+    g_nbMessageSizes = nbSizes;
+}
+
+void BMK_setDictFileName(const char* dictFileName) { g_dictFileName = dictFileName; }
+
+void BMK_setTuneBudget(unsigned budget) { g_tuneBudget = budget; }
+
+void BMK_setTargetSpeed(unsigned cSpeed, unsigned dSpeed) { g_targetCSpeed = cSpeed; g_targetDSpeed = dSpeed; }
+
+void BMK_setSweep(BMK_sweepParam_e param, const unsigned* values, unsigned nbValues)
+{
+    static const unsigned defaultBlockSizes[] = { 1 KB, 4 KB, 16 KB, 64 KB, 256 KB, 1 MB, 4 MB };
+    if ((unsigned)param >= BMK_sweep_count) return;
+    if (param == BMK_sweep_blockSize && nbValues == 0) {
+        values = defaultBlockSizes;
+        nbValues = sizeof(defaultBlockSizes) / sizeof(defaultBlockSizes[0]);
+    }
+    if (nbValues > SWEEP_MAX_VALUES) nbValues = SWEEP_MAX_VALUES;
+    memcpy(g_sweepValues[param], values, nbValues * sizeof(*values));
+    g_nbSweepValues[param] = nbValues;
+}
+
+void BMK_setSyntheticInput(unsigned type, unsigned seed)
+{
+    g_syntheticType = (type < RDG_nbTypes) ? (RDG_type_e)type : RDG_lz;
+    g_syntheticSeed = seed;
+}
+
+void BMK_setPrivateInputs(unsigned privateInputs) { g_privateInputs = privateInputs; }
+
+void BMK_setPinThreads(unsigned pin)
+{
+    if (pin && !BMK_PIN_THREADS) DISPLAYLEVEL(2, "Note : threads can't be pinned to cores in this build \n");
+    g_pinThreads = pin && BMK_PIN_THREADS;
+}
+
 
 /* ********************************************************
 *  Bench functions
@@ -146,13 +248,334 @@ typedef struct {
     size_t resSize;
 } blockParam_t;
 
+/* with multiple threads, thread n processes blocks n, n+nbThreads, n+2*nbThreads, ... */
+typedef struct {
+    blockParam_t* blockTable;
+    U32 firstBlock;
+    U32 nbBlocks;
+    U32 step;
+    int cLevel;
+    void* cState;   /* reused by all blocks with g_reuseContext or overridden parameters, otherwise NULL : Lizard_compress() allocates one per block */
+    U32 nbStates;   /* with g_nbContexts, blocks cycle over several states, one after another within cState */
+    U32 stateNb;
+    size_t stateSize;
+    int error;
+} BMK_job_t;
+
+/* 1 if parameters of levels are overridden by g_cParams */
+static int BMK_overridesParams(void)
+{
+    static const Lizard_cParams_t noOverride = { 0, 0, 0, 0, 0, 0, 0 };
+    return memcmp(&g_cParams, &noOverride, sizeof(g_cParams)) != 0;
+}
+
+static void BMK_compressJob(void* opaque)
+{
+    BMK_job_t* const job = (BMK_job_t*)opaque;
+    U32 blockNb;
+    for (blockNb=job->firstBlock; blockNb<job->nbBlocks; blockNb+=job->step) {
+        blockParam_t* const block = job->blockTable + blockNb;
+        void* const state = job->cState ? (char*)job->cState + (job->stateNb++ % job->nbStates) * job->stateSize : NULL;
+        size_t rSize;
+        if (state)
+            rSize = Lizard_compress_advanced(state, block->srcPtr, block->cPtr, (int)block->srcSize, (int)block->cRoom, job->cLevel, g_cParams);
+        else
+            rSize = Lizard_compress(block->srcPtr, block->cPtr, (int)block->srcSize, (int)block->cRoom, job->cLevel);
+        if (Lizard_isError(rSize) || rSize == 0) { job->error = 1; return; }
+        block->cSize = rSize;
+    }
+}
+
+static void BMK_decompressJob(void* opaque)
+{
+    BMK_job_t* const job = (BMK_job_t*)opaque;
+    U32 blockNb;
+    for (blockNb=job->firstBlock; blockNb<job->nbBlocks; blockNb+=job->step) {
+        blockParam_t* const block = job->blockTable + blockNb;
+        int const regenSize = Lizard_decompress_safe(block->cPtr, block->resPtr, (int)block->cSize, (int)block->srcSize);
+        if (regenSize < 0) {
+            DISPLAY("Lizard_decompress_safe() failed on block %u  \n", blockNb);
+            job->error = 1;
+            return;
+        }
+        block->resSize = (size_t)regenSize;
+    }
+}
+
+/* one record of machine-readable output, for each (file, level, block size, nb of threads) */
+typedef struct {
+    const char* name;
+    int cLevel;
+    size_t blockSize;
+    unsigned nbThreads;
+    size_t srcSize;
+    size_t cSize;
+    double cSpeed, cMedian, cStddev;   /* MB/s : fastest, median ; stddev is relative */
+    double dSpeed, dMedian, dStddev;
+    U32 cRuns, dRuns;
+    U64 memory;                        /* buffers and compression states used by the bench */
+    U64 contextSize;                   /* Lizard_sizeofState() */
+    Lizard_cParams_t cParams;          /* overrides of level parameters, 0 : default */
+} BMK_result_t;
+
+static BMK_result_t* g_sweepResults = NULL;   /* with sweep and tune modes, BMK_benchMem() appends its result here */
+static U32 g_nbSweepResults = 0;
+
+/* writes `name` as a quoted string : csv doubles quotes, json escapes quotes, backslashes and control characters */
+static void BMK_printQuoted(const char* name)
+{
+    const unsigned char* p;
+    putchar('"');
+    for (p=(const unsigned char*)name; *p; p++) {
+        if (*p == '"') fputs((g_format == BMK_format_json) ? "\\\"" : "\"\"", stdout);
+        else if ((g_format == BMK_format_json) && (*p == '\\')) fputs("\\\\", stdout);
+        else if ((g_format == BMK_format_json) && (*p < 0x20)) printf("\\u%04x", *p);
+        else putchar(*p);
+    }
+    putchar('"');
+}
+
+/* writes `result` on stdout, as csv or json (one object per line), if selected */
+static void BMK_outputResult(const BMK_result_t* r)
+{
+    if (g_format == BMK_format_human) return;
+    if (g_format == BMK_format_csv) {
+        if (g_nbRecords == 0)
+            printf("file,level,block_size,threads,src_size,compressed_size,ratio,c_mbs_fastest,c_mbs_median,c_stddev_pct,"
+                   "d_mbs_fastest,d_mbs_median,d_stddev_pct,c_runs,d_runs,mem_bytes,peak_rss_bytes,ctx_bytes,cold,hash_log,search_num\n");
+        BMK_printQuoted(r->name);
+        printf(",%i,%llu,%u,%llu,%llu,%.4f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%u,%u,%llu,%llu,%llu,%u,%u,%u\n",
+               r->cLevel, (unsigned long long)r->blockSize, r->nbThreads, (unsigned long long)r->srcSize, (unsigned long long)r->cSize, (double)r->srcSize / r->cSize,
+               r->cSpeed, r->cMedian, r->cStddev*100, r->dSpeed, r->dMedian, r->dStddev*100, r->cRuns, r->dRuns,
+               (unsigned long long)r->memory, (unsigned long long)UTIL_getPeakMemory(), (unsigned long long)r->contextSize, g_coldCacheSize != 0,
+               r->cParams.hashLog, r->cParams.searchNum);
+    } else {
+        printf("{\"file\":");
+        BMK_printQuoted(r->name);
+        printf(",\"level\":%i,\"block_size\":%llu,\"threads\":%u,\"src_size\":%llu,\"compressed_size\":%llu,\"ratio\":%.4f,"
+               "\"c_mbs_fastest\":%.2f,\"c_mbs_median\":%.2f,\"c_stddev_pct\":%.2f,\"d_mbs_fastest\":%.2f,\"d_mbs_median\":%.2f,\"d_stddev_pct\":%.2f,"
+               "\"c_runs\":%u,\"d_runs\":%u,\"mem_bytes\":%llu,\"peak_rss_bytes\":%llu,\"ctx_bytes\":%llu,\"cold\":%u,\"hash_log\":%u,\"search_num\":%u}\n",
+               r->cLevel, (unsigned long long)r->blockSize, r->nbThreads, (unsigned long long)r->srcSize, (unsigned long long)r->cSize, (double)r->srcSize / r->cSize,
+               r->cSpeed, r->cMedian, r->cStddev*100, r->dSpeed, r->dMedian, r->dStddev*100, r->cRuns, r->dRuns,
+               (unsigned long long)r->memory, (unsigned long long)UTIL_getPeakMemory(), (unsigned long long)r->contextSize, g_coldCacheSize != 0,
+               r->cParams.hashLog, r->cParams.searchNum);
+    }
+    fflush(stdout);
+    g_nbRecords++;
+}
+
+
+/* allocates compression states of `job`, with g_reuseContext : g_nbContexts of them.
+   Lizard_compress() can't override parameters : with overrides, a single state is allocated here, out of timed loops */
+static void BMK_initJobState(BMK_job_t* job)
+{
+    job->cState = NULL;
+    job->nbStates = g_nbContexts;
+    job->stateNb = 0;
+    job->stateSize = ((size_t)Lizard_sizeofState_advanced(job->cLevel, g_cParams) + 63) & ~(size_t)63;   /* each state starts on a cache line */
+    if (!g_reuseContext) {
+        if (!BMK_overridesParams()) return;
+        job->nbStates = 1;
+    }
+    job->cState = malloc(job->stateSize * job->nbStates);
+    if (!job->cState) EXM_THROW(31, "allocation error : not enough memory");
+}
+
+/* reads and writes each cache line of `buffer`, so that, larger than last level cache, it evicts previous data.
+   It runs on the calling thread : with -T#, shared last level cache is evicted, but private caches of worker threads
+   may still hold data of their previous jobs (unless last level cache is inclusive) */
+static volatile BYTE g_evictionSink;   /* keeps eviction from being optimized away */
+static void BMK_evictCaches(void* buffer, size_t size)
+{
+    BYTE* const p = (BYTE*)buffer;
+    BYTE sum = 0;
+    size_t i;
+    for (i=0; i<size; i+=64) { p[i]++; sum += p[i]; }
+    g_evictionSink = sum;
+}
+
+
+/* timing samples, in microseconds per pass over all blocks */
+typedef struct {
+    double* micro;
+    U32 nb;
+    U32 capacity;
+} BMK_samples_t;
+
+static void BMK_addSample(BMK_samples_t* samples, double micro)
+{
+    if (samples->nb == samples->capacity) {
+        U32 const newCapacity = samples->capacity ? samples->capacity * 2 : 64;
+        double* const newTable = (double*)realloc(samples->micro, newCapacity * sizeof(double));
+        if (!newTable) EXM_THROW(31, "allocation error : not enough memory");
+        samples->micro = newTable;
+        samples->capacity = newCapacity;
+    }
+    samples->micro[samples->nb++] = micro;
+}
+
+static int BMK_cmpDouble(const void* a, const void* b)
+{
+    double const x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/* Newton's method : avoids depending on libm */
+static double BMK_sqrt(double x)
+{
+    double r = (x > 1.) ? x : 1.;
+    int n;
+    if (x <= 0.) return 0.;
+    for (n=0; n<64; n++) r = (r + x/r) / 2;
+    return r;
+}
+
+/* sorts samples; stddev is relative to mean */
+static void BMK_sampleStats(BMK_samples_t* samples, double* median, double* stddev)
+{
+    double mean = 0., var = 0.;
+    U32 n;
+    *median = 0.; *stddev = 0.;
+    if (samples->nb == 0) return;
+    qsort(samples->micro, samples->nb, sizeof(double), BMK_cmpDouble);
+    *median = (samples->nb & 1) ? samples->micro[samples->nb/2] : (samples->micro[samples->nb/2 - 1] + samples->micro[samples->nb/2]) / 2;
+    for (n=0; n<samples->nb; n++) mean += samples->micro[n];
+    mean /= samples->nb;
+    for (n=0; n<samples->nb; n++) var += (samples->micro[n] - mean) * (samples->micro[n] - mean);
+    *stddev = BMK_sqrt(var / samples->nb) / mean;
+}
+
+
+/* cuts each file into blocks of `blockSize`; returns nb of blocks */
+static U32 BMK_initBlockTable(blockParam_t* blockTable, const void* srcBuffer, void* compressedBuffer, void* resultBuffer,
+                              size_t blockSize, const size_t* fileSizes, U32 nbFiles)
+{
+    const char* srcPtr = (const char*)srcBuffer;
+    char* cPtr = (char*)compressedBuffer;
+    char* resPtr = (char*)resultBuffer;
+    U32 nbBlocks, fileNb;
+    for (nbBlocks=0, fileNb=0; fileNb<nbFiles; fileNb++) {
+        size_t remaining = fileSizes[fileNb];
+        U32 const nbBlocksforThisFile = (U32)((remaining + (blockSize-1)) / blockSize);
+        U32 const blockEnd = nbBlocks + nbBlocksforThisFile;
+        for ( ; nbBlocks<blockEnd; nbBlocks++) {
+            size_t const thisBlockSize = MIN(remaining, blockSize);
+            blockTable[nbBlocks].srcPtr = srcPtr;
+            blockTable[nbBlocks].cPtr = cPtr;
+            blockTable[nbBlocks].resPtr = resPtr;
+            blockTable[nbBlocks].srcSize = thisBlockSize;
+            blockTable[nbBlocks].cRoom = Lizard_compressBound((int)thisBlockSize);
+            srcPtr += thisBlockSize;
+            cPtr += blockTable[nbBlocks].cRoom;
+            resPtr += thisBlockSize;
+            remaining -= thisBlockSize;
+    }   }
+    return nbBlocks;
+}
+
+/* runs `function` on all blocks, split between threads; returns 0 if all succeeded */
+static int BMK_runJobs(TPOOL_ctx* pool, BMK_job_t* jobs, TPOOL_function function)
+{
+    U32 t;
+    int error = 0;
+    for (t=0; t<jobs[0].step; t++) {
+        jobs[t].error = 0;
+        TPOOL_add(pool, function, jobs+t);
+    }
+    TPOOL_jobsCompleted(pool);
+    for (t=0; t<jobs[0].step; t++) error |= jobs[t].error;
+    return error;
+}
+
+
+
+/* displays sizes of streams, sequences and most frequent tokens of `stats` */
+static void BMK_displayStats(const char* name, const Lizard_blockStats_t* stats)
+{
+    static const char* const streamNames[Lizard_stream_count] = { "literals", "flags", "offset16", "offset24", "lengths", "uncompressed" };
+    unsigned long long tokens[256];
+    int type, n;
+    DISPLAY("%s :", name);
+    for (type=0; type<Lizard_stream_count; type++) {
+        if (stats->rawSize[type] == 0) continue;
+        DISPLAY(" %s %llu", streamNames[type], stats->rawSize[type]);
+        if (stats->huffmanCoded[type]) DISPLAY("->%llu (huf x%llu)", stats->storedSize[type], stats->huffmanCoded[type]);
+        DISPLAY(",");
+    }
+    DISPLAY(" %llu sequences (last offset %.1f%%), %llu/%llu sub-blocks uncompressed \n", stats->nbSequences,
+            100. * stats->nbLastOffsets / (stats->nbSequences + !stats->nbSequences), stats->nbUncompressedSubBlocks, stats->nbSubBlocks);
+    if (stats->nbSequences == 0) return;
+    memcpy(tokens, stats->tokens, sizeof(tokens));
+    DISPLAY("%s : most frequent tokens :", name);
+    for (n=0; n<8; n++) {   /* selection of 8 largest counts */
+        int t, best = 0;
+        for (t=1; t<256; t++) if (tokens[t] > tokens[best]) best = t;
+        if (tokens[best] == 0) break;
+        DISPLAY(" 0x%02X %.1f%%", best, 100. * tokens[best] / stats->nbSequences);
+        tokens[best] = 0;
+    }
+    DISPLAY(" \n");
+}
+
+/* statistics of compressed blocks, per block with -vv, then for all blocks */
+static void BMK_displayBlockStats(const blockParam_t* blockTable, U32 nbBlocks, int cLevel)
+{
+    Lizard_blockStats_t total;
+    char name[32];
+    U32 blockNb;
+    memset(&total, 0, sizeof(total));
+    for (blockNb=0; blockNb<nbBlocks; blockNb++) {
+        const blockParam_t* const block = blockTable + blockNb;
+        if (Lizard_getBlockStats(block->cPtr, (int)block->cSize, &total)) EXM_THROW(3, "Lizard_getBlockStats() failed on block %u", blockNb);
+        if (g_displayLevel >= 4) {
+            Lizard_blockStats_t stats;
+            memset(&stats, 0, sizeof(stats));
+            Lizard_getBlockStats(block->cPtr, (int)block->cSize, &stats);
+            snprintf(name, sizeof(name), "%2i# block %u", cLevel, blockNb);
+            BMK_displayStats(name, &stats);
+    }   }
+    snprintf(name, sizeof(name), "%2i# streams", cLevel);
+    BMK_displayStats(name, &total);
+}
+
+
+/* with a library compiled with LIZARD_PROFILE, compresses all blocks once more,
+   and displays cycles and calls of each phase of compression (see Lizard_getProfile()) */
+static void BMK_displayProfile(const blockParam_t* blockTable, U32 nbBlocks, int cLevel)
+{
+    static const char* const phaseNames[Lizard_phase_count] = { "match finding", "pricing", "encoding", "entropy", "total" };
+    Lizard_stream_t* const ctx = (Lizard_stream_t*)malloc((size_t)Lizard_sizeofState_advanced(cLevel, g_cParams));
+    unsigned long long cycles[Lizard_phase_count] = { 0 }, calls[Lizard_phase_count] = { 0 };
+    U32 blockNb;
+    int phase;
+    if (ctx == NULL) EXM_THROW(31, "allocation error : not enough memory");
+    if (Lizard_getProfile(ctx) == NULL) { free(ctx); return; }   /* not a profiling build */
+
+    for (blockNb=0; blockNb<nbBlocks; blockNb++) {
+        const blockParam_t* const block = blockTable + blockNb;
+        const Lizard_profile_t* profile;
+        if (!Lizard_compress_advanced(ctx, block->srcPtr, block->cPtr, (int)block->srcSize, (int)block->cRoom, cLevel, g_cParams))
+            EXM_THROW(3, "Lizard_compress_advanced() failed on block %u", blockNb);
+        profile = Lizard_getProfile(ctx);   /* reset by each compression */
+        for (phase=0; phase<Lizard_phase_count; phase++) { cycles[phase] += profile->cycles[phase]; calls[phase] += profile->calls[phase]; }
+    }
+    free(ctx);
+
+    for (phase=0; phase<Lizard_phase_total; phase++) {
+        if (calls[phase] == 0) continue;
+        DISPLAY("%2i# %-13s : %5.1f%% %12llu cycles %10llu calls %8.1f cycles/call \n", cLevel, phaseNames[phase],
+                100. * cycles[phase] / (cycles[Lizard_phase_total] + !cycles[Lizard_phase_total]), cycles[phase], calls[phase], (double)cycles[phase] / calls[phase]);
+    }
+    DISPLAY("%2i# %-13s : %5.1f%% %12llu cycles \n", cLevel, "total", 100., cycles[Lizard_phase_total]);
+}
 
 
 static int BMK_benchMem(const void* srcBuffer, size_t srcSize,
                         const char* displayName, int cLevel,
                         const size_t* fileSizes, U32 nbFiles)
 {
-    size_t const blockSize = (g_blockSize>=32 ? g_blockSize : srcSize) + (!srcSize) /* avoid div by 0 */ ;
+    size_t const defaultBlockSize = (g_nbThreads > 1) ? MIN(srcSize, MT_BLOCKSIZE) : srcSize;   /* blocks are processed in parallel */
+    size_t const blockSize = (g_blockSize>=32 ? g_blockSize : defaultBlockSize) + (!srcSize) /* avoid div by 0 */ ;
     U32 const maxNbBlocks = (U32) ((srcSize + (blockSize-1)) / blockSize) + nbFiles;
     blockParam_t* const blockTable = (blockParam_t*) malloc(maxNbBlocks * sizeof(blockParam_t));
     size_t const maxCompressedSize = Lizard_compressBound((int)srcSize) + (maxNbBlocks * 1024);   /* add some room for safety */
@@ -160,42 +583,40 @@ static int BMK_benchMem(const void* srcBuffer, size_t srcSize,
     void* const resultBuffer = malloc(srcSize);
     U32 nbBlocks;
     UTIL_time_t ticksPerSecond;
+    TPOOL_ctx* const pool = TPOOL_create(g_nbThreads > 1 ? g_nbThreads : 0, g_nbThreads);
+    BMK_job_t* const jobs = (BMK_job_t*) malloc(g_nbThreads * sizeof(BMK_job_t));
+    void* const evictionBuffer = g_coldCacheSize ? calloc(1, g_coldCacheSize) : NULL;
+    BMK_result_t result;
 
     /* checks */
-    if (!compressedBuffer || !resultBuffer || !blockTable)
+    if (!compressedBuffer || !resultBuffer || !blockTable || !pool || !jobs || (g_coldCacheSize && !evictionBuffer))
         EXM_THROW(31, "allocation error : not enough memory");
 
     /* init */
+    result.name = displayName;
     if (strlen(displayName)>17) displayName += strlen(displayName)-17;   /* can only display 17 characters */
     UTIL_initTimer(&ticksPerSecond);
 
     /* Init blockTable data */
-    {   const char* srcPtr = (const char*)srcBuffer;
-        char* cPtr = (char*)compressedBuffer;
-        char* resPtr = (char*)resultBuffer;
-        U32 fileNb;
-        for (nbBlocks=0, fileNb=0; fileNb<nbFiles; fileNb++) {
-            size_t remaining = fileSizes[fileNb];
-            U32 const nbBlocksforThisFile = (U32)((remaining + (blockSize-1)) / blockSize);
-            U32 const blockEnd = nbBlocks + nbBlocksforThisFile;
-            for ( ; nbBlocks<blockEnd; nbBlocks++) {
-                size_t const thisBlockSize = MIN(remaining, blockSize);
-                blockTable[nbBlocks].srcPtr = srcPtr;
-                blockTable[nbBlocks].cPtr = cPtr;
-                blockTable[nbBlocks].resPtr = resPtr;
-                blockTable[nbBlocks].srcSize = thisBlockSize;
-                blockTable[nbBlocks].cRoom = Lizard_compressBound((int)thisBlockSize);
-                srcPtr += thisBlockSize;
-                cPtr += blockTable[nbBlocks].cRoom;
-                resPtr += thisBlockSize;
-                remaining -= thisBlockSize;
-    }   }   }
+    nbBlocks = BMK_initBlockTable(blockTable, srcBuffer, compressedBuffer, resultBuffer, blockSize, fileSizes, nbFiles);
+
+    /* Init jobs */
+    {   U32 t;
+        for (t=0; t<g_nbThreads; t++) {
+            jobs[t].blockTable = blockTable;
+            jobs[t].firstBlock = t;
+            jobs[t].nbBlocks = nbBlocks;
+            jobs[t].step = g_nbThreads;
+            jobs[t].cLevel = cLevel;
+            BMK_initJobState(jobs+t);
+    }   }
 
     /* warmimg up memory */
     RDG_genBuffer(compressedBuffer, maxCompressedSize, 0.10, 0.50, 1);
 
     /* Bench */
-    {   U64 fastestC = (U64)(-1LL), fastestD = (U64)(-1LL);
+    {   double fastestC = 1e300, fastestD = 1e300;   /* microseconds per pass */
+        BMK_samples_t cSamples, dSamples;
         U64 const crcOrig = XXH64(srcBuffer, srcSize, 0);
         UTIL_time_t coolTime;
         U64 const maxTime = (g_nbSeconds * TIMELOOP_MICROSEC) + 100;
@@ -207,6 +628,8 @@ static int BMK_benchMem(const void* srcBuffer, size_t srcSize,
         size_t cSize = 0;
         double ratio = 0.;
 
+        memset(&cSamples, 0, sizeof(cSamples));
+        memset(&dSamples, 0, sizeof(dSamples));
         UTIL_getTime(&coolTime);
         DISPLAYLEVEL(2, "\r%79s\r", "");
         while (!cCompleted | !dCompleted) {
@@ -229,21 +652,25 @@ static int BMK_benchMem(const void* srcBuffer, size_t srcSize,
             UTIL_getTime(&clockStart);
 
             if (!cCompleted) {   /* still some time to do compression tests */
-                U32 nbLoops = 0;
-                do {
-                    U32 blockNb;
-                    for (blockNb=0; blockNb<nbBlocks; blockNb++) {
-                        size_t const rSize = Lizard_compress(blockTable[blockNb].srcPtr, blockTable[blockNb].cPtr, (int)blockTable[blockNb].srcSize, (int)blockTable[blockNb].cRoom, cLevel);
-                        if (Lizard_isError(rSize)) EXM_THROW(1, "Lizard_compress() failed");
-                        blockTable[blockNb].cSize = rSize;
+                if (g_nbRepeats && BMK_runJobs(pool, jobs, BMK_compressJob)) EXM_THROW(1, "Lizard_compress() failed");   /* warm up */
+                UTIL_getTime(&clockStart);
+                do {   /* one sample : a single pass with --repeat or --cold, otherwise as many passes as fit in SAMPLE_MICROSEC */
+                    UTIL_time_t sampleStart;
+                    U32 nbLoops = 0;
+                    if (evictionBuffer) BMK_evictCaches(evictionBuffer, g_coldCacheSize);
+                    UTIL_getTime(&sampleStart);
+                    do {
+                        if (BMK_runJobs(pool, jobs, BMK_compressJob)) EXM_THROW(1, "Lizard_compress() failed");
+                        nbLoops++;
+                    } while (!g_nbRepeats && !evictionBuffer && (UTIL_clockSpanMicro(sampleStart, ticksPerSecond) < SAMPLE_MICROSEC));
+                    {   double const micro = (double)UTIL_clockSpanNano(sampleStart, ticksPerSecond) / 1000 / nbLoops;
+                        BMK_addSample(&cSamples, micro);
+                        if (micro < fastestC) fastestC = micro;
                     }
-                    nbLoops++;
-                } while (UTIL_clockSpanMicro(clockStart, ticksPerSecond) < clockLoop);
-                {   U64 const clockSpan = UTIL_clockSpanMicro(clockStart, ticksPerSecond);
-                    if (clockSpan < fastestC*nbLoops) fastestC = clockSpan / nbLoops;
-                    totalCTime += clockSpan;
-                    cCompleted = totalCTime>maxTime;
-            }   }
+                } while (g_nbRepeats ? (cSamples.nb < g_nbRepeats) : (UTIL_clockSpanMicro(clockStart, ticksPerSecond) < clockLoop));
+                totalCTime += UTIL_clockSpanMicro(clockStart, ticksPerSecond);
+                cCompleted = g_nbRepeats || (totalCTime>maxTime);
+            }
 
             cSize = 0;
             { U32 blockNb; for (blockNb=0; blockNb<nbBlocks; blockNb++) cSize += blockTable[blockNb].cSize; }
@@ -264,26 +691,26 @@ static int BMK_benchMem(const void* srcBuffer, size_t srcSize,
             UTIL_getTime(&clockStart);
 
             if (!dCompleted) {
-                U32 nbLoops = 0;
-                do {
-                    U32 blockNb;
-                    for (blockNb=0; blockNb<nbBlocks; blockNb++) {
-                        size_t const regenSize = Lizard_decompress_safe(blockTable[blockNb].cPtr, blockTable[blockNb].resPtr, (int)blockTable[blockNb].cSize, (int)blockTable[blockNb].srcSize);
-                        if (Lizard_isError(regenSize)) {
-                            DISPLAY("Lizard_decompress_safe() failed on block %u  \n", blockNb);
-                            clockLoop = 0;   /* force immediate test end */
-                            break;
-                        }
-
-                        blockTable[blockNb].resSize = regenSize;
+                int error = g_nbRepeats && BMK_runJobs(pool, jobs, BMK_decompressJob);   /* warm up */
+                UTIL_getTime(&clockStart);
+                while (!error) {
+                    UTIL_time_t sampleStart;
+                    U32 nbLoops = 0;
+                    if (evictionBuffer) BMK_evictCaches(evictionBuffer, g_coldCacheSize);
+                    UTIL_getTime(&sampleStart);
+                    do {
+                        error = BMK_runJobs(pool, jobs, BMK_decompressJob);   /* detected by CRC checking */
+                        nbLoops++;
+                    } while (!error && !g_nbRepeats && !evictionBuffer && (UTIL_clockSpanMicro(sampleStart, ticksPerSecond) < SAMPLE_MICROSEC));
+                    {   double const micro = (double)UTIL_clockSpanNano(sampleStart, ticksPerSecond) / 1000 / nbLoops;
+                        BMK_addSample(&dSamples, micro);
+                        if (micro < fastestD) fastestD = micro;
                     }
-                    nbLoops++;
-                } while (UTIL_clockSpanMicro(clockStart, ticksPerSecond) < DECOMP_MULT*clockLoop);
-                {   U64 const clockSpan = UTIL_clockSpanMicro(clockStart, ticksPerSecond);
-                    if (clockSpan < fastestD*nbLoops) fastestD = clockSpan / nbLoops;
-                    totalDTime += clockSpan;
-                    dCompleted = totalDTime>(DECOMP_MULT*maxTime);
-            }   }
+                    if (g_nbRepeats ? (dSamples.nb >= g_nbRepeats) : (UTIL_clockSpanMicro(clockStart, ticksPerSecond) >= DECOMP_MULT*clockLoop)) break;
+                }
+                totalDTime += UTIL_clockSpanMicro(clockStart, ticksPerSecond);
+                dCompleted = g_nbRepeats || (totalDTime>(DECOMP_MULT*maxTime));
+            }
 
             markNb = (markNb+1) % NB_MARKS;
             DISPLAYLEVEL(2, "%2s-%-17.17s :%10u ->%10u (%5.3f),%6.1f MB/s ,%6.1f MB/s\r",
@@ -318,7 +745,7 @@ static int BMK_benchMem(const void* srcBuffer, size_t srcSize,
 #endif
         }   /* for (testNb = 1; testNb <= (g_nbSeconds + !g_nbSeconds); testNb++) */
 
-        if (g_displayLevel == 1) {
+        if (g_displayLevel == 1 && !g_tuneBudget) {   /* tune mode displays its own results */
             double cSpeed = (double)srcSize / fastestC;
             double dSpeed = (double)srcSize / fastestD;
             if (g_additionalParam)
@@ -326,17 +753,704 @@ static int BMK_benchMem(const void* srcBuffer, size_t srcSize,
             else
                 DISPLAY("-%-3i%11i (%5.3f) %6.2f MB/s %6.1f MB/s  %s\n", cLevel, (int)cSize, ratio, cSpeed, dSpeed, displayName);
         }
-        DISPLAYLEVEL(2, "%2i#\n", cLevel);
+        {   double cMedian, cStddev, dMedian, dStddev;
+            BMK_sampleStats(&cSamples, &cMedian, &cStddev);
+            BMK_sampleStats(&dSamples, &dMedian, &dStddev);
+            DISPLAYLEVEL(2, "%2i# median %6.1f MB/s ,%6.1f MB/s , stddev %4.1f%% ,%4.1f%% (%u ,%u runs) \n", cLevel,
+                    (double)srcSize / cMedian, (double)srcSize / dMedian, cStddev*100, dStddev*100, cSamples.nb, dSamples.nb);
+
+            result.cLevel = cLevel;
+            result.blockSize = blockSize;
+            result.nbThreads = g_nbThreads;
+            result.srcSize = srcSize;
+            result.cSize = cSize;
+            result.cSpeed = (double)srcSize / fastestC;
+            result.cMedian = (double)srcSize / cMedian;
+            result.cStddev = cStddev;
+            result.dSpeed = (double)srcSize / fastestD;
+            result.dMedian = (double)srcSize / dMedian;
+            result.dStddev = dStddev;
+            result.cRuns = cSamples.nb;
+            result.dRuns = dSamples.nb;
+            result.contextSize = (U64)Lizard_sizeofState_advanced(cLevel, g_cParams);
+            result.cParams = g_cParams;
+            result.memory = (U64)srcSize*2 + maxCompressedSize + (U64)g_nbThreads * g_nbContexts * result.contextSize;
+            BMK_outputResult(&result);
+            if (g_sweepResults) g_sweepResults[g_nbSweepResults++] = result;
+            DISPLAYLEVEL(2, "%2i# context %u KB%s, bench memory %u MB, peak RSS %u MB \n", cLevel, (U32)(result.contextSize >> 10),
+                    g_reuseContext ? (g_nbContexts > 1 ? " (cycling)" : " (reused)") : BMK_overridesParams() ? " (reused, parameters overridden)" : " (allocated per block)",
+                    (U32)(result.memory >> 20), (U32)(UTIL_getPeakMemory() >> 20));
+        }
+        if (g_displayLevel >= 3) {
+            BMK_displayBlockStats(blockTable, nbBlocks, cLevel);
+            BMK_displayProfile(blockTable, nbBlocks, cLevel);
+        }
+        if (g_nbThreads > 1) {
+            DISPLAYLEVEL(2, "%2i# %u threads : per thread %6.1f MB/s ,%6.1f MB/s \n", cLevel, g_nbThreads,
+                    (double)srcSize / fastestC / g_nbThreads, (double)srcSize / fastestD / g_nbThreads);
+        }
+        free(cSamples.micro);
+        free(dSamples.micro);
     }   /* Bench */
 
     /* clean up */
+    TPOOL_free(pool);
+    {   U32 t; for (t=0; t<g_nbThreads; t++) free(jobs[t].cState); }
+    free(jobs);
     free(blockTable);
     free(compressedBuffer);
     free(resultBuffer);
+    free(evictionBuffer);
+    return 0;
+}
+
+
+
+/* ********************************************************
+*  Scaling bench : throughput of 1 to nbThreads threads
+**********************************************************/
+/* each thread (de)compresses all blocks of its input, again and again during `periodMicro`,
+   writing into its own buffers; input is either shared (read-only) or a private copy */
+typedef struct {
+    BMK_job_t job;          /* all blocks, by a single thread */
+    size_t srcSize;
+    void* privateSrc;       /* NULL when input is shared */
+    void* compressedBuffer;
+    void* resultBuffer;
+    unsigned core;          /* pinned core, with g_pinThreads */
+    U64 periodMicro;
+    UTIL_time_t ticksPerSecond;
+    U64 bytes;              /* processed during last period ... */
+    U64 micro;              /* ... and its duration */
+} BMK_thread_t;
+
+static void BMK_pinThread(unsigned core)
+{
+#if BMK_PIN_THREADS
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core % CPU_SETSIZE, &set);
+    if (sched_setaffinity(0, sizeof(set), &set)) DISPLAYLEVEL(2, "Warning : can't pin thread to core %u \n", core);
+#else
+    (void)core;
+#endif
+}
+
+static void BMK_runPeriod(BMK_thread_t* thread, TPOOL_function function)
+{
+    UTIL_time_t clockStart;
+    if (g_pinThreads) BMK_pinThread(thread->core);
+    thread->bytes = 0;
+    UTIL_getTime(&clockStart);
+    do {
+        function(&thread->job);
+        if (thread->job.error) return;
+        thread->bytes += thread->srcSize;
+    } while (UTIL_clockSpanMicro(clockStart, thread->ticksPerSecond) < thread->periodMicro);
+    thread->micro = UTIL_clockSpanMicro(clockStart, thread->ticksPerSecond);
+    thread->micro += !thread->micro;   /* avoid div by 0 */
+}
+
+static void BMK_scalingCompressJob(void* opaque) { BMK_runPeriod((BMK_thread_t*)opaque, BMK_compressJob); }
+
+static void BMK_scalingDecompressJob(void* opaque) { BMK_runPeriod((BMK_thread_t*)opaque, BMK_decompressJob); }
+
+/* runs `function` on `nbThreads` threads; returns 0 if all succeeded,
+   and aggregate, min and max per thread speeds, in MB/s, and stddev of per thread speeds, relative to their mean */
+static int BMK_runScaling(BMK_thread_t* threads, unsigned nbThreads, TPOOL_function function,
+                          double* aggregate, double* minSpeed, double* maxSpeed, double* stddev)
+{
+    TPOOL_ctx* const pool = TPOOL_create(nbThreads, nbThreads);
+    unsigned t;
+    int error = 0;
+    if (!pool) EXM_THROW(32, "can't create %u threads", nbThreads);
+    for (t=0; t<nbThreads; t++) {
+        threads[t].job.error = 0;
+        TPOOL_add(pool, function, threads+t);
+    }
+    TPOOL_free(pool);   /* waits for all jobs */
+    *aggregate = 0.; *minSpeed = 1e300; *maxSpeed = 0.;
+    for (t=0; t<nbThreads; t++) {
+        double const speed = (double)threads[t].bytes / threads[t].micro;   /* MB/s */
+        error |= threads[t].job.error;
+        *aggregate += speed;
+        if (speed < *minSpeed) *minSpeed = speed;
+        if (speed > *maxSpeed) *maxSpeed = speed;
+    }
+    {   double const mean = *aggregate / nbThreads;
+        double var = 0.;
+        for (t=0; t<nbThreads; t++) {
+            double const speed = (double)threads[t].bytes / threads[t].micro;
+            var += (speed - mean) * (speed - mean);
+        }
+        *stddev = BMK_sqrt(var / nbThreads) / mean;
+    }
+    return error;
+}
+
+/*! BMK_benchScaling() :
+ *  measures 1, 2, 4 ... up to g_nbThreads threads, each processing the whole input,
+ *  and reports aggregate and per thread speeds, and efficiency versus 1 thread */
+static int BMK_benchScaling(const void* srcBuffer, size_t srcSize,
+                            const char* displayName, int cLevel,
+                            const size_t* fileSizes, U32 nbFiles)
+{
+    size_t const blockSize = (g_blockSize>=32 ? g_blockSize : MIN(srcSize, MT_BLOCKSIZE)) + (!srcSize);   /* same blocks for any nb of threads */
+    U32 const maxNbBlocks = (U32) ((srcSize + (blockSize-1)) / blockSize) + nbFiles;
+    size_t const maxCompressedSize = Lizard_compressBound((int)srcSize) + (maxNbBlocks * 1024);
+    U64 const crcOrig = XXH64(srcBuffer, srcSize, 0);
+    BMK_thread_t* const threads = (BMK_thread_t*) calloc(g_nbThreads, sizeof(BMK_thread_t));
+    UTIL_time_t ticksPerSecond;
+    int const nbCores = UTIL_countCores();
+    double cRef = 0., dRef = 0.;
+    unsigned nbThreads, t;
+    BMK_result_t result;
+
+    if (!threads) EXM_THROW(31, "allocation error : not enough memory");
+    memset(&result, 0, sizeof(result));
+    result.name = displayName;
+    result.cLevel = cLevel;
+    result.blockSize = blockSize;
+    result.srcSize = srcSize;
+    if (strlen(displayName)>17) displayName += strlen(displayName)-17;   /* can only display 17 characters */
+    UTIL_initTimer(&ticksPerSecond);
+
+    /* per thread buffers */
+    for (t=0; t<g_nbThreads; t++) {
+        BMK_thread_t* const thread = threads + t;
+        const void* src = srcBuffer;
+        thread->job.blockTable = (blockParam_t*) malloc(maxNbBlocks * sizeof(blockParam_t));
+        thread->compressedBuffer = malloc(maxCompressedSize);
+        thread->resultBuffer = malloc(srcSize + !srcSize);
+        if (g_privateInputs) {
+            thread->privateSrc = malloc(srcSize + !srcSize);
+            if (thread->privateSrc) memcpy(thread->privateSrc, srcBuffer, srcSize);
+            src = thread->privateSrc;
+        }
+        if (!thread->job.blockTable || !thread->compressedBuffer || !thread->resultBuffer || !src)
+            EXM_THROW(31, "allocation error : not enough memory for %u threads", g_nbThreads);
+        thread->job.nbBlocks = BMK_initBlockTable(thread->job.blockTable, src, thread->compressedBuffer, thread->resultBuffer,
+                                                  blockSize, fileSizes, nbFiles);
+        thread->job.step = 1;
+        thread->job.cLevel = cLevel;
+        BMK_initJobState(&thread->job);
+        thread->srcSize = srcSize;
+        thread->core = (unsigned)t % (unsigned)nbCores;
+        thread->periodMicro = g_nbSeconds * TIMELOOP_MICROSEC;
+        thread->ticksPerSecond = ticksPerSecond;
+        RDG_genBuffer(thread->compressedBuffer, maxCompressedSize, 0.10, 0.50, 1);   /* warm up memory */
+    }
+
+    DISPLAYLEVEL(2, "\r%79s\r", "");
+    DISPLAYLEVEL(2, "%2i#%-17.17s : %s inputs%s, %u KB blocks, aggregate (per thread min-max, efficiency) \n", cLevel, displayName,
+                 g_privateInputs ? "private" : "shared", g_pinThreads ? ", pinned threads" : "", (U32)(blockSize>>10));
+    for (nbThreads=1; ; nbThreads = MIN(nbThreads*2, g_nbThreads)) {   /* 1, 2, 4 ... g_nbThreads */
+        double cSpeed, cMin, cMax, cStddev, dSpeed, dMin, dMax, dStddev;
+        size_t cSize = 0;
+        U32 blockNb;
+
+        DISPLAYLEVEL(2, "%3u threads : compressing...\r", nbThreads);
+        if (BMK_runScaling(threads, nbThreads, BMK_scalingCompressJob, &cSpeed, &cMin, &cMax, &cStddev)) EXM_THROW(1, "Lizard_compress() failed");
+        for (blockNb=0; blockNb<threads[0].job.nbBlocks; blockNb++) cSize += threads[0].job.blockTable[blockNb].cSize;
+        cSize += !cSize;  /* avoid div by 0 */
+
+        DISPLAYLEVEL(2, "%3u threads : decompressing...\r", nbThreads);
+        for (t=0; t<nbThreads; t++) memset(threads[t].resultBuffer, 0xD6, srcSize);
+        if (BMK_runScaling(threads, nbThreads, BMK_scalingDecompressJob, &dSpeed, &dMin, &dMax, &dStddev)) EXM_THROW(2, "Lizard_decompress_safe() failed");
+        for (t=0; t<nbThreads; t++)
+            if (XXH64(threads[t].resultBuffer, srcSize, 0) != crcOrig) EXM_THROW(3, "Invalid checksum of thread %u", t);
+
+        if (nbThreads == 1) { cRef = cSpeed; dRef = dSpeed; }
+        DISPLAYLEVEL(1, "-%-3i%3u threads %11i (%5.3f) %8.1f MB/s (%6.1f-%6.1f, %5.1f%%) %8.1f MB/s (%6.1f-%6.1f, %5.1f%%)  %s\n",
+                     cLevel, nbThreads, (int)cSize, (double)srcSize / cSize,
+                     cSpeed, cMin, cMax, cSpeed / (cRef * nbThreads) * 100,
+                     dSpeed, dMin, dMax, dSpeed / (dRef * nbThreads) * 100, displayName);
+
+        result.nbThreads = nbThreads;
+        result.cSize = cSize;
+        result.cRuns = result.dRuns = nbThreads;   /* one period per thread */
+        result.cSpeed = result.cMedian = cSpeed;   /* aggregate ; stddev is between threads */
+        result.cStddev = cStddev;
+        result.dSpeed = result.dMedian = dSpeed;
+        result.dStddev = dStddev;
+        result.contextSize = (U64)Lizard_sizeofState(cLevel);
+        result.memory = (U64)nbThreads * ((g_privateInputs ? srcSize*2 : srcSize) + maxCompressedSize + g_nbContexts * result.contextSize);
+        BMK_outputResult(&result);
+        if (nbThreads == g_nbThreads) break;
+    }
+
+    /* clean up */
+    for (t=0; t<g_nbThreads; t++) {
+        free(threads[t].job.blockTable);
+        free(threads[t].compressedBuffer);
+        free(threads[t].resultBuffer);
+        free(threads[t].privateSrc);
+        free(threads[t].job.cState);
+    }
+    free(threads);
+    return 0;
+}
+
+/* ********************************************************
+*  Latency bench : many independent small messages
+**********************************************************/
+/* latencies of single messages, in nanoseconds */
+typedef struct {
+    U64* ns;
+    size_t nb;
+} BMK_latencies_t;
+
+static int BMK_cmpU64(const void* a, const void* b)
+{
+    U64 const x = *(const U64*)a, y = *(const U64*)b;
+    return (x > y) - (x < y);
+}
+
+/* sorts latencies; returns percentile `p` (0-1), in microseconds */
+static double BMK_percentile(const BMK_latencies_t* lat, double p)
+{
+    if (lat->nb == 0) return 0.;
+    return (double)lat->ns[(size_t)(p * (double)(lat->nb-1))] / 1000;
+}
+
+/* displays count of latencies per power of 2 of nanoseconds, on one line */
+static void BMK_displayHistogram(const char* name, const BMK_latencies_t* lat)
+{
+    size_t counts[64] = { 0 };
+    size_t n;
+    U32 b;
+    for (n=0; n<lat->nb; n++) counts[lat->ns[n] ? Lizard_highbit32((U32)MIN(lat->ns[n], 0xFFFFFFFFU)) : 0]++;
+    DISPLAY("    %s histogram :", name);
+    for (b=0; b<64; b++)
+        if (counts[b]) DISPLAY(" <%.2fus:%u", (double)((U64)2 << b) / 1000, (U32)counts[b]);
+    DISPLAY("\n");
+}
+
+typedef struct {
+    const char* src;        /* messages, one after another */
+    size_t msgSize;
+    size_t nbMessages;
+    char* cBuffer;          /* each message has Lizard_compressBound(msgSize) bytes */
+    int* cSizes;
+    char* resBuffer;
+    void* cState;           /* without dictionary : Lizard_compress_extState() */
+    Lizard_stream_t* stream;   /* with dictionary : Lizard_loadDict(), then Lizard_compress_continue() */
+    const char* dict;       /* NULL : no dictionary */
+    int dictSize;
+    int cLevel;
+} BMK_messages_t;
+
+/* (de)compresses messages one at a time, again and again until `periodMicro` or `nbPasses`,
+   recording latency of each message into `lat`.
+   return : nb of messages processed at least once (first pass can be cut by `periodMicro`) */
+static size_t BMK_timeMessages(BMK_messages_t* m, int decompress, U64 periodMicro, U32 nbPasses, BMK_latencies_t* lat)
+{
+    int const cRoom = Lizard_compressBound((int)m->msgSize);
+    UTIL_time_t ticksPerSecond, clockStart;
+    size_t nbProcessed = 0;
+    U32 pass;
+    UTIL_initTimer(&ticksPerSecond);
+    UTIL_getTime(&clockStart);
+    lat->nb = 0;
+    for (pass=0; ; pass++) {
+        size_t n;
+        for (n=0; (n<m->nbMessages) && (lat->nb<LATENCY_MAX_SAMPLES); n++) {
+            const char* const src = m->src + n * m->msgSize;
+            char* const cPtr = m->cBuffer + n * cRoom;
+            char* const resPtr = m->resBuffer + n * m->msgSize;
+            UTIL_time_t start, end;
+            int result;
+            UTIL_getTime(&start);
+            if (!decompress) {
+                if (m->dict) {
+                    Lizard_loadDict(m->stream, m->dict, m->dictSize);
+                    result = Lizard_compress_continue(m->stream, src, cPtr, (int)m->msgSize, cRoom);
+                } else {
+                    result = Lizard_compress_extState(m->cState, src, cPtr, (int)m->msgSize, cRoom, m->cLevel);
+                }
+                m->cSizes[n] = result;
+            } else {
+                result = m->dict ? Lizard_decompress_safe_usingDict(cPtr, resPtr, m->cSizes[n], (int)m->msgSize, m->dict, m->dictSize)
+                                 : Lizard_decompress_safe(cPtr, resPtr, m->cSizes[n], (int)m->msgSize);
+            }
+            UTIL_getTime(&end);
+            if (decompress ? (result != (int)m->msgSize) : (result <= 0))
+                EXM_THROW(3, "%s failed on message %u", decompress ? "Lizard_decompress_safe()" : "Lizard_compress()", (U32)n);
+            lat->ns[lat->nb++] = UTIL_getSpanTimeNano(ticksPerSecond, start, end);
+            if (n >= nbProcessed) nbProcessed = n+1;
+            if (!nbPasses && (UTIL_getSpanTimeNano(ticksPerSecond, clockStart, end) >= periodMicro * 1000)) break;
+        }
+        if ((lat->nb >= LATENCY_MAX_SAMPLES) || (n < m->nbMessages)) break;
+        if (nbPasses ? (pass+1 >= nbPasses) : (UTIL_clockSpanMicro(clockStart, ticksPerSecond) >= periodMicro)) break;
+    }
+    qsort(lat->ns, lat->nb, sizeof(U64), BMK_cmpU64);
+    return nbProcessed;
+}
+
+/*! BMK_benchLatency() :
+ *  for each message size, cuts input into independent messages, and measures latency of each one,
+ *  compressed with a reused context, then with a dictionary loaded before each message */
+static int BMK_benchLatency(const void* srcBuffer, size_t srcSize, const char* displayName, int cLevel)
+{
+    void* dictBuffer = NULL;
+    const char* dict = (const char*)srcBuffer;
+    size_t dictSize = MIN(LATENCY_DICTSIZE, srcSize/2);   /* beginning of input, when no dictionary file */
+    const char* msgArea;
+    size_t msgAreaSize;
+    BMK_latencies_t cLat, dLat;
+    BMK_messages_t m;
+    U64 const periodMicro = g_nbSeconds * TIMELOOP_MICROSEC / 2;
+    unsigned sizeNb;
+    int withDict;
+
+    /* dictionary */
+    if (g_dictFileName) {
+        U64 const fileSize = UTIL_getFileSize(g_dictFileName);
+        FILE* const f = fopen(g_dictFileName, "rb");
+        if (f==NULL) EXM_THROW(10, "impossible to open dictionary %s", g_dictFileName);
+        dictSize = (size_t)MIN(fileSize, LIZARD_DICT_SIZE);   /* only the end of larger dictionaries is used */
+        dictBuffer = malloc(dictSize + !dictSize);
+        if (!dictBuffer) EXM_THROW(12, "not enough memory for dictionary");
+        if (fseek(f, (long)(fileSize - dictSize), SEEK_SET) || (fread(dictBuffer, 1, dictSize, f) != dictSize))
+            EXM_THROW(11, "could not read dictionary %s", g_dictFileName);
+        fclose(f);
+        dict = (const char*)dictBuffer;
+        msgArea = (const char*)srcBuffer;
+        msgAreaSize = srcSize;
+    } else {
+        msgArea = (const char*)srcBuffer + dictSize;
+        msgAreaSize = srcSize - dictSize;
+    }
+    if (msgAreaSize > LATENCY_MAX_INPUT) msgAreaSize = LATENCY_MAX_INPUT;
+    if (msgAreaSize == 0) EXM_THROW(12, "input too small for latency bench");
+
+    memset(&m, 0, sizeof(m));
+    m.cLevel = cLevel;
+    m.cState = malloc((size_t)Lizard_sizeofState(cLevel));
+    m.stream = Lizard_createStream(cLevel);
+    cLat.ns = (U64*)malloc(LATENCY_MAX_SAMPLES * sizeof(U64));
+    dLat.ns = (U64*)malloc(LATENCY_MAX_SAMPLES * sizeof(U64));
+    if (!m.cState || !m.stream || !cLat.ns || !dLat.ns) EXM_THROW(31, "allocation error : not enough memory");
+
+    DISPLAYLEVEL(2, "\r%79s\r", "");
+    for (sizeNb=0; sizeNb<g_nbMessageSizes; sizeNb++) {
+        m.msgSize = MIN(g_messageSizes[sizeNb], msgAreaSize);
+        m.nbMessages = msgAreaSize / m.msgSize;
+        m.src = msgArea;
+        m.cBuffer = (char*)malloc(m.nbMessages * (size_t)Lizard_compressBound((int)m.msgSize));
+        m.cSizes = (int*)malloc(m.nbMessages * sizeof(int));
+        m.resBuffer = (char*)malloc(m.nbMessages * m.msgSize);
+        if (!m.cBuffer || !m.cSizes || !m.resBuffer) EXM_THROW(31, "allocation error : not enough memory");
+
+        for (withDict=0; withDict<=1; withDict++) {
+            size_t cSize = 0, n;
+            m.dict = withDict ? dict : NULL;
+            m.dictSize = (int)dictSize;
+
+            DISPLAYLEVEL(2, "%2i#%6u B %s : compressing...\r", cLevel, (U32)m.msgSize, withDict ? "dict  " : "nodict");
+            m.nbMessages = msgAreaSize / m.msgSize;
+            m.nbMessages = BMK_timeMessages(&m, 0, periodMicro, g_nbRepeats, &cLat);   /* only compressed ones are decompressed */
+            for (n=0; n<m.nbMessages; n++) cSize += (size_t)m.cSizes[n];
+
+            DISPLAYLEVEL(2, "%2i#%6u B %s : decompressing...\r", cLevel, (U32)m.msgSize, withDict ? "dict  " : "nodict");
+            memset(m.resBuffer, 0xD6, m.nbMessages * m.msgSize);
+            {   size_t const nbDecoded = BMK_timeMessages(&m, 1, periodMicro, g_nbRepeats, &dLat);   /* first pass can be cut too */
+                if (memcmp(m.resBuffer, m.src, nbDecoded * m.msgSize)) EXM_THROW(3, "Invalid decompressed messages");
+            }
+
+            DISPLAYLEVEL(1, "-%-3i%6u B %s (%5.3f) : compression p50 %7.2f p90 %7.2f p99 %7.2f p99.9 %7.2f us, "
+                            "decompression p50 %7.2f p90 %7.2f p99 %7.2f p99.9 %7.2f us  %s\n",
+                         cLevel, (U32)m.msgSize, withDict ? "dict  " : "nodict", (double)(m.nbMessages * m.msgSize) / (cSize + !cSize),
+                         BMK_percentile(&cLat, 0.50), BMK_percentile(&cLat, 0.90), BMK_percentile(&cLat, 0.99), BMK_percentile(&cLat, 0.999),
+                         BMK_percentile(&dLat, 0.50), BMK_percentile(&dLat, 0.90), BMK_percentile(&dLat, 0.99), BMK_percentile(&dLat, 0.999),
+                         displayName);
+            if (g_displayLevel >= 3) {
+                BMK_displayHistogram("compression  ", &cLat);
+                BMK_displayHistogram("decompression", &dLat);
+            }
+        }
+        free(m.cBuffer);
+        free(m.cSizes);
+        free(m.resBuffer);
+    }
+
+    /* clean up */
+    Lizard_freeStream(m.stream);
+    free(m.cState);
+    free(cLat.ns);
+    free(dLat.ns);
+    free(dictBuffer);
     return 0;
 }
 
 
+/* ********************************************************
+*  Sweep : grid of block sizes, levels and parameters
+**********************************************************/
+
+/* `a` dominates `b` when it is as good on ratio, compression and decompression speed, and better on one of them */
+static int BMK_dominates(const BMK_result_t* a, const BMK_result_t* b)
+{
+    double const ratioA = (double)a->srcSize / a->cSize, ratioB = (double)b->srcSize / b->cSize;
+    if (ratioA < ratioB || a->cSpeed < b->cSpeed || a->dSpeed < b->dSpeed) return 0;
+    return (ratioA > ratioB || a->cSpeed > b->cSpeed || a->dSpeed > b->dSpeed);
+}
+
+static int BMK_cmpRatio(const void* a, const void* b)
+{
+    const BMK_result_t* const ra = (const BMK_result_t*)a;
+    const BMK_result_t* const rb = (const BMK_result_t*)b;
+    double const ratioA = (double)ra->srcSize / ra->cSize, ratioB = (double)rb->srcSize / rb->cSize;
+    return (ratioA < ratioB) - (ratioA > ratioB);   /* highest ratio first */
+}
+
+/* displays settings which are not dominated by another one : nothing else is as good on all of ratio and speeds */
+static void BMK_displayPareto(BMK_result_t* results, U32 nbResults)
+{
+    U32 nbPareto = 0, i, j;
+    for (i=0; i<nbResults; i++) {
+        for (j=0; j<nbResults; j++) if (BMK_dominates(results+j, results+i)) break;
+        if (j == nbResults) results[nbPareto++] = results[i];   /* overwritten settings are dominated, hence by a kept one */
+    }
+    qsort(results, nbPareto, sizeof(*results), BMK_cmpRatio);
+
+    DISPLAYLEVEL(1, "Pareto frontier of %s : %u of %u settings \n", results[0].name, nbPareto, nbResults);
+    DISPLAYLEVEL(1, "level  block  hashLog  searchNum   ratio  compression  decompression \n");
+    for (i=0; i<nbPareto; i++) {
+        const BMK_result_t* const r = results + i;
+        char hashLog[16], searchNum[16];
+        if (r->cParams.hashLog) snprintf(hashLog, sizeof(hashLog), "%u", r->cParams.hashLog); else strcpy(hashLog, "-");
+        if (r->cParams.searchNum) snprintf(searchNum, sizeof(searchNum), "%u", r->cParams.searchNum); else strcpy(searchNum, "-");
+        DISPLAYLEVEL(1, "%5i %5u%s %8s %10s %7.3f %7.1f MB/s %9.1f MB/s \n", r->cLevel,
+                     (U32)(r->blockSize >= 1 MB ? r->blockSize >> 20 : r->blockSize >> 10), r->blockSize >= 1 MB ? "M" : "K",
+                     hashLog, searchNum, (double)r->srcSize / r->cSize, r->cSpeed, r->dSpeed);
+    }
+}
+
+/* benchmarks each combination of block size, level [cLevel-cLevelLast], hashLog and searchNum, then displays Pareto frontier */
+static void BMK_benchSweep(const void* srcBuffer, size_t srcSize,
+                           const char* displayName, int cLevel, int cLevelLast,
+                           const size_t* fileSizes, unsigned nbFiles)
+{
+    static const unsigned defaultValue = 0;   /* level default */
+    size_t const blockSize = g_blockSize;
+    unsigned const nbBlockSizes = g_nbSweepValues[BMK_sweep_blockSize] ? g_nbSweepValues[BMK_sweep_blockSize] : 1;
+    unsigned const nbHashLogs = g_nbSweepValues[BMK_sweep_hashLog] ? g_nbSweepValues[BMK_sweep_hashLog] : 1;
+    unsigned const nbSearchNums = g_nbSweepValues[BMK_sweep_searchNum] ? g_nbSweepValues[BMK_sweep_searchNum] : 1;
+    const unsigned* const hashLogs = g_nbSweepValues[BMK_sweep_hashLog] ? g_sweepValues[BMK_sweep_hashLog] : &defaultValue;
+    const unsigned* const searchNums = g_nbSweepValues[BMK_sweep_searchNum] ? g_sweepValues[BMK_sweep_searchNum] : &defaultValue;
+    unsigned b, h, s;
+    int l;
+
+    for (h=0; h<nbHashLogs; h++)
+        if (hashLogs[h] && (hashLogs[h] < LIZARD_HASHLOG_MIN || hashLogs[h] > LIZARD_HASHLOG_MAX))
+            EXM_THROW(1, "hashLog %u out of range [%u-%u]", hashLogs[h], LIZARD_HASHLOG_MIN, LIZARD_HASHLOG_MAX);
+    for (s=0; s<nbSearchNums; s++)
+        if (searchNums[s] > LIZARD_SEARCHNUM_MAX) EXM_THROW(1, "searchNum %u larger than %u", searchNums[s], LIZARD_SEARCHNUM_MAX);
+
+    g_sweepResults = (BMK_result_t*)malloc((size_t)nbBlockSizes * (cLevelLast-cLevel+1) * nbHashLogs * nbSearchNums * sizeof(BMK_result_t));
+    if (!g_sweepResults) EXM_THROW(31, "allocation error : not enough memory");
+    g_nbSweepResults = 0;
+
+    for (b=0; b<nbBlockSizes; b++) {
+        if (g_nbSweepValues[BMK_sweep_blockSize]) g_blockSize = g_sweepValues[BMK_sweep_blockSize][b];
+        if (g_blockSize >= 32) DISPLAYLEVEL(2, "using blocks of size %u KB \n", (U32)(g_blockSize>>10));
+        for (l=cLevel; l<=cLevelLast; l++)
+            for (h=0; h<nbHashLogs; h++)
+                for (s=0; s<nbSearchNums; s++) {
+                    g_cParams.hashLog = hashLogs[h];
+                    g_cParams.searchNum = searchNums[s];
+                    if (g_cParams.hashLog || g_cParams.searchNum)
+                        DISPLAYLEVEL(2, "%2i# hashLog %u, searchNum %u \n", l, g_cParams.hashLog, g_cParams.searchNum);
+                    BMK_benchMem(srcBuffer, srcSize, displayName, l, fileSizes, nbFiles);
+    }           }
+    g_blockSize = blockSize;
+    memset(&g_cParams, 0, sizeof(g_cParams));
+
+    if (g_nbSweepResults) BMK_displayPareto(g_sweepResults, g_nbSweepResults);
+    free(g_sweepResults);
+    g_sweepResults = NULL;
+}
+
+
+/* ********************************************************
+*  Tune : coordinate descent over parameters of levels
+**********************************************************/
+typedef enum { BMK_tune_windowLog=0, BMK_tune_contentLog, BMK_tune_hashLog, BMK_tune_searchNum, BMK_tune_searchLength,
+               BMK_tune_sufficientLength, BMK_tune_parser, BMK_tune_count } BMK_tuneParam_e;
+
+static const char* const g_parserNames[Lizard_parser_optimalPriceBT+1] =
+    { "fastSmall", "fast", "fastBig", "noChain", "hashChain", "priceFast", "lowestPrice", "optimalPrice", "optimalPriceBT" };
+
+#define TUNE(p) (1 << BMK_tune_##p)
+#define TUNE_CHAIN (TUNE(windowLog) | TUNE(contentLog) | TUNE(hashLog) | TUNE(searchNum) | TUNE(searchLength))
+static const unsigned g_parserTuneParams[Lizard_parser_optimalPriceBT+1] = {   /* parameters read by each parser */
+    TUNE(windowLog), TUNE(windowLog), TUNE(windowLog) | TUNE(hashLog), TUNE(windowLog) | TUNE(hashLog),
+    TUNE_CHAIN, TUNE(windowLog) | TUNE(hashLog) | TUNE(searchLength),
+    TUNE_CHAIN | TUNE(sufficientLength), TUNE_CHAIN | TUNE(sufficientLength), TUNE_CHAIN | TUNE(sufficientLength) };
+
+typedef struct {
+    int cLevel;
+    Lizard_cParams_t cParams;
+    BMK_result_t result;
+} BMK_setting_t;
+
+static unsigned* BMK_tuneParam(Lizard_cParams_t* cParams, BMK_tuneParam_e param)
+{
+    switch(param)
+    {
+    case BMK_tune_windowLog : return &cParams->windowLog;
+    case BMK_tune_contentLog : return &cParams->contentLog;
+    case BMK_tune_hashLog : return &cParams->hashLog;
+    case BMK_tune_searchNum : return &cParams->searchNum;
+    case BMK_tune_searchLength : return &cParams->searchLength;
+    case BMK_tune_sufficientLength : return &cParams->sufficientLength;
+    case BMK_tune_parser :
+    case BMK_tune_count :
+    default : return &cParams->parser;
+    }
+}
+
+/* settings meeting target speeds are ranked by ratio; others, below 0, by how far from targets they are */
+static double BMK_tuneScore(const BMK_result_t* r)
+{
+    double const cMiss = (g_targetCSpeed > r->cSpeed) ? g_targetCSpeed / r->cSpeed : 1.;
+    double const dMiss = (g_targetDSpeed > r->dSpeed) ? g_targetDSpeed / r->dSpeed : 1.;
+    if (cMiss > 1. || dMiss > 1.) return (cMiss > dMiss) ? -cMiss : -dMiss;
+    return (double)r->srcSize / r->cSize;
+}
+
+static void BMK_displaySetting(U32 displayLevel, const char* prefix, const BMK_setting_t* s)
+{
+    DISPLAYLEVEL(displayLevel, "%s level %i, windowLog %u, contentLog %u, hashLog %u, searchNum %u, searchLength %u, sufficientLength %u, parser %s : "
+                 "ratio %.3f, %.1f MB/s, %.1f MB/s \n", prefix, s->cLevel, s->cParams.windowLog, s->cParams.contentLog, s->cParams.hashLog,
+                 s->cParams.searchNum, s->cParams.searchLength, s->cParams.sufficientLength, g_parserNames[s->cParams.parser-1],
+                 (double)s->result.srcSize / s->result.cSize, s->result.cSpeed, s->result.dSpeed);
+}
+
+typedef struct {
+    const void* srcBuffer;
+    size_t srcSize;
+    const char* displayName;
+    const size_t* fileSizes;
+    unsigned nbFiles;
+    BMK_setting_t* history;   /* settings already benchmarked */
+    U32 nbEvaluated;
+} BMK_tune_t;
+
+/* benchmarks `s` (with all its parameters filled by Lizard_getCParams()), unless it was already, within g_tuneBudget.
+   return : 0 if cParams are invalid for level, or budget is exhausted */
+static int BMK_tuneEvaluate(BMK_tune_t* t, BMK_setting_t* s)
+{
+    U32 const displayLevel = g_displayLevel;
+    U32 u;
+    if (!Lizard_getCParams(s->cLevel, &s->cParams)) return 0;
+    for (u=0; u<t->nbEvaluated; u++)
+        if (t->history[u].cLevel == s->cLevel && !memcmp(&t->history[u].cParams, &s->cParams, sizeof(s->cParams))) {
+            s->result = t->history[u].result;
+            return 1;
+        }
+    if (t->nbEvaluated >= g_tuneBudget) return 0;
+
+    g_cParams = s->cParams;
+    g_sweepResults = &s->result;
+    g_nbSweepResults = 0;
+    g_displayLevel = (displayLevel >= 3) ? displayLevel : 1;   /* bench results of each setting with -v */
+    BMK_benchMem(t->srcBuffer, t->srcSize, t->displayName, s->cLevel, t->fileSizes, t->nbFiles);
+    g_displayLevel = displayLevel;
+    g_sweepResults = NULL;
+    memset(&g_cParams, 0, sizeof(g_cParams));
+    if (!g_nbSweepResults) return 0;
+
+    t->history[t->nbEvaluated++] = *s;
+    BMK_displaySetting(2, "tune :", s);
+    return 1;
+}
+
+/* searches the setting of best ratio meeting target speeds : starts from best level of [cLevel-cLevelLast] with its parameters,
+   then changes one parameter at a time, as long as it improves (coordinate descent), until none does or budget is exhausted */
+static void BMK_benchTune(const void* srcBuffer, size_t srcSize,
+                          const char* displayName, int cLevel, int cLevelLast,
+                          const size_t* fileSizes, unsigned nbFiles)
+{
+    BMK_tune_t t;
+    BMK_setting_t best, start, candidate;
+    int l, improved = 1;
+
+    t.srcBuffer = srcBuffer; t.srcSize = srcSize; t.displayName = displayName;
+    t.fileSizes = fileSizes; t.nbFiles = nbFiles; t.nbEvaluated = 0;
+    t.history = (BMK_setting_t*)malloc(g_tuneBudget * sizeof(BMK_setting_t));
+    if (!t.history) EXM_THROW(31, "allocation error : not enough memory");
+    DISPLAYLEVEL(2, "tune %s : target compression %.0f MB/s, decompression %.0f MB/s, up to %u benchmarks of %u s \n",
+                 displayName, g_targetCSpeed, g_targetDSpeed, g_tuneBudget, g_nbSeconds);
+
+    /* starting point : stock levels */
+    best.cLevel = 0;
+    for (l=cLevel; l<=cLevelLast; l++) {
+        memset(&candidate, 0, sizeof(candidate));
+        candidate.cLevel = l;
+        if (BMK_tuneEvaluate(&t, &candidate) && (!best.cLevel || BMK_tuneScore(&candidate.result) > BMK_tuneScore(&best.result)))
+            best = candidate;
+    }
+    if (!best.cLevel) EXM_THROW(1, "no level could be benchmarked");
+    start = best;
+
+    /* coordinate descent */
+    while (improved && t.nbEvaluated < g_tuneBudget) {
+        int param;
+        improved = 0;
+        for (param=BMK_tune_windowLog; param<BMK_tune_count; param++) {
+            if (param == BMK_tune_parser) {   /* no order : each other parser is tried */
+                unsigned const current = best.cParams.parser;
+                unsigned parser;
+                for (parser=1; parser<=Lizard_parser_optimalPriceBT+1; parser++) {
+                    if (parser == current) continue;
+                    candidate = best;
+                    memset(&candidate.cParams, 0, sizeof(candidate.cParams));   /* defaults of parser, then current parameters it uses */
+                    candidate.cParams.parser = parser;
+                    {   int p;
+                        for (p=BMK_tune_windowLog; p<BMK_tune_parser; p++)
+                            if (g_parserTuneParams[parser-1] & g_parserTuneParams[current-1] & (1 << p))
+                                *BMK_tuneParam(&candidate.cParams, (BMK_tuneParam_e)p) = *BMK_tuneParam(&best.cParams, (BMK_tuneParam_e)p);
+                    }
+                    if (BMK_tuneEvaluate(&t, &candidate) && BMK_tuneScore(&candidate.result) > BMK_tuneScore(&best.result)) {
+                        best = candidate;
+                        improved = 1;
+                    }
+                }
+            } else {
+                int direction;
+                if (!(g_parserTuneParams[best.cParams.parser-1] & (1 << param))) continue;
+                for (direction=1; direction>=-1; direction-=2) {   /* larger, then smaller */
+                    int moved = 0;
+                    while (1) {
+                        unsigned* value;
+                        candidate = best;
+                        value = BMK_tuneParam(&candidate.cParams, (BMK_tuneParam_e)param);
+                        if (param == BMK_tune_searchNum || param == BMK_tune_sufficientLength)
+                            *value = (direction > 0) ? *value * 2 : *value / 2;   /* 0 : invalid */
+                        else
+                            *value += direction;
+                        if (*value == 0 || !BMK_tuneEvaluate(&t, &candidate)) break;
+                        if (BMK_tuneScore(&candidate.result) <= BMK_tuneScore(&best.result)) break;
+                        best = candidate;
+                        improved = moved = 1;
+                    }
+                    if (moved) break;
+    }   }   }   }
+
+    /* result */
+    DISPLAYLEVEL(1, "%s : %s among %u settings : \n", displayName,
+                 BMK_tuneScore(&best.result) < 0 ? "no setting meets target speeds, closest" : "best ratio meeting target speeds", t.nbEvaluated);
+    BMK_displaySetting(1, "tuned :", &best);
+    BMK_displaySetting(1, "start :", &start);
+    DISPLAYLEVEL(1, "Lizard_cParams_t const cParams = { %u, %u, %u, %u, %u, %u, %u };   /* Lizard_compress_advanced(state, src, dst, srcSize, maxDstSize, %i, cParams) */ \n",
+                 best.cParams.hashLog, best.cParams.searchNum, best.cParams.windowLog, best.cParams.contentLog,
+                 best.cParams.searchLength, best.cParams.sufficientLength, best.cParams.parser, best.cLevel);
+    free(t.history);
+}
+
+
 static size_t BMK_findMaxMem(U64 requiredMem)
 {
     size_t step = 64 MB;
@@ -374,14 +1488,37 @@ static void BMK_benchCLevel(void* srcBuffer, size_t benchedSize,
     SET_REALTIME_PRIORITY;
 
     if (g_displayLevel == 1 && !g_additionalParam)
-        DISPLAY("bench %s %s: input %u bytes, %u seconds, %u KB blocks\n", LIZARD_VERSION_STRING, LIZARD_GIT_COMMIT_STRING, (U32)benchedSize, g_nbSeconds, (U32)(g_blockSize>>10));
+        DISPLAY("bench %s %s: input %u bytes, %u seconds, %u KB blocks, %u threads\n", LIZARD_VERSION_STRING, LIZARD_GIT_COMMIT_STRING, (U32)benchedSize, g_nbSeconds, (U32)(g_blockSize>>10), g_nbThreads);
 
     if (cLevelLast < cLevel) cLevelLast = cLevel;
 
+    if (g_tuneBudget) {
+        BMK_benchTune(srcBuffer, benchedSize, displayName, cLevel, cLevelLast, fileSizes, nbFiles);
+        return;
+    }
+
+    if (g_nbSweepValues[BMK_sweep_blockSize] || g_nbSweepValues[BMK_sweep_hashLog] || g_nbSweepValues[BMK_sweep_searchNum]) {
+        BMK_benchSweep(srcBuffer, benchedSize, displayName, cLevel, cLevelLast, fileSizes, nbFiles);
+        return;
+    }
+
+    /* latency mode times single messages with its own state ; scaling mode measures periods of many passes */
+    if (g_nbMessageSizes && (g_coldCacheSize || (g_nbContexts > 1)))
+        EXM_THROW(14, "--cold and --contexts can't be combined with --latency");
+    if (g_scaling && g_coldCacheSize)
+        EXM_THROW(14, "--cold can't be combined with --scaling");
+
     for (l=cLevel; l <= cLevelLast; l++) {
-        BMK_benchMem(srcBuffer, benchedSize,
-                     displayName, l,
-                     fileSizes, nbFiles);
+        if (g_nbMessageSizes)
+            BMK_benchLatency(srcBuffer, benchedSize, displayName, l);
+        else if (g_scaling)
+            BMK_benchScaling(srcBuffer, benchedSize,
+                             displayName, l,
+                             fileSizes, nbFiles);
+        else
+            BMK_benchMem(srcBuffer, benchedSize,
+                         displayName, l,
+                         fileSizes, nbFiles);
     }
 }
 
@@ -472,10 +1609,13 @@ static void BMK_syntheticTest(int cLevel, int cLevelLast, double compressibility
     if (!srcBuffer) EXM_THROW(21, "not enough memory");
 
     /* Fill input buffer */
-    RDG_genBuffer(srcBuffer, benchedSize, compressibility, 0.0, 0);
+    RDG_genTypedBuffer(srcBuffer, benchedSize, g_syntheticType, compressibility, 0.0, g_syntheticSeed);
 
     /* Bench */
-    snprintf (name, sizeof(name), "Synthetic %2u%%", (unsigned)(compressibility*100));
+    if (g_syntheticType == RDG_lz)
+        snprintf (name, sizeof(name), "Synthetic %2u%%", (unsigned)(compressibility*100));
+    else
+        snprintf (name, sizeof(name), "Synthetic %s", RDG_typeName(g_syntheticType));
     BMK_benchCLevel(srcBuffer, benchedSize, name, cLevel, cLevelLast, &benchedSize, 1);
 
     /* clean up */
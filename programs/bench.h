@@ -31,7 +31,52 @@ int BMK_benchFiles(const char** fileNamesTable, unsigned nbFiles,
 /* Set Parameters */
 void BMK_SetNbSeconds(unsigned nbLoops);
 void BMK_SetBlockSize(size_t blockSize);
+void BMK_setNbThreads(unsigned nbThreads);
 void BMK_setAdditionalParam(int additionalParam);
 void BMK_setNotificationLevel(unsigned level);
 
+/* Scaling mode (default : 0) : `-T#` threads each (de)compress the whole input, repeatedly during measurement time,
+   with 1, 2, 4 ... up to # threads. Reports aggregate and per thread (min-max) speeds, and efficiency versus 1 thread */
+void BMK_setScaling(unsigned scaling);
+/* 1 : with scaling mode, each thread gets its own copy of input (default : 0, input shared read-only) */
+void BMK_setPrivateInputs(unsigned privateInputs);
+/* 1 : thread n runs on core n (modulo nb of cores), where supported (default : 0) */
+void BMK_setPinThreads(unsigned pin);
+/* nb of timed passes over input, after a warm-up pass (default : 0, passes are repeated during -i# seconds).
+   Each pass is a sample : fastest, median and standard deviation are reported */
+void BMK_setNbRepeats(unsigned nbRepeats);
+/* 1 : compression state is allocated once per thread, and reused for all blocks (default : 0, Lizard_compress()
+   allocates it for each block, which is included in measured time) */
+void BMK_setReuseContext(unsigned reuse);
+/* nb of compression states each thread cycles over, one per block, so that a state is cold when it is reused
+   (default : 1). More than 1 implies BMK_setReuseContext(1) */
+void BMK_setNbContexts(unsigned nbContexts);
+/* evictionSize > 0 : before each timed pass, a buffer of evictionSize bytes (larger than last level cache) is read
+   and written, so that input, output and states come from memory. Each pass is then a sample (default : 0, warm caches) */
+void BMK_setColdCache(size_t evictionSize);
+/* besides display, writes one record per (file, level, block size, nb of threads) on stdout :
+   ratio, speeds (fastest, median, stddev), memory used by the bench and peak memory of process */
+typedef enum { BMK_format_human=0, BMK_format_csv, BMK_format_json } BMK_format_e;
+void BMK_setFormat(BMK_format_e format);
+/* Latency mode : input is cut into independent messages of each size (default sizes : 200, 1K, 4K, 16K when nbSizes==0),
+   (de)compressed one at a time with a reused context, then with a dictionary loaded before each message.
+   Reports p50, p90, p99 and p99.9 latency of messages */
+void BMK_setLatencyMode(const unsigned* messageSizes, unsigned nbSizes);
+/* dictionary of latency mode (default : NULL, first 64 KB of input, messages are taken after it) */
+void BMK_setDictFileName(const char* dictFileName);
+/* Sweep mode : each combination of block size, level (of -b#/-e# range), hashLog and searchNum (see Lizard_compress_advanced())
+   is benchmarked, then settings of the Pareto frontier of ratio, compression and decompression speed are displayed.
+   Up to 16 values per parameter. Parameters without values keep their setting (-B#, defaults of level).
+   blockSize without values : 1K, 4K, 16K, 64K, 256K, 1M, 4M */
+/* Tune mode : searches parameters of Lizard_compress_advanced() giving best ratio, with compression and decompression at least
+   as fast as targets (MB/s, 0 : no target). Starts from best level of -b#/-e# range, then changes one parameter at a time
+   while it improves (coordinate descent), within `budget` benchmarks of -i# seconds (0 : tune mode disabled) */
+void BMK_setTuneBudget(unsigned budget);
+void BMK_setTargetSpeed(unsigned cSpeed, unsigned dSpeed);
+typedef enum { BMK_sweep_blockSize=0, BMK_sweep_hashLog, BMK_sweep_searchNum, BMK_sweep_count } BMK_sweepParam_e;
+void BMK_setSweep(BMK_sweepParam_e param, const unsigned* values, unsigned nbValues);
+/* input benchmarked without files : 10 MB from generator `type` of datagen (RDG_type_e) with `seed`,
+   so that results are reproducible (default : RDG_lz, 50% compressible, seed 0) */
+void BMK_setSyntheticInput(unsigned type, unsigned seed);
+
 #endif   /* BENCH_H_125623623633 */
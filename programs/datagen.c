@@ -29,7 +29,8 @@
 #include "util.h"      /* U32 */
 #include <stdlib.h>    /* malloc */
 #include <stdio.h>     /* FILE, fwrite */
-#include <string.h>    /* memcpy */
+#include <string.h>    /* memcpy, strcmp */
+#include "datagen.h"
 
 
 /**************************************
@@ -186,3 +187,371 @@ void RDG_genOut(unsigned long long size, double matchProba, double litProba, uns
         memcpy(buff, buff + RDG_BLOCKSIZE, RDG_DICTSIZE);
     }
 }
+
+
+/*********************************************************
+*  Named generators
+*********************************************************/
+/* Each generator produces records (a log line, a JSON document, a column chunk, a piece of section),
+   which are cut at buffer boundaries, so that output doesn't depend on the size of generated blocks.
+   Only integer arithmetic is used, so that output doesn't depend on platform. */
+#define RDG_RECORDSIZE  (4 KB)
+#define RDG_RECORDSLACK 64       /* instructions may overrun a piece of section */
+#define RDG_NBROWS      256
+#define RDG_NBCOLUMNS   5
+#define RDG_COUNTOF(t)  (sizeof(t) / sizeof((t)[0]))
+
+typedef struct
+{
+    RDG_type_e type;
+    U32 seed;
+    BYTE record[RDG_RECORDSIZE + RDG_RECORDSLACK];
+    size_t recordSize;
+    size_t recordPos;
+    U64 time;        /* ms since epoch */
+    U32 id;
+    U32 value;
+    U32 column;
+    U64 rows[RDG_NBCOLUMNS][RDG_NBROWS];
+    U32 sectionType;
+    size_t sectionLeft;
+    U32 address;
+} RDG_state_t;
+
+static const char* const g_rdgTypeNames[RDG_nbTypes] = { "lz", "logs", "json", "columns", "binary" };
+
+static const char* const g_rdgWords[] = { "account", "order", "invoice", "product", "session", "user", "cart", "payment",
+                                          "shipment", "review", "catalog", "search", "report", "token", "profile", "message" };
+static const char* const g_rdgNames[] = { "alice", "bob", "carol", "dave", "erin", "frank", "grace", "heidi",
+                                          "ivan", "judy", "mallory", "oscar", "peggy", "rupert", "sybil", "trent" };
+static const char* const g_rdgRoles[] = { "viewer", "editor", "admin", "billing", "support", "owner" };
+static const char* const g_rdgCities[] = { "Berlin", "Paris", "Warsaw", "Madrid", "Rome", "Vienna", "Prague", "Lisbon" };
+static const char* const g_rdgMethods[] = { "GET", "POST", "PUT", "DELETE" };
+static const U32 g_rdgStatus[] = { 200, 201, 204, 304, 400, 404, 500, 503 };
+
+typedef struct { BYTE length; BYTE rel32; BYTE bytes[4]; } RDG_insn_t;
+static const RDG_insn_t g_rdgCode[] = {   /* x86-64, most frequent first */
+    { 4, 0, { 0x48, 0x8B, 0x45, 0xF8 } },   /* mov rax, [rbp-8] */
+    { 4, 0, { 0x48, 0x89, 0x45, 0xF0 } },   /* mov [rbp-16], rax */
+    { 1, 1, { 0xE8 } },                     /* call rel32 */
+    { 3, 0, { 0x48, 0x89, 0xC7 } },         /* mov rdi, rax */
+    { 2, 0, { 0x85, 0xC0 } },               /* test eax, eax */
+    { 2, 1, { 0x0F, 0x84 } },               /* je rel32 */
+    { 3, 1, { 0x48, 0x8D, 0x05 } },         /* lea rax, [rip+rel32] */
+    { 3, 0, { 0x48, 0x01, 0xD0 } },         /* add rax, rdx */
+    { 2, 0, { 0x31, 0xC0 } },               /* xor eax, eax */
+    { 1, 1, { 0xB8 } },                     /* mov eax, imm32 */
+    { 1, 1, { 0xE9 } },                     /* jmp rel32 */
+    { 2, 0, { 0x74, 0x0A } },               /* je short */
+    { 4, 0, { 0x48, 0x83, 0xEC, 0x20 } },   /* sub rsp, 32 */
+    { 1, 0, { 0x55 } },                     /* push rbp */
+    { 3, 0, { 0x48, 0x89, 0xE5 } },         /* mov rbp, rsp */
+    { 1, 0, { 0xC9 } },                     /* leave */
+    { 1, 0, { 0xC3 } },                     /* ret */
+};
+
+static U32 RDG_randBelow(U32* seed, U32 max)
+{
+    return (U32)(((U64)RDG_rand(seed) * max) >> 32);
+}
+
+/* favours small values : min of 2 uniform draws */
+static U32 RDG_randSkewed(U32* seed, U32 max)
+{
+    U32 const a = RDG_randBelow(seed, max);
+    U32 const b = RDG_randBelow(seed, max);
+    return MIN(a, b);
+}
+
+static void RDG_writeLE(BYTE* dst, U64 value, size_t nbBytes)
+{
+    size_t n;
+    for (n=0; n<nbBytes; n++) dst[n] = (BYTE)(value >> (8*n));
+}
+
+/* days since 1970-01-01 => year, month, day (proleptic Gregorian calendar) */
+static void RDG_civilDate(U32 days, U32* year, U32* month, U32* day)
+{
+    U32 const z = days + 719468;
+    U32 const era = z / 146097;
+    U32 const doe = z - era * 146097;
+    U32 const yoe = (doe - doe/1460 + doe/36524 - doe/146096) / 365;
+    U32 const doy = doe - (365*yoe + yoe/4 - yoe/100);
+    U32 const mp = (5*doy + 2) / 153;
+    *day = doy - (153*mp + 2)/5 + 1;
+    *month = mp < 10 ? mp + 3 : mp - 9;
+    *year = yoe + era * 400 + (*month <= 2);
+}
+
+
+static size_t RDG_genLogLine(RDG_state_t* st)
+{
+    U32* const seed = &st->seed;
+    char* const line = (char*)st->record;
+    U32 const kind = RDG_randBelow(seed, 100);
+    U32 const worker = RDG_randSkewed(seed, 32);
+    const char* const word = g_rdgWords[RDG_randSkewed(seed, RDG_COUNTOF(g_rdgWords))];
+    U32 secs, year, month, day;
+    size_t pos;
+
+    st->time += (RDG_rand(seed) & 15) ? RDG_randBelow(seed, 40) : RDG_randBelow(seed, 5000);
+    secs = (U32)(st->time / 1000);
+    RDG_civilDate(secs / 86400, &year, &month, &day);
+    pos = (size_t)sprintf(line, "%04u-%02u-%02uT%02u:%02u:%02u.%03uZ ", year, month, day,
+                          secs / 3600 % 24, secs / 60 % 60, secs % 60, (U32)(st->time % 1000));
+
+    if (kind < 50)
+    {
+        U32 const latency = RDG_randSkewed(seed, 2000);
+        pos += (size_t)sprintf(line+pos, "INFO  [worker-%02u] http: %s /api/v1/%ss/%u status=%u bytes=%u latency_ms=%u.%u req=%08x%08x\n",
+                               worker, g_rdgMethods[RDG_randSkewed(seed, RDG_COUNTOF(g_rdgMethods))], word,
+                               RDG_randSkewed(seed, 100000), g_rdgStatus[RDG_randSkewed(seed, RDG_COUNTOF(g_rdgStatus))],
+                               RDG_randSkewed(seed, 65536), latency / 10, latency % 10, RDG_rand(seed), RDG_rand(seed));
+    }
+    else if (kind < 70)
+    {
+        U32 const hit = RDG_rand(seed) & 3;
+        pos += (size_t)sprintf(line+pos, "DEBUG [worker-%02u] cache: %s key=%s:%u hit=%s size=%u\n",
+                               worker, hit ? "get" : "set", word, RDG_randSkewed(seed, 100000), hit ? "true" : "false",
+                               RDG_randSkewed(seed, 16384));
+    }
+    else if (kind < 85)
+    {
+        pos += (size_t)sprintf(line+pos, "INFO  [scheduler] job %s-sync-%u finished in %u ms, %u items, next run in %u s\n",
+                               word, RDG_randSkewed(seed, 16), RDG_randSkewed(seed, 60000), RDG_randSkewed(seed, 5000),
+                               60 * (1 + RDG_randSkewed(seed, 10)));
+    }
+    else if (kind < 95)
+    {
+        pos += (size_t)sprintf(line+pos, "WARN  [worker-%02u] db: slow query on table %ss (%u ms): SELECT * FROM %ss WHERE id = %u\n",
+                               worker, word, 500 + RDG_randSkewed(seed, 10000), word, RDG_randSkewed(seed, 100000));
+    }
+    else
+    {
+        pos += (size_t)sprintf(line+pos, "ERROR [worker-%02u] %s: connection reset by peer 10.%u.%u.%u:%u, retry %u/5\n",
+                               worker, word, RDG_randSkewed(seed, 4), RDG_randBelow(seed, 256), RDG_randBelow(seed, 256),
+                               5432 + RDG_randSkewed(seed, 4), 1 + RDG_randSkewed(seed, 5));
+    }
+    return pos;
+}
+
+
+static size_t RDG_genJson(RDG_state_t* st)
+{
+    U32* const seed = &st->seed;
+    char* const doc = (char*)st->record;
+    const char* const first = g_rdgNames[RDG_randSkewed(seed, RDG_COUNTOF(g_rdgNames))];
+    const char* const last = g_rdgNames[RDG_randBelow(seed, RDG_COUNTOF(g_rdgNames))];
+    U32 const nbRoles = 1 + RDG_randSkewed(seed, 3);
+    U32 const nbItems = RDG_randSkewed(seed, 6);
+    U32 n;
+    size_t pos;
+
+    st->id += 1 + (RDG_rand(seed) & 3);
+    st->time += RDG_randSkewed(seed, 2000);
+    pos = (size_t)sprintf(doc, "{\"id\":%u,\"ts\":%u%03u,\"type\":\"%s\",\"user\":{\"id\":%u,\"name\":\"%s %s\",\"email\":\"%s.%s@example.com\",\"roles\":[",
+                          st->id, (U32)(st->time / 1000), (U32)(st->time % 1000), g_rdgWords[RDG_randSkewed(seed, RDG_COUNTOF(g_rdgWords))],
+                          RDG_randSkewed(seed, 1000000), first, last, first, last);
+    for (n=0; n<nbRoles; n++)
+        pos += (size_t)sprintf(doc+pos, "%s\"%s\"", n ? "," : "", g_rdgRoles[RDG_randSkewed(seed, RDG_COUNTOF(g_rdgRoles))]);
+    pos += (size_t)sprintf(doc+pos, "]");
+    if (RDG_rand(seed) & 1)
+    {
+        U32 const lat = RDG_randBelow(seed, 90000000);
+        U32 const lon = RDG_randBelow(seed, 180000000);
+        pos += (size_t)sprintf(doc+pos, ",\"address\":{\"city\":\"%s\",\"zip\":\"%05u\",\"geo\":{\"lat\":%u.%06u,\"lon\":%u.%06u}}",
+                               g_rdgCities[RDG_randSkewed(seed, RDG_COUNTOF(g_rdgCities))], RDG_randBelow(seed, 100000),
+                               lat / 1000000, lat % 1000000, lon / 1000000, lon % 1000000);
+    }
+    pos += (size_t)sprintf(doc+pos, "},\"items\":[");
+    for (n=0; n<nbItems; n++)
+    {
+        U32 const price = RDG_randSkewed(seed, 100000);
+        pos += (size_t)sprintf(doc+pos, "%s{\"sku\":\"%s-%04u\",\"qty\":%u,\"price\":%u.%02u}", n ? "," : "",
+                               g_rdgWords[RDG_randSkewed(seed, RDG_COUNTOF(g_rdgWords))], RDG_randSkewed(seed, 10000),
+                               1 + RDG_randSkewed(seed, 10), price / 100, price % 100);
+    }
+    pos += (size_t)sprintf(doc+pos, "],\"meta\":{\"source\":\"%s\",\"version\":\"%u.%u.%u\",\"trace\":\"%08x\"},\"ok\":%s}\n",
+                           (RDG_rand(seed) & 3) ? "web" : "mobile", 1 + RDG_randSkewed(seed, 3), RDG_randSkewed(seed, 10),
+                           RDG_randSkewed(seed, 20), RDG_rand(seed), (RDG_rand(seed) & 7) ? "true" : "false");
+    return pos;
+}
+
+
+/* one column of RDG_NBROWS rows per record; rows are generated with the first column */
+static size_t RDG_genColumn(RDG_state_t* st)
+{
+    static const size_t widths[RDG_NBCOLUMNS] = { 8, 4, 1, 4, 2 };   /* time, id, code, value, count */
+    U32* const seed = &st->seed;
+    size_t const width = widths[st->column];
+    size_t r;
+
+    if (st->column == 0)
+    {
+        for (r=0; r<RDG_NBROWS; r++)
+        {
+            st->time += (RDG_rand(seed) & 7) ? RDG_randSkewed(seed, 100) : RDG_randBelow(seed, 10000);
+            st->id += 1 + RDG_randSkewed(seed, 8);
+            st->value += RDG_randBelow(seed, 33) - 16;
+            st->rows[0][r] = st->time;
+            st->rows[1][r] = st->id;
+            st->rows[2][r] = RDG_randSkewed(seed, 12);
+            st->rows[3][r] = st->value;
+            st->rows[4][r] = RDG_randSkewed(seed, 1000);
+        }
+    }
+    for (r=0; r<RDG_NBROWS; r++)
+        RDG_writeLE(st->record + r*width, st->rows[st->column][r], width);
+    st->column = (st->column + 1) % RDG_NBCOLUMNS;
+    return RDG_NBROWS * width;
+}
+
+
+/* sections of 4-64 KB, generated by pieces of up to RDG_RECORDSIZE */
+static size_t RDG_genSection(RDG_state_t* st)
+{
+    U32* const seed = &st->seed;
+    BYTE* const piece = st->record;
+    size_t pieceSize, pos = 0;
+
+    if (st->sectionLeft == 0)
+    {
+        U32 const kind = RDG_randBelow(seed, 10);
+        st->sectionType = (kind < 4) ? 0 : (kind < 6) ? 1 : (kind < 8) ? 2 : 3;
+        st->sectionLeft = 4 KB + RDG_randBelow(seed, 60 KB);
+    }
+    pieceSize = MIN(st->sectionLeft, RDG_RECORDSIZE);
+    st->sectionLeft -= pieceSize;
+
+    switch (st->sectionType)
+    {
+    case 0:   /* code */
+        while (pos < pieceSize)
+        {
+            const RDG_insn_t* const insn = &g_rdgCode[RDG_randSkewed(seed, RDG_COUNTOF(g_rdgCode))];
+            memcpy(piece+pos, insn->bytes, insn->length);
+            pos += insn->length;
+            if (insn->rel32)
+            {
+                RDG_writeLE(piece+pos, RDG_randBelow(seed, 8192) - 4096, 4);
+                pos += 4;
+            }
+        }
+        break;
+    case 1:   /* string table */
+        while (pos < pieceSize)
+        {
+            pos += (size_t)sprintf((char*)piece+pos, "%s_%s", g_rdgWords[RDG_randSkewed(seed, RDG_COUNTOF(g_rdgWords))],
+                                   g_rdgWords[RDG_randBelow(seed, RDG_COUNTOF(g_rdgWords))]);
+            if (RDG_rand(seed) & 1) pos += (size_t)sprintf((char*)piece+pos, "_%u", RDG_randSkewed(seed, 64));
+            piece[pos++] = 0;
+        }
+        break;
+    case 2:   /* sorted address table : (address, type) pairs */
+        while (pos < pieceSize)
+        {
+            st->address += 4 + 4 * RDG_randSkewed(seed, 16);
+            RDG_writeLE(piece+pos, st->address, 4);
+            RDG_writeLE(piece+pos+4, 1 + RDG_randSkewed(seed, 4), 4);
+            pos += 8;
+        }
+        break;
+    default:   /* incompressible */
+        while (pos < pieceSize)
+        {
+            RDG_writeLE(piece+pos, RDG_rand(seed), 4);
+            pos += 4;
+        }
+        break;
+    }
+    return pieceSize;
+}
+
+
+static void RDG_initState(RDG_state_t* st, RDG_type_e type, U32 seed)
+{
+    memset(st, 0, sizeof(*st));
+    st->type = type;
+    st->seed = seed;
+    st->time = (U64)1704067200 * 1000 + RDG_randBelow(&st->seed, 86400000);   /* 2024-01-01 */
+    st->id = RDG_randBelow(&st->seed, 1 << 20);
+    st->value = 1 << 20;
+    st->address = 0x401000;
+}
+
+static size_t RDG_genRecord(RDG_state_t* st)
+{
+    switch (st->type)
+    {
+    case RDG_logs:    return RDG_genLogLine(st);
+    case RDG_json:    return RDG_genJson(st);
+    case RDG_columns: return RDG_genColumn(st);
+    case RDG_binary:  return RDG_genSection(st);
+    case RDG_lz:
+    case RDG_nbTypes:
+    default:          return 0;
+    }
+}
+
+static void RDG_fill(RDG_state_t* st, BYTE* dst, size_t size)
+{
+    while (size > 0)
+    {
+        size_t toCopy;
+        if (st->recordPos == st->recordSize)
+        {
+            st->recordSize = RDG_genRecord(st);
+            st->recordPos = 0;
+        }
+        toCopy = MIN(size, st->recordSize - st->recordPos);
+        memcpy(dst, st->record + st->recordPos, toCopy);
+        st->recordPos += toCopy;
+        dst += toCopy;
+        size -= toCopy;
+    }
+}
+
+
+void RDG_genTypedBuffer(void* buffer, size_t size, RDG_type_e type, double matchProba, double litProba, unsigned seed)
+{
+    RDG_state_t st;
+
+    if (type == RDG_lz || type >= RDG_nbTypes) { RDG_genBuffer(buffer, size, matchProba, litProba, seed); return; }
+    RDG_initState(&st, type, seed);
+    RDG_fill(&st, (BYTE*)buffer, size);
+}
+
+
+void RDG_genTypedOut(unsigned long long size, RDG_type_e type, double matchProba, double litProba, unsigned seed)
+{
+    BYTE buff[RDG_BLOCKSIZE];
+    RDG_state_t st;
+    U64 total = 0;
+
+    if (type == RDG_lz || type >= RDG_nbTypes) { RDG_genOut(size, matchProba, litProba, seed); return; }
+    RDG_initState(&st, type, seed);
+    SET_BINARY_MODE(stdout);
+
+    while (total < size)
+    {
+        size_t const genBlockSize = (size_t)MIN(size-total, RDG_BLOCKSIZE);
+        RDG_fill(&st, buff, genBlockSize);
+        fwrite(buff, 1, genBlockSize, stdout);
+        total += genBlockSize;
+    }
+}
+
+
+RDG_type_e RDG_typeFromName(const char* name)
+{
+    unsigned u;
+    for (u=0; u<RDG_nbTypes; u++)
+        if (!strcmp(name, g_rdgTypeNames[u])) return (RDG_type_e)u;
+    return RDG_nbTypes;
+}
+
+
+const char* RDG_typeName(RDG_type_e type)
+{
+    return (type < RDG_nbTypes) ? g_rdgTypeNames[type] : "unknown";
+}
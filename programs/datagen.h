@@ -37,3 +37,32 @@ void RDG_genBuffer(void* buffer, size_t size, double matchProba, double litProba
    RDG_genBuffer
    Same as RDG_genOut, but generate data into provided buffer
 */
+
+
+/* Named generators : synthetic data resembling common real-world inputs
+   RDG_lz      : default, LZ-style matches and literals, compressibility set by 'matchProba'
+   RDG_logs    : text log lines from a few templates, with timestamps, levels, paths, latencies and random ids
+   RDG_json    : newline-delimited JSON documents, with nested objects and arrays
+   RDG_columns : binary little-endian integer columns (sorted timestamps and ids, codes, random walks, counts),
+                 stored column by column in chunks of 256 rows
+   RDG_binary  : sections of machine-code-like bytes, string tables, sorted address tables
+                 and incompressible (random) regions
+*/
+typedef enum { RDG_lz=0, RDG_logs, RDG_json, RDG_columns, RDG_binary, RDG_nbTypes } RDG_type_e;
+
+void RDG_genTypedOut(unsigned long long size, RDG_type_e type, double matchProba, double litProba, unsigned seed);
+void RDG_genTypedBuffer(void* buffer, size_t size, RDG_type_e type, double matchProba, double litProba, unsigned seed);
+/* RDG_genTypedOut, RDG_genTypedBuffer
+   Same as RDG_genOut and RDG_genBuffer, for generator 'type'.
+   'matchProba' and 'litProba' are only used by RDG_lz.
+   Output only depends on ('type', 'seed') and 'size' : it is the same on all platforms.
+   Except for RDG_lz, RDG_genTypedOut() writes the same bytes as RDG_genTypedBuffer(),
+   and a shorter output is a prefix of a longer one.
+*/
+
+RDG_type_e  RDG_typeFromName(const char* name);
+const char* RDG_typeName(RDG_type_e type);
+/* RDG_typeFromName : return : generator named 'name' ("lz", "logs", "json", "columns", "binary"),
+                               or RDG_nbTypes if 'name' is unknown
+   RDG_typeName     : return : name of generator 'type'
+*/
@@ -42,6 +42,7 @@
 #include "bench.h"    /* BMK_benchFile, BMK_SetNbIterations, BMK_SetBlocksize, BMK_SetPause */
 #include "lizardio.h"    /* LizardIO_compressFilename, LizardIO_decompressFilename, LizardIO_compressMultipleFilenames */
 #include "lizard_compress.h" /* LizardHC_DEFAULT_CLEVEL, LIZARD_VERSION_STRING */
+#include "datagen.h"  /* RDG_typeFromName */
 
 
 
@@ -133,6 +134,9 @@ static int usage_advanced(const char* exeName)
     DISPLAY( " -q     : suppress warnings; specify twice to suppress errors too\n");
     DISPLAY( " -c     : force write to standard output, even if it is the console\n");
     DISPLAY( " -t     : test compressed file integrity\n");
+    DISPLAY( "--list  : list content of .liz files, without decoding them\n");
+    DISPLAY( "--solid=ARCHIVE : compress all input files into a single ARCHIVE (sets also -m)\n");
+    DISPLAY( " -d --solid : extract files of solid archive(s)\n");
     DISPLAY( " -m     : multiple input files (implies automatic output filenames)\n");
 #ifdef UTIL_HAS_CREATEFILELIST
     DISPLAY( " -r     : operate recursively on directories (sets also -m)\n");
@@ -142,13 +146,44 @@ static int usage_advanced(const char* exeName)
     /* DISPLAY( " -BX    : enable block checksum (default:disabled)\n");   *//* Option currently inactive */
     DISPLAY( "--no-frame-crc : disable stream checksum (default:enabled)\n");
     DISPLAY( "--content-size : compressed frame includes original size (default:not present)\n");
+    DISPLAY( "--window-size  : frame of linked blocks includes window of level, bounding decoder memory (default:not present, for v1.0 decoders)\n");
     DISPLAY( "--[no-]sparse  : sparse mode (default:enabled on file, disabled on stdout)\n");
+    DISPLAY( " -T#    : use # threads, 0 = all cores (default : 1) \n");
+    DISPLAY( "--stats : display cpu time and time waiting for I/O \n");
+    DISPLAY( "--[no-]mmap    : memory-map regular files (default:enabled)\n");
+    DISPLAY( "--adapt[=min:max] : adapt compression level to I/O speed (default range: 10-19 for -1X, etc.)\n");
+    DISPLAY( "                    input is then read, not memory-mapped, to measure waits on input as well as output\n");
+    DISPLAY( "--rsyncable : blocks also end at content-defined boundaries (rsync, dedup friendly)\n");
     DISPLAY( "Benchmark arguments :\n");
     DISPLAY( " -b#    : benchmark file(s), using # compression level (default : 1) \n");
     DISPLAY( " -e#    : test all compression levels from -bX to # (default : 1)\n");
     DISPLAY( " -i#    : minimum evaluation time in seconds (default : 3s)\n");
     DISPLAY( " -B#    : cut file into independent blocks of size # bytes [32+]\n");
     DISPLAY( "                      or predefined block size [1-7] (default: 4)\n");
+    DISPLAY( " -T#    : blocks are split between # threads \n");
+    DISPLAY( "--scaling : each thread processes whole input, with 1, 2, 4 ... # threads \n");
+    DISPLAY( "--private-inputs : with --scaling, each thread has its own copy of input \n");
+    DISPLAY( "--pin   : pin threads to cores \n");
+    DISPLAY( "--repeat=# : # timed passes over input, instead of -i# seconds \n");
+    DISPLAY( "--reuse-ctx : compression state is reused between blocks \n");
+    DISPLAY( "--contexts=# : blocks cycle over # compression states per thread \n");
+    DISPLAY( "--cold[=#] : evict caches before each pass, with a buffer of # MB (default : 64) \n");
+    DISPLAY( "--format=csv|json : also write results on stdout, one record per level \n");
+    DISPLAY( "--latency[=#,#...] : latency percentiles of independent messages of # bytes (default : 200,1K,4K,16K) \n");
+    DISPLAY( "--dict=FILE : dictionary of --latency (default : first 64 KB of input) \n");
+#ifdef UTIL_HAS_CREATEFILELIST
+    DISPLAY( "--tune[=DIR] : search parameters of best ratio for input files (or DIR), meeting target speeds \n");
+#else
+    DISPLAY( "--tune : search parameters of best ratio for input files, meeting target speeds \n");
+#endif
+    DISPLAY( "--target-cspeed=# : with --tune, compression at least # MB/s (default : none) \n");
+    DISPLAY( "--target-dspeed=# : with --tune, decompression at least # MB/s (default : none) \n");
+    DISPLAY( "--tune-budget=# : with --tune, up to # benchmarks (default : 64) \n");
+    DISPLAY( "--sweep[=#,#...] : bench blocks of # bytes x levels, and display Pareto frontier (default : 1K,4K,...,4M) \n");
+    DISPLAY( "--hashlog=#,#... : sweep hash table sizes (2^# entries) \n");
+    DISPLAY( "--searchnum=#,#... : sweep nb of searched matches \n");
+    DISPLAY( "--gen=NAME : without input files, bench data of generator NAME (lz, logs, json, columns, binary) \n");
+    DISPLAY( "--gen-seed=# : seed of --gen data (default : 0) \n");
     EXTENDED_HELP;
     return 0;
 }
@@ -234,7 +269,26 @@ static unsigned readU32FromChar(const char** stringPtr)
     return result;
 }
 
-typedef enum { om_auto, om_compress, om_decompress, om_test, om_bench } operationMode_e;
+/*! readU32ListFromChar() :
+    reads up to `maxNb` values separated by ',', each optionally followed by K or M (x1024, x1048576)
+    @return : nb of values read, or 0 if a value is 0 or the list doesn't end `string` */
+static unsigned readU32ListFromChar(const char* string, unsigned* values, unsigned maxNb)
+{
+    unsigned nb = 0;
+    while (nb < maxNb) {
+        values[nb] = readU32FromChar(&string);
+        if (*string == 'K') { values[nb] <<= 10; string++; }
+        else if (*string == 'M') { values[nb] <<= 20; string++; }
+        if (values[nb] == 0) return 0;
+        nb++;
+        if (*string != ',') break;
+        string++;
+    }
+    if (*string) return 0;
+    return nb;
+}
+
+typedef enum { om_auto, om_compress, om_decompress, om_test, om_bench, om_list } operationMode_e;
 
 int main(int argc, const char** argv)
 {
@@ -244,10 +298,13 @@ int main(int argc, const char** argv)
         forceStdout=0,
         main_pause=0,
         multiple_inputs=0,
+        solid=0,
+        nbThreads=1,
         operationResult=0;
     operationMode_e mode = om_auto;
     const char* input_filename = NULL;
     const char* output_filename= NULL;
+    const char* solidArchive = NULL;
     char* dynNameSpace = NULL;
     const char** inFileNames = (const char**) calloc(argc, sizeof(char*));
     unsigned ifnIdx=0;
@@ -260,6 +317,9 @@ int main(int argc, const char** argv)
     char* fileNamesBuf = NULL;
     unsigned fileNamesNb, recursive=0;
 #endif
+    unsigned targetCSpeed=0, targetDSpeed=0;
+    RDG_type_e genType = RDG_lz;
+    unsigned genSeed = 0;
 
     /* Init */
     if (inFileNames==NULL) {
@@ -310,6 +370,8 @@ int main(int argc, const char** argv)
                 if (!strcmp(argument,  "--no-frame-crc")) { LizardIO_setStreamChecksumMode(0); continue; }
                 if (!strcmp(argument,  "--content-size")) { LizardIO_setContentSize(1); continue; }
                 if (!strcmp(argument,  "--no-content-size")) { LizardIO_setContentSize(0); continue; }
+                if (!strcmp(argument,  "--window-size")) { LizardIO_setWindowSize(1); continue; }
+                if (!strcmp(argument,  "--no-window-size")) { LizardIO_setWindowSize(0); continue; }
                 if (!strcmp(argument,  "--sparse")) { LizardIO_setSparseFile(2); continue; }
                 if (!strcmp(argument,  "--no-sparse")) { LizardIO_setSparseFile(0); continue; }
                 if (!strcmp(argument,  "--verbose")) { displayLevel++; continue; }
@@ -318,6 +380,114 @@ int main(int argc, const char** argv)
                 if (!strcmp(argument,  "--help")) { usage_advanced(exeName); goto _cleanup; }
                 if (!strcmp(argument,  "--keep")) { LizardIO_setRemoveSrcFile(0); continue; }   /* keep source file (default) */
                 if (!strcmp(argument,  "--rm")) { LizardIO_setRemoveSrcFile(1); continue; }
+                if (!strcmp(argument,  "--solid")) { solid = 1; multiple_inputs = 1; continue; }
+                if (!strncmp(argument, "--solid=", 8)) {
+                    solid = 1; multiple_inputs = 1;
+                    solidArchive = argument + 8;
+                    if (!strcmp(solidArchive, "-")) solidArchive = stdoutmark;
+                    continue;
+                }
+                if (!strcmp(argument,  "--list")) { mode = om_list; multiple_inputs = 1; continue; }
+                if (!strcmp(argument,  "--scaling")) { BMK_setScaling(1); continue; }
+                if (!strcmp(argument,  "--private-inputs")) { BMK_setPrivateInputs(1); continue; }
+                if (!strcmp(argument,  "--pin")) { BMK_setPinThreads(1); continue; }
+                if (!strcmp(argument,  "--reuse-ctx")) { BMK_setReuseContext(1); continue; }
+                if (!strcmp(argument,  "--format=csv")) { BMK_setFormat(BMK_format_csv); continue; }
+                if (!strcmp(argument,  "--format=json")) { BMK_setFormat(BMK_format_json); continue; }
+                if (!strcmp(argument,  "--latency")) { BMK_setLatencyMode(NULL, 0); continue; }
+                if (!strncmp(argument, "--latency=", 10)) {
+                    unsigned sizes[16];
+                    unsigned const nbSizes = readU32ListFromChar(argument + 10, sizes, 16);
+                    if (!nbSizes) badusage(exeName);
+                    BMK_setLatencyMode(sizes, nbSizes);
+                    continue;
+                }
+                if (!strcmp(argument,  "--tune")) { mode = om_bench; multiple_inputs = 1; BMK_setTuneBudget(64); continue; }
+#ifdef UTIL_HAS_CREATEFILELIST
+                if (!strncmp(argument, "--tune=", 7)) {   /* corpus directory */
+                    mode = om_bench; multiple_inputs = 1; recursive = 1;
+                    BMK_setTuneBudget(64);
+                    inFileNames[ifnIdx++] = argument + 7;
+                    continue;
+                }
+#endif
+                if (!strncmp(argument, "--tune-budget=", 14)) {
+                    argument += 14;
+                    BMK_setTuneBudget(readU32FromChar(&argument));
+                    if (*argument) badusage(exeName);
+                    continue;
+                }
+                if (!strncmp(argument, "--target-cspeed=", 16) || !strncmp(argument, "--target-dspeed=", 16)) {
+                    unsigned* const target = (argument[9]=='c') ? &targetCSpeed : &targetDSpeed;
+                    argument += 16;
+                    *target = readU32FromChar(&argument);
+                    if (!strcmp(argument, "MB/s")) argument += 4;
+                    if (*argument) badusage(exeName);
+                    BMK_setTargetSpeed(targetCSpeed, targetDSpeed);
+                    continue;
+                }
+                if (!strcmp(argument,  "--sweep")) { BMK_setSweep(BMK_sweep_blockSize, NULL, 0); continue; }
+                {   BMK_sweepParam_e param = BMK_sweep_count;
+                    if (!strncmp(argument, "--sweep=", 8)) param = BMK_sweep_blockSize;
+                    if (!strncmp(argument, "--hashlog=", 10)) param = BMK_sweep_hashLog;
+                    if (!strncmp(argument, "--searchnum=", 12)) param = BMK_sweep_searchNum;
+                    if (param != BMK_sweep_count) {
+                        unsigned values[16];
+                        unsigned const nbValues = readU32ListFromChar(strchr(argument, '=') + 1, values, 16);
+                        if (!nbValues) badusage(exeName);
+                        BMK_setSweep(param, values, nbValues);
+                        continue;
+                }   }
+                if (!strncmp(argument, "--gen=", 6)) {
+                    genType = RDG_typeFromName(argument + 6);
+                    if (genType == RDG_nbTypes) badusage(exeName);
+                    mode = om_bench;
+                    BMK_setSyntheticInput(genType, genSeed);
+                    continue;
+                }
+                if (!strncmp(argument, "--gen-seed=", 11)) {
+                    argument += 11;
+                    genSeed = readU32FromChar(&argument);
+                    if (*argument) badusage(exeName);
+                    BMK_setSyntheticInput(genType, genSeed);
+                    continue;
+                }
+                if (!strcmp(argument,  "--cold")) { BMK_setColdCache((size_t)64 << 20); continue; }
+                if (!strncmp(argument, "--cold=", 7)) {
+                    argument += 7;
+                    BMK_setColdCache((size_t)readU32FromChar(&argument) << 20);
+                    if (*argument) badusage(exeName);
+                    continue;
+                }
+                if (!strncmp(argument, "--contexts=", 11)) {
+                    argument += 11;
+                    BMK_setNbContexts(readU32FromChar(&argument));
+                    if (*argument) badusage(exeName);
+                    continue;
+                }
+                if (!strncmp(argument, "--dict=", 7)) { BMK_setDictFileName(argument + 7); continue; }
+                if (!strncmp(argument, "--repeat=", 9)) {
+                    argument += 9;
+                    BMK_setNbRepeats(readU32FromChar(&argument));
+                    if (*argument) badusage(exeName);
+                    continue;
+                }
+                if (!strcmp(argument,  "--stats")) { LizardIO_setDisplayStats(1); continue; }
+                if (!strcmp(argument,  "--mmap")) { LizardIO_setMemoryMap(1); continue; }
+                if (!strcmp(argument,  "--no-mmap")) { LizardIO_setMemoryMap(0); continue; }
+                if (!strcmp(argument,  "--rsyncable")) { LizardIO_setRsyncable(1); continue; }
+                if (!strcmp(argument,  "--adapt")) { LizardIO_setAdaptiveMode(1, 0, 0); continue; }
+                if (!strncmp(argument, "--adapt=", 8)) {
+                    int minLevel, maxLevel;
+                    argument += 8;
+                    minLevel = (int)readU32FromChar(&argument);
+                    if (*argument != ':') badusage(exeName);
+                    argument++;
+                    maxLevel = (int)readU32FromChar(&argument);
+                    if (*argument || (maxLevel < minLevel)) badusage(exeName);
+                    LizardIO_setAdaptiveMode(1, minLevel, maxLevel);
+                    continue;
+                }
             }
 
             while (argument[1]!=0) {
@@ -430,6 +600,13 @@ int main(int argc, const char** argv)
                     }
                     break;
 
+                    /* Nb of threads (0 = all cores) */
+                case 'T':
+                    argument++;
+                    nbThreads = (int)readU32FromChar(&argument);
+                    argument--;
+                    break;
+
                     /* Pause at the end (hidden option) */
                 case 'p': main_pause=1; break;
 
@@ -479,6 +656,11 @@ int main(int argc, const char** argv)
 #endif
     }
 
+    if (nbThreads == 0) nbThreads = UTIL_countCores();
+    LizardIO_setNotificationLevel(displayLevel);
+    nbThreads = (int)LizardIO_setNbThreads((unsigned)nbThreads);
+    BMK_setNbThreads((unsigned)nbThreads);
+
     /* benchmark and test modes */
     if (mode == om_bench) {
         BMK_setNotificationLevel(displayLevel);
@@ -486,6 +668,38 @@ int main(int argc, const char** argv)
         goto _cleanup;
     }
 
+    if (mode == om_list) {
+        if (ifnIdx == 0) ifnIdx = 1;   /* stdin */
+        if (!strcmp(inFileNames[0], stdinmark) && IS_CONSOLE(stdin)) {
+            DISPLAYLEVEL(1, "refusing to read from a console\n");
+            exit(1);
+        }
+        operationResult = LizardIO_listMultipleFilenames(inFileNames, ifnIdx);
+        goto _cleanup;
+    }
+
+    /* solid mode : many files into, or from, a single archive */
+    if (solid && (mode == om_decompress)) {
+        unsigned u;
+        if (ifnIdx == 0) ifnIdx = 1;   /* stdin */
+        if (!strcmp(inFileNames[0], stdinmark) && IS_CONSOLE(stdin)) {
+            DISPLAYLEVEL(1, "refusing to read from a console\n");
+            exit(1);
+        }
+        for (u=0; u<ifnIdx; u++) operationResult |= LizardIO_decompressSolid(inFileNames[u]);
+        goto _cleanup;
+    }
+    if (solid && (mode != om_test)) {
+        if (!solidArchive) { DISPLAYLEVEL(1, "archive name is required : --solid=ARCHIVE \n"); badusage(exeName); }
+        if (ifnIdx == 0) { DISPLAYLEVEL(1, "input files are required with --solid \n"); badusage(exeName); }
+        if (!strcmp(solidArchive, stdoutmark) && IS_CONSOLE(stdout) && !forceStdout) {
+            DISPLAYLEVEL(1, "refusing to write to console without -c\n");
+            exit(1);
+        }
+        operationResult = LizardIO_compressSolid(inFileNames, ifnIdx, solidArchive, cLevel);
+        goto _cleanup;
+    }
+
     if (mode == om_test) {
         LizardIO_setTestMode(1);
         output_filename = nulmark;
@@ -39,6 +39,9 @@
 #if defined(__MINGW32__) && !defined(_POSIX_SOURCE)
 #  define _POSIX_SOURCE 1          /* disable %llu warnings with MinGW on Windows */
 #endif
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#  define _GNU_SOURCE 1            /* splice, F_SETPIPE_SZ, SEEK_DATA, SEEK_HOLE */
+#endif
 
 
 /*****************************
@@ -46,14 +49,41 @@
 *****************************/
 #include "platform.h"  /* Large File Support, SET_BINARY_MODE, SET_SPARSE_FILE_MODE, PLATFORM_POSIX_VERSION, __64BIT__ */
 #include "util.h"      /* UTIL_getFileStat, UTIL_setFileStat */ 
-#include <stdio.h>     /* fprintf, fopen, fread, stdin, stdout, fflush, getchar */
+#include <stdio.h>     /* fprintf, fopen, fread, stdin, stdout, fflush, getchar, vsnprintf */
+#include <stdarg.h>    /* va_list */
 #include <stdlib.h>    /* malloc, free */
 #include <string.h>    /* strcmp, strlen */
 #include <time.h>      /* clock */
 #include <sys/types.h> /* stat64 */
 #include <sys/stat.h>  /* stat64 */
+#include "threadpool.h" /* TPOOL_create, TPOOL_add, TP_mutex_t */
 #include "lizardio.h"
 #include "lizard_frame.h"
+#include "lizard_frame_static.h"   /* LizardF_compressBegin_usingDict, LizardF_ERROR_xxx */
+#include "lizard_compress.h"       /* LIZARD_MIN_CLEVEL, LIZARD_MAX_CLEVEL, LIZARD_DEFAULT_CLEVEL */
+#include "lizard_decompress.h"     /* Lizard_decompress_safe */
+#define XXH_STATIC_LINKING_ONLY   /* XXH32_state_t */
+#include "xxhash/xxhash.h"         /* XXH32 */
+#if (PLATFORM_POSIX_VERSION >= 200112L)
+#  include <sys/mman.h>    /* mmap, munmap, posix_madvise */
+#  include <unistd.h>      /* ftruncate, sysconf, lseek */
+#  include <fcntl.h>       /* posix_fallocate */
+#  define LIZARDIO_MMAP 1
+#else
+#  define LIZARDIO_MMAP 0
+#endif
+#if defined(_WIN32)
+#  include <direct.h>      /* _mkdir */
+#  define LIZARDIO_MKDIR(path) _mkdir(path)
+#else
+#  define LIZARDIO_MKDIR(path) mkdir(path, 0777)
+#endif
+#if defined(__linux__)
+#  include <fcntl.h>       /* splice, fcntl(F_SETPIPE_SZ) */
+#  define LIZARDIO_SPLICE 1
+#else
+#  define LIZARDIO_SPLICE 0
+#endif
 
 
 
@@ -74,10 +104,13 @@
 #define LIZARDIO_MAGICNUMBER   0x184D2206U
 #define LIZARDIO_SKIPPABLE0    0x184D2A50U
 #define LIZARDIO_SKIPPABLEMASK 0xFFFFFFF0U
+#define LIZARDIO_FILETABLE_MAGIC 0x184D2A5AU   /* skippable frame : files of next frame (solid mode) */
 
 #define CACHELINE 64
 #define MIN_STREAM_BUFSIZE (192 KB)
 #define LIZARDIO_BLOCKSIZEID_DEFAULT 7
+#define LIZARDIO_JOBSIZE_MIN (4 MB)
+#define LIZARDIO_BLOCKUNCOMPRESSED_FLAG 0x80000000U
 
 #define sizeT sizeof(size_t)
 #define maskT (sizeT - 1)
@@ -90,12 +123,13 @@
 #define DISPLAYLEVEL(l, ...) if (g_displayLevel>=l) { DISPLAY(__VA_ARGS__); }
 static int g_displayLevel = 0;   /* 0 : no display  ; 1: errors  ; 2 : + result + interaction + warnings ; 3 : + progression; 4 : + information */
 
-#define DISPLAYUPDATE(l, ...) if (g_displayLevel>=l) { \
+#define DISPLAYUPDATE(l, ...) if ((g_displayLevel>=l) && g_displayProgress) { \
             if (((clock_t)(g_time - clock()) > refreshRate) || (g_displayLevel>=4)) \
             { g_time = clock(); DISPLAY(__VA_ARGS__); \
             if (g_displayLevel>=4) fflush(stderr); } }
 static const clock_t refreshRate = CLOCKS_PER_SEC / 6;
 static clock_t g_time = 0;
+static int g_displayProgress = 1;   /* disabled while files are processed in parallel */
 
 
 /**************************************
@@ -109,6 +143,13 @@ static int g_streamChecksum = 1;
 static int g_blockIndependence = 1;
 static int g_sparseFileSupport = 1;
 static int g_contentSizeFlag = 0;
+static int g_windowSizeFlag = 0;
+static unsigned g_nbThreads = 1;
+static int g_useMMap = LIZARDIO_MMAP;
+static int g_adapt = 0;
+static int g_adaptMinLevel = 0;
+static int g_adaptMaxLevel = 0;
+static int g_rsyncable = 0;
 
 
 /**************************************
@@ -222,9 +263,53 @@ int LizardIO_setContentSize(int enable)
     return g_contentSizeFlag;
 }
 
+/* Default setting : 0 (disabled) */
+int LizardIO_setWindowSize(int enable)
+{
+    g_windowSizeFlag = (enable!=0);
+    return g_windowSizeFlag;
+}
+
 static U32 g_removeSrcFile = 0;
 void LizardIO_setRemoveSrcFile(unsigned flag) { g_removeSrcFile = (flag>0); }
 
+/* Default setting : 1 (single-threaded) */
+unsigned LizardIO_setNbThreads(unsigned nbThreads)
+{
+    if (nbThreads < 1) nbThreads = 1;
+    if (nbThreads > TPOOL_maxThreads()) {
+        if (TPOOL_maxThreads() == 1) DISPLAYLEVEL(2, "Note : multi-threading is disabled in this build \n");
+        nbThreads = TPOOL_maxThreads();
+    }
+    g_nbThreads = nbThreads;
+    return g_nbThreads;
+}
+
+
+
+/* Default setting : 1 (enabled, where supported) */
+int LizardIO_setMemoryMap(int enable)
+{
+    g_useMMap = (enable!=0) && LIZARDIO_MMAP;
+    return g_useMMap;
+}
+
+/* Default setting : 0 (disabled) */
+int LizardIO_setAdaptiveMode(int enable, int minLevel, int maxLevel)
+{
+    g_adapt = (enable!=0);
+    g_adaptMinLevel = minLevel;
+    g_adaptMaxLevel = maxLevel;
+    return g_adapt;
+}
+
+/* Default setting : 0 (disabled) */
+int LizardIO_setRsyncable(int enable)
+{
+    g_rsyncable = (enable!=0);
+    return g_rsyncable;
+}
+
 
 
 /* ************************************************************************ **
@@ -234,6 +319,242 @@ void LizardIO_setRemoveSrcFile(unsigned flag) { g_removeSrcFile = (flag>0); }
 static int LizardIO_isSkippableMagicNumber(unsigned int magic) { return (magic & LIZARDIO_SKIPPABLEMASK) == LIZARDIO_SKIPPABLE0; }
 
 
+/*-************************************
+*  Memory-mapped files
+*  Regular files are mapped instead of being read or written through stdio buffers.
+*  Pipes, stdin, stdout, or failure to map, fall back to streaming.
+**************************************/
+
+/* maps whole `file`, opened for reading ; @return : NULL if not possible */
+static void* LizardIO_mapInput(FILE* file, size_t* sizePtr)
+{
+#if LIZARDIO_MMAP
+    struct stat st;
+    void* map;
+    if (!g_useMMap || (file == stdin)) return NULL;   /* stdin may not start at beginning of file */
+    if (fstat(fileno(file), &st) || !S_ISREG(st.st_mode) || (st.st_size <= 0)) return NULL;
+    if ((U64)st.st_size > (U64)(size_t)-1) return NULL;   /* 32-bit address space */
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+    if (map == MAP_FAILED) return NULL;
+    (void)posix_madvise(map, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+    DISPLAYLEVEL(4, "Using memory-mapped input \n");
+    *sizePtr = (size_t)st.st_size;
+    return map;
+#else
+    (void)file; (void)sizePtr;
+    return NULL;
+#endif
+}
+
+/* output files which may be mapped are opened with read access, as required by mmap() */
+static int LizardIO_canMapDstFileName(const char* dstFileName)
+{
+#if LIZARDIO_MMAP
+    struct stat st;
+    if (!g_useMMap) return 0;
+    if (stat(dstFileName, &st)) return 1;   /* new file */
+    return S_ISREG(st.st_mode);
+#else
+    (void)dstFileName;
+    return 0;
+#endif
+}
+
+static int LizardIO_canMapOutput(FILE* file)
+{
+    return g_useMMap && (file != NULL) && (file != stdout);
+}
+
+#define LIZARDIO_MMAP_MAXOUTPUT ((U64)1 << 40)   /* 1 TB : larger sizes, read from untrusted headers, are streamed */
+
+#if LIZARDIO_MMAP
+/* space of mapped output is reserved beforehand : writes through a mapping can't report a full disk, they fault (SIGBUS) */
+static int LizardIO_reserveOutput(int fd, off_t offset, off_t size)
+{
+#  if defined(__APPLE__)   /* no posix_fallocate() : output is streamed */
+    (void)fd; (void)offset; (void)size;
+    return 0;
+#  else
+    return posix_fallocate(fd, offset, size) == 0;
+#  endif
+}
+#endif
+
+/*! LizardIO_mapOutput() :
+ *  extends `file`, opened for writing, by `size` bytes, reserved on disk, and maps them.
+ *  `file` must have no pending write. Mapping must be released by LizardIO_unmapOutput(), including on errors.
+ *  @return : pointer to first new byte, or NULL if not possible */
+static void* LizardIO_mapOutput(FILE* file, U64 size, void** mapPtr, size_t* mapSizePtr)
+{
+#if LIZARDIO_MMAP
+    struct stat st;
+    off_t offset, mapOffset;
+    void* map;
+    if (!LizardIO_canMapOutput(file)) return NULL;
+    if ((size == 0) || (size > LIZARDIO_MMAP_MAXOUTPUT) || (size > (U64)(size_t)-1 - 4096)) return NULL;
+    if (fflush(file) || fstat(fileno(file), &st) || !S_ISREG(st.st_mode)) return NULL;
+    offset = ftello(file);
+    if (offset < 0) return NULL;
+    mapOffset = offset & ~((off_t)sysconf(_SC_PAGESIZE) - 1);   /* mapping starts on a page boundary */
+    if (!LizardIO_reserveOutput(fileno(file), offset, (off_t)size)) {
+        if (ftruncate(fileno(file), offset)) EXM_THROW(77, "Write error : cannot truncate output");   /* may be partially extended */
+        return NULL;
+    }
+    map = mmap(NULL, (size_t)(offset - mapOffset) + (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, fileno(file), mapOffset);
+    if (map == MAP_FAILED) {
+        if (ftruncate(fileno(file), offset)) EXM_THROW(77, "Write error : cannot truncate output");
+        return NULL;
+    }
+    (void)posix_madvise(map, (size_t)(offset - mapOffset) + (size_t)size, POSIX_MADV_SEQUENTIAL);
+    DISPLAYLEVEL(4, "Using memory-mapped output \n");
+    *mapPtr = map;
+    *mapSizePtr = (size_t)(offset - mapOffset) + (size_t)size;
+    return (char*)map + (offset - mapOffset);
+#else
+    (void)file; (void)size; (void)mapPtr; (void)mapSizePtr;
+    return NULL;
+#endif
+}
+
+/* releases mapping, then truncates `file` after `size` bytes written through it (less than mapped on errors),
+ * and sets file position there */
+static void LizardIO_unmapOutput(FILE* file, void* map, size_t mapSize, U64 size)
+{
+#if LIZARDIO_MMAP
+    off_t const offset = ftello(file);   /* unchanged since mapping */
+    int const syncError = msync(map, mapSize, MS_SYNC);   /* reports write errors, which munmap() doesn't */
+    if (munmap(map, mapSize) || syncError) EXM_THROW(78, "Write error : %s", strerror(errno));
+    if ((offset < 0) || ftruncate(fileno(file), offset + (off_t)size)) EXM_THROW(78, "Write error : cannot truncate output");
+    if (UTIL_fseek(file, (off_t)size, SEEK_CUR)) EXM_THROW(78, "Write error : cannot seek output");
+#else
+    (void)file; (void)map; (void)mapSize; (void)size;
+#endif
+}
+
+static void LizardIO_unmap(void* map, size_t mapSize)
+{
+#if LIZARDIO_MMAP
+    munmap(map, mapSize);
+#else
+    (void)map; (void)mapSize;
+#endif
+}
+
+
+/*-************************************
+*  Sparse input files
+*  Holes are found with lseek(SEEK_DATA / SEEK_HOLE) : within mapped input, they are neither read nor parsed.
+**************************************/
+typedef struct {
+    FILE*  file;
+    U64    fileSize;
+    U64    dataEnd;   /* no hole before this offset */
+    U64    holeEnd;   /* hole up to this offset */
+} LizardIO_holes_t;
+
+static void LizardIO_initHoles(LizardIO_holes_t* holes, FILE* file, U64 fileSize)
+{
+    holes->file = file;
+    holes->fileSize = fileSize;
+    holes->holeEnd = 0;
+    holes->dataEnd = (U64)-1;   /* no hole */
+#if LIZARDIO_MMAP && defined(SEEK_DATA)
+    {   struct stat st;   /* only files using less blocks than their size have holes */
+        if (fileSize && (file != stdin) && !fstat(fileno(file), &st) && S_ISREG(st.st_mode) && ((U64)st.st_blocks * 512 < fileSize))
+            holes->dataEnd = 0;
+    }
+#endif
+}
+
+/* @return : size of hole starting at `offset`, 0 if data */
+static U64 LizardIO_holeSize(LizardIO_holes_t* holes, U64 offset)
+{
+    if (offset < holes->holeEnd) return holes->holeEnd - offset;
+    if (offset < holes->dataEnd) return 0;
+#if LIZARDIO_MMAP && defined(SEEK_DATA)
+    {   off_t const data = lseek(fileno(holes->file), (off_t)offset, SEEK_DATA);
+        if ((data < 0) && (errno != ENXIO)) { holes->dataEnd = (U64)-1; return 0; }   /* not supported by file system */
+        holes->holeEnd = (data < 0) ? holes->fileSize : (U64)data;   /* ENXIO : hole up to end of file */
+        if (holes->holeEnd > offset) return holes->holeEnd - offset;
+        {   off_t const hole = lseek(fileno(holes->file), (off_t)offset, SEEK_HOLE);
+            holes->dataEnd = (hole < 0) ? holes->fileSize : (U64)hole;
+    }   }
+#endif
+    return 0;
+}
+
+
+/*-************************************
+*  Pipes
+*  On Linux, pipes are enlarged with F_SETPIPE_SZ, and written with write() rather than through stdio.
+*  Pass-through input is copied with splice(), without going through user space.
+**************************************/
+#define LIZARDIO_PIPESIZE (1 MB)   /* default limit for unprivileged users : /proc/sys/fs/pipe-max-size */
+
+/* @return : file descriptor of `file` if it is a pipe, -1 otherwise */
+static int LizardIO_pipeFd(FILE* file)
+{
+#if LIZARDIO_SPLICE
+    struct stat st;
+    if (file && !fstat(fileno(file), &st) && S_ISFIFO(st.st_mode)) return fileno(file);
+#else
+    (void)file;
+#endif
+    return -1;
+}
+
+/* fewer, larger transfers between processes ; failure is harmless */
+static void LizardIO_growPipe(int fd)
+{
+#if LIZARDIO_SPLICE && defined(F_SETPIPE_SZ)
+    if ((fd >= 0) && (fcntl(fd, F_GETPIPE_SZ) < LIZARDIO_PIPESIZE))
+        (void)fcntl(fd, F_SETPIPE_SZ, LIZARDIO_PIPESIZE);
+#else
+    (void)fd;
+#endif
+}
+
+/* same as fwrite(), into pipe `fd` which is never written through stdio ; @return : 0, or -1 on error (see errno) */
+static int LizardIO_writePipe(int fd, const void* buffer, size_t size)
+{
+#if LIZARDIO_SPLICE
+    while (size) {
+        ssize_t const written = write(fd, buffer, size);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        buffer = (const char*)buffer + written;
+        size -= (size_t)written;
+    }
+#else
+    (void)fd; (void)buffer; (void)size;
+#endif
+    return 0;
+}
+
+#if LIZARDIO_SPLICE
+/*! LizardIO_splice() :
+ *  copies `srcFd`, from `*srcOffset` (NULL : current position) up to its end, into `dstFd`. One of them must be a pipe.
+ *  @return : nb of bytes copied, or (U64)-1 if splice() is not supported by these files (nothing copied) */
+static U64 LizardIO_splice(int srcFd, loff_t* srcOffset, int dstFd)
+{
+    U64 total = 0;
+    for (;;) {
+        ssize_t const copied = splice(srcFd, srcOffset, dstFd, NULL, LIZARDIO_PIPESIZE, SPLICE_F_MOVE | SPLICE_F_MORE);
+        if (copied == 0) break;
+        if (copied < 0) {
+            if (errno == EINTR) continue;
+            if (!total && ((errno == EINVAL) || (errno == ENOSYS))) return (U64)-1;   /* e.g. file system, or output opened in append mode */
+            EXM_THROW(52, "Pass-through error : %s", strerror(errno));
+        }
+        total += (U64)copied;
+    }
+    return total;
+}
+#endif
+
+
 /** LizardIO_openSrcFile() :
  * condition : `dstFileName` must be non-NULL.
  * @result : FILE* to `dstFileName`, or NULL if it fails */
@@ -285,7 +606,7 @@ static FILE* LizardIO_openDstFile(const char* dstFileName)
                     }
                     while ((ch!=EOF) && (ch!='\n')) ch = getchar();  /* flush rest of input line */
         }   }   }
-        f = fopen( dstFileName, "wb" );
+        f = fopen( dstFileName, LizardIO_canMapDstFileName(dstFileName) ? "w+b" : "wb" );
         if (f==NULL) DISPLAYLEVEL(1, "%s: %s\n", dstFileName, strerror(errno));
     }
 
@@ -309,214 +630,1220 @@ static void LizardIO_writeLE32 (void* p, unsigned value32)
 
 
 /*********************************************
-*  Compression using Frame format
+*  Multi-threading : jobs processed in parallel, written in order
 *********************************************/
 
+typedef struct LizardIO_mtCtx_s LizardIO_mtCtx_t;
+
 typedef struct {
-    void*  srcBuffer;
+    LizardIO_mtCtx_t* mt;
+    void*  srcBuffer;       /* compression : history (prefixSize bytes) followed by input; decompression : blocks with their headers */
     size_t srcBufferSize;
+    size_t prefixSize;
+    size_t srcSize;
     void*  dstBuffer;
     size_t dstBufferSize;
+    size_t dstSize;         /* result, or LizardF error code */
+    size_t maxBlockSize;
+    const LizardF_preferences_t* prefs;
     LizardF_compressionContext_t ctx;
-} cRess_t;
-
-static cRess_t LizardIO_createCResources(void)
+    int    done;
+} LizardIO_job_t;
+
+struct LizardIO_mtCtx_s {
+    TPOOL_ctx* pool;
+    LizardIO_job_t* jobs;   /* used as a ring : job n is in jobs[n % nbJobs] */
+    unsigned nbJobs;
+    TP_mutex_t mutex;
+    TP_cond_t  jobDone;
+};
+
+/* returns NULL when single-threaded */
+static LizardIO_mtCtx_t* LizardIO_createMtCtx(unsigned nbThreads, int withCompressionContexts)
 {
-    const size_t blockSize = (size_t)LizardIO_GetBlockSize_FromBlockId (g_blockSizeId);
-    cRess_t ress;
+    LizardIO_mtCtx_t* mt;
+    unsigned n;
+    if (nbThreads <= 1) return NULL;
+
+    mt = (LizardIO_mtCtx_t*)calloc(1, sizeof(LizardIO_mtCtx_t));
+    if (!mt) EXM_THROW(21, "Allocation error : not enough memory");
+    mt->nbJobs = nbThreads + 2;   /* while workers are busy, one job is written and the next one is read */
+    mt->jobs = (LizardIO_job_t*)calloc(mt->nbJobs, sizeof(LizardIO_job_t));
+    mt->pool = TPOOL_create(nbThreads, mt->nbJobs);
+    if (!mt->jobs || !mt->pool) EXM_THROW(21, "Allocation error : can't create %u threads", nbThreads);
+    TP_mutex_init(&mt->mutex);
+    TP_cond_init(&mt->jobDone);
+    for (n=0; n<mt->nbJobs; n++) {
+        mt->jobs[n].mt = mt;
+        if (withCompressionContexts) {
+            LizardF_errorCode_t const errorCode = LizardF_createCompressionContext(&(mt->jobs[n].ctx), LIZARDF_VERSION);
+            if (LizardF_isError(errorCode)) EXM_THROW(30, "Allocation error : can't create LizardF context : %s", LizardF_getErrorName(errorCode));
+    }   }
+    DISPLAYLEVEL(4, "Using %u threads \n", nbThreads);
+    return mt;
+}
 
-    LizardF_errorCode_t const errorCode = LizardF_createCompressionContext(&(ress.ctx), LIZARDF_VERSION);
-    if (LizardF_isError(errorCode)) EXM_THROW(30, "Allocation error : can't create LizardF context : %s", LizardF_getErrorName(errorCode));
+static void LizardIO_freeMtCtx(LizardIO_mtCtx_t* mt)
+{
+    unsigned n;
+    if (!mt) return;
+    TPOOL_free(mt->pool);
+    for (n=0; n<mt->nbJobs; n++) {
+        free(mt->jobs[n].srcBuffer);
+        free(mt->jobs[n].dstBuffer);
+        if (mt->jobs[n].ctx) LizardF_freeCompressionContext(mt->jobs[n].ctx);
+    }
+    TP_cond_destroy(&mt->jobDone);
+    TP_mutex_destroy(&mt->mutex);
+    free(mt->jobs);
+    free(mt);
+}
 
-    /* Allocate Memory */
-    ress.srcBuffer = malloc(blockSize);
-    ress.srcBufferSize = blockSize;
-    ress.dstBufferSize = LizardF_compressFrameBound(blockSize, NULL);   /* cover worst case */
-    ress.dstBuffer = malloc(ress.dstBufferSize);
-    if (!ress.srcBuffer || !ress.dstBuffer) EXM_THROW(31, "Allocation error : not enough memory");
+/* buffers are kept from one job to the next, and only grow */
+static void LizardIO_reserveJobBuffers(LizardIO_job_t* job, size_t srcBufferSize, size_t dstBufferSize)
+{
+    if (job->srcBufferSize < srcBufferSize) {
+        free(job->srcBuffer);
+        job->srcBuffer = malloc(srcBufferSize);
+        job->srcBufferSize = srcBufferSize;
+    }
+    if (job->dstBufferSize < dstBufferSize) {
+        free(job->dstBuffer);
+        job->dstBuffer = malloc(dstBufferSize);
+        job->dstBufferSize = dstBufferSize;
+    }
+    if (!job->srcBuffer || !job->dstBuffer) EXM_THROW(22, "Allocation error : not enough memory");
+}
 
-    return ress;
+static void LizardIO_submitJob(LizardIO_job_t* job, TPOOL_function function)
+{
+    job->done = 0;
+    TPOOL_add(job->mt->pool, function, job);
 }
 
-static void LizardIO_freeCResources(cRess_t ress)
+static void LizardIO_jobCompleted(LizardIO_job_t* job)
 {
-    free(ress.srcBuffer);
-    free(ress.dstBuffer);
-    { LizardF_errorCode_t const errorCode = LizardF_freeCompressionContext(ress.ctx);
-      if (LizardF_isError(errorCode)) EXM_THROW(38, "Error : can't free LizardF context resource : %s", LizardF_getErrorName(errorCode)); }
+    TP_mutex_lock(&job->mt->mutex);
+    job->done = 1;
+    TP_cond_broadcast(&job->mt->jobDone);
+    TP_mutex_unlock(&job->mt->mutex);
 }
 
-/*
- * LizardIO_compressFilename_extRess()
- * result : 0 : compression completed correctly
- *          1 : missing or pb opening srcFileName
- */
-static int LizardIO_compressFilename_extRess(cRess_t ress, const char* srcFileName, const char* dstFileName, int compressionLevel)
+static void LizardIO_waitJob(LizardIO_job_t* job)
 {
-    unsigned long long filesize = 0;
-    unsigned long long compressedfilesize = 0;
-    FILE* srcFile;
-    FILE* dstFile;
-    void* const srcBuffer = ress.srcBuffer;
-    void* const dstBuffer = ress.dstBuffer;
-    const size_t dstBufferSize = ress.dstBufferSize;
-    const size_t blockSize = (size_t)LizardIO_GetBlockSize_FromBlockId (g_blockSizeId);
-    size_t readSize;
-    LizardF_compressionContext_t ctx = ress.ctx;   /* just a pointer */
-    LizardF_preferences_t prefs;
+    TP_mutex_lock(&job->mt->mutex);
+    while (!job->done) TP_cond_wait(&job->mt->jobDone, &job->mt->mutex);
+    TP_mutex_unlock(&job->mt->mutex);
+}
 
-    /* Init */
-    srcFile = LizardIO_openSrcFile(srcFileName);
-    if (srcFile == NULL) return 1;
-    dstFile = LizardIO_openDstFile(dstFileName);
-    if (dstFile == NULL) { fclose(srcFile); return 1; }
-    memset(&prefs, 0, sizeof(prefs));
 
+/*********************************************
+*  Multiple files : processed in parallel, opened and reported in order
+*  Each worker thread processes whole files, using resources of its own.
+*  Files are opened by caller, so that errors and prompts occur in input order.
+*********************************************/
 
-    /* Set compression parameters */
-    prefs.autoFlush = 1;
-    prefs.compressionLevel = compressionLevel;
-    prefs.frameInfo.blockMode = (LizardF_blockMode_t)g_blockIndependence;
-    prefs.frameInfo.blockSizeID = (LizardF_blockSizeID_t)g_blockSizeId;
-    prefs.frameInfo.contentChecksumFlag = (LizardF_contentChecksum_t)g_streamChecksum;
-    if (g_contentSizeFlag) {
-      U64 const fileSize = UTIL_getFileSize(srcFileName);
-      prefs.frameInfo.contentSize = fileSize;   /* == 0 if input == stdin */
-      if (fileSize==0)
-          DISPLAYLEVEL(3, "Warning : cannot determine input content size \n");
-    }
+typedef struct LizardIO_filesCtx_s LizardIO_filesCtx_t;
 
-    /* read first block */
-    readSize  = fread(srcBuffer, (size_t)1, blockSize, srcFile);
-    if (ferror(srcFile)) EXM_THROW(30, "Error reading %s ", srcFileName);
-    filesize += readSize;
+typedef struct {
+    LizardIO_filesCtx_t* ctx;
+    const char* srcFileName;
+    char*  dstFileName;
+    size_t dstFileNameSize;
+    FILE*  srcFile;
+    FILE*  dstFile;
+    unsigned long long srcSize;
+    unsigned long long dstSize;
+    int    submitted;     /* waiting to be reported */
+    int    done;
+} LizardIO_fileJob_t;
+
+/* processes job->srcFile into job->dstFile, and closes both */
+typedef void (*LizardIO_fileFunction)(void* ress, LizardIO_fileJob_t* job);
+
+struct LizardIO_filesCtx_s {
+    TPOOL_ctx* pool;
+    LizardIO_fileJob_t* jobs;   /* used as a ring : file n is in jobs[n % nbJobs] */
+    unsigned nbJobs;
+    void*  ress;                /* one cRess_t or dRess_t per worker */
+    size_t ressSize;
+    unsigned* freeRess;         /* stack of unused resources */
+    unsigned nbFreeRess;
+    LizardIO_fileFunction process;
+    int    compressionLevel;
+    TP_mutex_t mutex;
+    TP_cond_t  jobDone;
+};
+
+/* `nbWorkers` == 1 : files are processed synchronously, by caller */
+static LizardIO_filesCtx_t* LizardIO_createFilesCtx(unsigned nbWorkers, void* ress, size_t ressSize, LizardIO_fileFunction process)
+{
+    LizardIO_filesCtx_t* const ctx = (LizardIO_filesCtx_t*)calloc(1, sizeof(LizardIO_filesCtx_t));
+    unsigned n;
+    if (!ctx) EXM_THROW(24, "Allocation error : not enough memory");
+    ctx->nbJobs = (nbWorkers > 1) ? 2 * nbWorkers : 1;   /* opened files wait for a worker, up to 2 file descriptors each */
+    ctx->jobs = (LizardIO_fileJob_t*)calloc(ctx->nbJobs, sizeof(LizardIO_fileJob_t));
+    ctx->freeRess = (unsigned*)malloc(nbWorkers * sizeof(unsigned));
+    ctx->pool = TPOOL_create((nbWorkers > 1) ? nbWorkers : 0, ctx->nbJobs);
+    if (!ctx->jobs || !ctx->freeRess || !ctx->pool) EXM_THROW(24, "Allocation error : can't create %u threads", nbWorkers);
+    for (n=0; n<ctx->nbJobs; n++) ctx->jobs[n].ctx = ctx;
+    for (n=0; n<nbWorkers; n++) ctx->freeRess[n] = n;
+    ctx->nbFreeRess = nbWorkers;
+    ctx->ress = ress;
+    ctx->ressSize = ressSize;
+    ctx->process = process;
+    TP_mutex_init(&ctx->mutex);
+    TP_cond_init(&ctx->jobDone);
+    if (nbWorkers > 1) DISPLAYLEVEL(4, "Processing files with %u threads \n", nbWorkers);
+    return ctx;
+}
 
-    /* single-block file */
-    if (readSize < blockSize) {
-        /* Compress in single pass */
-        size_t const cSize = LizardF_compressFrame(dstBuffer, dstBufferSize, srcBuffer, readSize, &prefs);
-        if (LizardF_isError(cSize)) EXM_THROW(31, "Compression failed : %s", LizardF_getErrorName(cSize));
-        compressedfilesize = cSize;
-        DISPLAYUPDATE(2, "\rRead : %u MB   ==> %.2f%%   ",
-                      (unsigned)(filesize>>20), (double)compressedfilesize/(filesize+!filesize)*100);   /* avoid division by zero */
+static void LizardIO_freeFilesCtx(LizardIO_filesCtx_t* ctx)
+{
+    unsigned n;
+    TPOOL_free(ctx->pool);
+    for (n=0; n<ctx->nbJobs; n++) free(ctx->jobs[n].dstFileName);
+    TP_cond_destroy(&ctx->jobDone);
+    TP_mutex_destroy(&ctx->mutex);
+    free(ctx->freeRess);
+    free(ctx->jobs);
+    free(ctx);
+}
 
-        /* Write Block */
-        {   size_t const sizeCheck = fwrite(dstBuffer, 1, cSize, dstFile);
-            if (sizeCheck!=cSize) EXM_THROW(32, "Write error : cannot write compressed block");
-    }   }
+static void LizardIO_fileJob(void* opaque)
+{
+    LizardIO_fileJob_t* const job = (LizardIO_fileJob_t*)opaque;
+    LizardIO_filesCtx_t* const ctx = job->ctx;
+    unsigned ressId;
+
+    /* no more jobs run than workers : a resource is always available */
+    TP_mutex_lock(&ctx->mutex);
+    ressId = ctx->freeRess[--ctx->nbFreeRess];
+    TP_mutex_unlock(&ctx->mutex);
+
+    ctx->process((char*)ctx->ress + ressId * ctx->ressSize, job);
+
+    TP_mutex_lock(&ctx->mutex);
+    ctx->freeRess[ctx->nbFreeRess++] = ressId;
+    job->done = 1;
+    TP_cond_broadcast(&ctx->jobDone);
+    TP_mutex_unlock(&ctx->mutex);
+}
 
-    else
+/*! LizardIO_nextFileJob() :
+ *  @return : slot for file `n`.
+ *  If the slot still holds a previous file, it is waited for, and returned with `submitted` set : caller reports it first. */
+static LizardIO_fileJob_t* LizardIO_nextFileJob(LizardIO_filesCtx_t* ctx, unsigned n)
+{
+    LizardIO_fileJob_t* const job = &ctx->jobs[n % ctx->nbJobs];
+    if (job->submitted) {
+        TP_mutex_lock(&ctx->mutex);
+        while (!job->done) TP_cond_wait(&ctx->jobDone, &ctx->mutex);
+        TP_mutex_unlock(&ctx->mutex);
+    }
+    return job;
+}
 
-    /* multiple-blocks file */
-    {
-        /* Write Archive Header */
-        size_t headerSize = LizardF_compressBegin(ctx, dstBuffer, dstBufferSize, &prefs);
-        if (LizardF_isError(headerSize)) EXM_THROW(33, "File header generation failed : %s", LizardF_getErrorName(headerSize));
-        { size_t const sizeCheck = fwrite(dstBuffer, 1, headerSize, dstFile);
-          if (sizeCheck!=headerSize) EXM_THROW(34, "Write error : cannot write header"); }
-        compressedfilesize += headerSize;
+/* job->dstFileName can store a name of `size` bytes, including terminating 0 */
+static void LizardIO_reserveFileName(LizardIO_fileJob_t* job, size_t size)
+{
+    if (job->dstFileNameSize >= size) return;
+    free(job->dstFileName);
+    job->dstFileName = (char*)malloc(size);
+    job->dstFileNameSize = size;
+    if (!job->dstFileName) EXM_THROW(24, "Allocation error : not enough memory");
+}
 
-        /* Main Loop */
-        while (readSize>0) {
-            size_t outSize;
+/* job->srcFile and job->dstFile must be opened ; job->srcSize and job->dstSize are set by job, or by caller */
+static void LizardIO_submitFileJob(LizardIO_fileJob_t* job)
+{
+    job->done = 0;
+    job->submitted = 1;
+    TPOOL_add(job->ctx->pool, LizardIO_fileJob, job);
+}
 
-            /* Compress Block */
-            outSize = LizardF_compressUpdate(ctx, dstBuffer, dstBufferSize, srcBuffer, readSize, NULL);
-            if (LizardF_isError(outSize)) EXM_THROW(35, "Compression failed : %s", LizardF_getErrorName(outSize));
-            compressedfilesize += outSize;
-            DISPLAYUPDATE(2, "\rRead : %u MB   ==> %.2f%%   ", (unsigned)(filesize>>20), (double)compressedfilesize/filesize*100);
 
-            /* Write Block */
-            { size_t const sizeCheck = fwrite(dstBuffer, 1, outSize, dstFile);
-              if (sizeCheck!=outSize) EXM_THROW(36, "Write error : cannot write compressed block"); }
+/*-************************************
+*  Asynchronous I/O
+*  A dedicated thread reads input ahead, or writes output behind,
+*  through a small ring of buffers, so that file access overlaps (de)compression.
+*  Without LIZARD_MULTITHREAD, each operation is simply executed when queued.
+**************************************/
+#define LIZARDIO_AIO_NBBUFFERS 3                 /* triple buffering */
+#define LIZARDIO_AIO_LARGEBUFFER (64 MB)         /* above : double buffering, to limit memory usage */
+#define LIZARDIO_AIO_DSRCSIZE (1 MB)             /* decoder input chunks */
+#define LIZARDIO_AIO_DDSTSIZE (4 MB)             /* decoder output : default blocks are decoded directly into it */
 
-            /* Read next block */
-            readSize  = fread(srcBuffer, (size_t)1, (size_t)blockSize, srcFile);
-            filesize += readSize;
-        }
-        if (ferror(srcFile)) EXM_THROW(37, "Error reading %s ", srcFileName);
+typedef struct LizardIO_aio_s LizardIO_aio_t;
+static int LizardIO_fwriteSparse(LizardIO_aio_t* aio, const void* buffer, size_t bufferSize);
+static int LizardIO_fwriteSparseEnd(LizardIO_aio_t* aio);
+typedef struct LizardIO_fileTable_s LizardIO_fileTable_t;
+static int LizardIO_fileTableWrite(LizardIO_fileTable_t* table, LizardIO_aio_t* writer, const void* buffer, size_t size);
+static void LizardIO_fileTableEnd(LizardIO_fileTable_t* table, LizardIO_aio_t* writer);
 
-        /* End of Stream mark */
-        headerSize = LizardF_compressEnd(ctx, dstBuffer, dstBufferSize, NULL);
-        if (LizardF_isError(headerSize)) EXM_THROW(38, "End of file generation failed : %s", LizardF_getErrorName(headerSize));
+static void LizardIO_readFileTable(LizardIO_fileTable_t* table, LizardIO_aio_t* reader, LizardIO_aio_t* writer, size_t size);
 
-        { size_t const sizeCheck = fwrite(dstBuffer, 1, headerSize, dstFile);
-          if (sizeCheck!=headerSize) EXM_THROW(39, "Write error : cannot write end of stream"); }
-        compressedfilesize += headerSize;
-    }
+typedef struct {
+    LizardIO_aio_t* aio;
+    void*  buffer;
+    size_t size;          /* reader : nb bytes read ; writer : nb bytes to write */
+    int    busy;          /* queued, or being processed by I/O thread */
+} LizardIO_aioBuffer_t;
+
+struct LizardIO_aio_s {
+    TPOOL_ctx* pool;      /* single I/O thread : operations are executed in order */
+    FILE*  file;          /* writer : NULL discards output (test mode) */
+    LizardIO_aioBuffer_t buffers[LIZARDIO_AIO_NBBUFFERS];
+    unsigned nbBuffers;
+    size_t bufferSize;
+    unsigned current;     /* buffer being consumed (reader) or filled (writer) */
+    size_t pos;           /* reader : bytes already consumed from current buffer, or from map */
+    int    endOfFile;     /* reader : set by I/O thread */
+    void*  map;           /* reader : whole input file, when mapped ; I/O thread is then unused */
+    size_t mapSize;
+    int    pipeFd;        /* file descriptor if file is a pipe, -1 otherwise */
+    int    sparse;        /* writer : use LizardIO_fwriteSparse() */
+    LizardIO_fileTable_t* table;   /* writer : output is split into files of a solid archive, instead of `file` */
+    unsigned storedSkips; /* writer : sparse file state, owned by I/O thread */
+    int    error;         /* writer : first error of I/O thread, which then skips remaining writes ; reported by caller */
+    char   errorMessage[256];
+    U64    ioTime;        /* microseconds spent by I/O thread within fread() / fwrite() */
+    U64    waitTime;      /* microseconds spent by caller waiting for I/O thread */
+    unsigned nbWaits;     /* nb of times caller waited for I/O thread */
+    UTIL_time_t ticksPerSecond;
+    TP_mutex_t mutex;
+    TP_cond_t  bufferDone;
+};
+
+static int g_displayStats = 0;
 
-    /* Release files */
-    fclose (srcFile);
-    fclose (dstFile);
+/* Default setting : 0 (disabled) */
+int LizardIO_setDisplayStats(int enable)
+{
+    g_displayStats = (enable!=0);
+    return g_displayStats;
+}
 
-    /* Copy owner, file permissions and modification time */
-    {   stat_t statbuf;
-        if (strcmp (srcFileName, stdinmark) && strcmp (dstFileName, stdoutmark) && UTIL_getFileStat(srcFileName, &statbuf))
-            UTIL_setFileStat(dstFileName, &statbuf);
+static LizardIO_aio_t* LizardIO_createAio(size_t bufferSize)
+{
+    LizardIO_aio_t* const aio = (LizardIO_aio_t*)calloc(1, sizeof(LizardIO_aio_t));
+    unsigned n;
+    if (!aio) EXM_THROW(23, "Allocation error : not enough memory");
+    aio->nbBuffers = (bufferSize > LIZARDIO_AIO_LARGEBUFFER) ? 2 : LIZARDIO_AIO_NBBUFFERS;
+    aio->bufferSize = bufferSize;
+    /* buffers are allocated separately : decoder keeps referencing its last output as history,
+     * which must never look contiguous with the next buffer */
+    for (n=0; n<aio->nbBuffers; n++) {
+        aio->buffers[n].aio = aio;
+        aio->buffers[n].buffer = malloc(bufferSize);
+        if (!aio->buffers[n].buffer) EXM_THROW(23, "Allocation error : not enough memory");
     }
+    aio->pool = TPOOL_create(1, aio->nbBuffers + 1);
+    if (!aio->pool) EXM_THROW(23, "Allocation error : can't create I/O thread");
+    TP_mutex_init(&aio->mutex);
+    TP_cond_init(&aio->bufferDone);
+    UTIL_initTimer(&aio->ticksPerSecond);
+    return aio;
+}
 
-    if (g_removeSrcFile) { if (remove(srcFileName)) EXM_THROW(40, "Remove error : %s: %s", srcFileName, strerror(errno)); } /* remove source file : --rm */
+static void LizardIO_freeAio(LizardIO_aio_t* aio)
+{
+    unsigned n;
+    if (!aio) return;
+    TPOOL_free(aio->pool);
+    for (n=0; n<aio->nbBuffers; n++) free(aio->buffers[n].buffer);
+    TP_cond_destroy(&aio->bufferDone);
+    TP_mutex_destroy(&aio->mutex);
+    free(aio);
+}
 
-    /* Final Status */
-    DISPLAYLEVEL(2, "\r%79s\r", "");
-    DISPLAYLEVEL(2, "Compressed %llu bytes into %llu bytes ==> %.2f%%\n",
-        filesize, compressedfilesize, (double)compressedfilesize/(filesize + !filesize)*100);   /* avoid division by zero */
+static void LizardIO_aioBufferDone(LizardIO_aioBuffer_t* b, U64 ioTime)
+{
+    TP_mutex_lock(&b->aio->mutex);
+    b->aio->ioTime += ioTime;
+    b->busy = 0;
+    TP_cond_broadcast(&b->aio->bufferDone);
+    TP_mutex_unlock(&b->aio->mutex);
+}
 
-    return 0;
+/*! LizardIO_aioError() :
+ *  called by I/O thread, which must not exit while caller still uses buffers :
+ *  records first error, then reported by LizardIO_aioCheckError().
+ *  @return : `error` */
+static int LizardIO_aioError(LizardIO_aio_t* aio, int error, const char* format, ...)
+{
+    va_list args;
+    TP_mutex_lock(&aio->mutex);
+    if (!aio->error) {
+        aio->error = error;
+        va_start(args, format);
+        vsnprintf(aio->errorMessage, sizeof(aio->errorMessage), format, args);
+        va_end(args);
+    }
+    TP_mutex_unlock(&aio->mutex);
+    return error;
 }
 
+/* called by caller : exits on error of I/O thread, once its pending operations are completed */
+static void LizardIO_aioCheckError(LizardIO_aio_t* aio)
+{
+    int error;
+    TP_mutex_lock(&aio->mutex);
+    error = aio->error;
+    TP_mutex_unlock(&aio->mutex);
+    if (error) {
+        TPOOL_jobsCompleted(aio->pool);
+        EXM_THROW(error, "%s", aio->errorMessage);
+    }
+}
 
-int LizardIO_compressFilename(const char* srcFileName, const char* dstFileName, int compressionLevel)
+static void LizardIO_aioWaitBuffer(LizardIO_aioBuffer_t* b)
 {
-    clock_t const start = clock();
-    cRess_t const ress = LizardIO_createCResources();
+    LizardIO_aio_t* const aio = b->aio;
+    UTIL_time_t waitStart;
+    UTIL_getTime(&waitStart);
+    TP_mutex_lock(&aio->mutex);
+    if (b->busy) {
+        while (b->busy) TP_cond_wait(&aio->bufferDone, &aio->mutex);
+        aio->waitTime += UTIL_clockSpanMicro(waitStart, aio->ticksPerSecond);
+        aio->nbWaits++;
+    }
+    TP_mutex_unlock(&aio->mutex);
+    LizardIO_aioCheckError(aio);
+}
 
-    int const issueWithSrcFile = LizardIO_compressFilename_extRess(ress, srcFileName, dstFileName, compressionLevel);
+static void LizardIO_aioReadJob(void* opaque)
+{
+    LizardIO_aioBuffer_t* const b = (LizardIO_aioBuffer_t*)opaque;
+    LizardIO_aio_t* const aio = b->aio;
+    UTIL_time_t ioStart;
+    UTIL_getTime(&ioStart);
+    b->size = aio->endOfFile ? 0 : fread(b->buffer, 1, aio->bufferSize, aio->file);
+    if (b->size < aio->bufferSize) aio->endOfFile = 1;   /* end of file, or read error : see ferror() */
+    LizardIO_aioBufferDone(b, UTIL_clockSpanMicro(ioStart, aio->ticksPerSecond));
+}
 
-    /* Free resources */
-    LizardIO_freeCResources(ress);
+static void LizardIO_aioQueueRead(LizardIO_aioBuffer_t* b)
+{
+    b->busy = 1;
+    TPOOL_add(b->aio->pool, LizardIO_aioReadJob, b);
+}
 
-    /* Final Status */
-    {   clock_t const end = clock();
-        double const seconds = (double)(end - start) / CLOCKS_PER_SEC;
-        DISPLAYLEVEL(4, "Completed in %.2f sec \n", seconds);
+/* starts reading `file` ahead, into all buffers ; `mayMap` : regular files are memory-mapped instead, unless disabled */
+static void LizardIO_startReader(LizardIO_aio_t* aio, FILE* file, int mayMap)
+{
+    unsigned n;
+    aio->file = file;
+    aio->current = 0;
+    aio->pos = 0;
+    aio->endOfFile = 0;
+    aio->pipeFd = -1;
+    aio->map = mayMap ? LizardIO_mapInput(file, &aio->mapSize) : NULL;
+    if (aio->map) return;
+    aio->pipeFd = LizardIO_pipeFd(file);
+    if (aio->pipeFd >= 0) {
+        setvbuf(file, NULL, _IONBF, 0);   /* buffers are large anyway ; file position is then that of next byte to read */
+        LizardIO_growPipe(aio->pipeFd);
     }
+    for (n=0; n<aio->nbBuffers; n++) LizardIO_aioQueueRead(&aio->buffers[n]);
+}
 
-    return issueWithSrcFile;
+/* waits for pending reads : data read ahead but not consumed is lost */
+static void LizardIO_stopReader(LizardIO_aio_t* aio)
+{
+    TPOOL_jobsCompleted(aio->pool);
+    if (aio->map) LizardIO_unmap(aio->map, aio->mapSize);
+    aio->map = NULL;
+    aio->file = NULL;
 }
 
+/*! LizardIO_aioPeek() :
+ *  @return : pointer to next input bytes, valid until next LizardIO_aioConsume().
+ *  `*sizePtr` : nb of bytes available, at most one buffer; 0 means end of input (or read error : see ferror()) */
+static const void* LizardIO_aioPeek(LizardIO_aio_t* aio, size_t* sizePtr)
+{
+    if (aio->map) {   /* same slices as buffers would provide */
+        size_t const remaining = aio->mapSize - aio->pos;
+        *sizePtr = (remaining < aio->bufferSize) ? remaining : aio->bufferSize;
+        return (const char*)aio->map + aio->pos;
+    }
+    for (;;) {
+        LizardIO_aioBuffer_t* const b = &aio->buffers[aio->current];
+        LizardIO_aioWaitBuffer(b);
+        if ((aio->pos < b->size) || (b->size < aio->bufferSize)) {   /* data available, or end of input */
+            *sizePtr = b->size - aio->pos;
+            return (const char*)b->buffer + aio->pos;
+        }
+        /* current buffer fully consumed : read further ahead into it */
+        LizardIO_aioQueueRead(b);
+        aio->current = (aio->current + 1) % aio->nbBuffers;
+        aio->pos = 0;
+    }
+}
 
-#define FNSPACE 30
-int LizardIO_compressMultipleFilenames(const char** inFileNamesTable, int ifntSize, const char* suffix, int compressionLevel)
+/* @return : nb of buffers queued, or being processed, by I/O thread */
+static unsigned LizardIO_aioPending(LizardIO_aio_t* aio)
 {
-    int i;
-    int missed_files = 0;
-    char* dstFileName = (char*)malloc(FNSPACE);
-    size_t ofnSize = FNSPACE;
-    const size_t suffixSize = strlen(suffix);
-    cRess_t const ress = LizardIO_createCResources();
+    unsigned n, nbPending = 0;
+    TP_mutex_lock(&aio->mutex);
+    for (n=0; n<aio->nbBuffers; n++) nbPending += (aio->buffers[n].busy != 0);
+    TP_mutex_unlock(&aio->mutex);
+    return nbPending;
+}
 
-	if (dstFileName == NULL) return ifntSize;   /* not enough memory */
+/* data provided by LizardIO_aioPeek() remains valid until reader is stopped */
+static int LizardIO_aioIsStable(const LizardIO_aio_t* aio)
+{
+    return aio->map != NULL;
+}
 
-    /* loop on each file */
-    for (i=0; i<ifntSize; i++) {
-        size_t const ifnSize = strlen(inFileNamesTable[i]);
-        if (ofnSize <= ifnSize+suffixSize+1) { free(dstFileName); ofnSize = ifnSize + 20; dstFileName = (char*)malloc(ofnSize); if (dstFileName == NULL) return ifntSize; }
-        strcpy(dstFileName, inFileNamesTable[i]);
-        strcat(dstFileName, suffix);
+static void LizardIO_aioConsume(LizardIO_aio_t* aio, size_t size)
+{
+    aio->pos += size;
+}
 
-        missed_files += LizardIO_compressFilename_extRess(ress, inFileNamesTable[i], dstFileName, compressionLevel);
+/* same as fread() */
+static size_t LizardIO_aioRead(LizardIO_aio_t* aio, void* dst, size_t size)
+{
+    size_t total = 0;
+    while (total < size) {
+        size_t available;
+        const void* const src = LizardIO_aioPeek(aio, &available);
+        if (!available) break;
+        if (available > size - total) available = size - total;
+        memcpy((char*)dst + total, src, available);
+        LizardIO_aioConsume(aio, available);
+        total += available;
     }
+    return total;
+}
 
-    /* Close & Free */
-    LizardIO_freeCResources(ress);
-    free(dstFileName);
-
-    return missed_files;
+/* same as fseek(SEEK_CUR) forward, on a stream which may not be seekable ; @return : 0 on success */
+static int LizardIO_aioSkip(LizardIO_aio_t* aio, unsigned long long size)
+{
+    unsigned long long total = 0;
+    while (total < size) {
+        size_t available;
+        (void)LizardIO_aioPeek(aio, &available);
+        if (!available) break;
+        if (available > size - total) available = (size_t)(size - total);
+        LizardIO_aioConsume(aio, available);
+        total += available;
+    }
+    return total != size;
 }
 
+static void LizardIO_syncWriter(LizardIO_aio_t* aio);
+static void LizardIO_aioWrite(LizardIO_aio_t* aio, const void* src, size_t size);
 
-/* ********************************************************************* */
+/*! LizardIO_aioSplice() :
+ *  copies whole remaining input to `writer`, with splice() : input already read ahead is written first,
+ *  the rest doesn't go through user space. Input must be mapped or a pipe, or output a non-sparse pipe.
+ *  @return : nb of bytes copied ; reader then reaches end of input, unless splice() isn't supported */
+static U64 LizardIO_aioSplice(LizardIO_aio_t* reader, LizardIO_aio_t* writer)
+{
+    U64 total = 0;
+#if LIZARDIO_SPLICE
+    U64 spliced;
+    unsigned n;
+    if (!writer->file) return 0;
+    if ((writer->pipeFd < 0) && ((reader->pipeFd < 0) || (writer->sparse && g_sparseFileSupport))) return 0;   /* splice() requires a pipe */
+    if (!reader->map && (reader->pipeFd < 0)) return 0;   /* input read through stdio : its position is unknown */
+
+    if (!reader->map) {
+        TPOOL_jobsCompleted(reader->pool);
+        for (n=0; n<reader->nbBuffers; n++) {
+            LizardIO_aioBuffer_t* const b = &reader->buffers[(reader->current + n) % reader->nbBuffers];
+            LizardIO_aioWrite(writer, (const char*)b->buffer + reader->pos, b->size - reader->pos);
+            total += b->size - reader->pos;
+            reader->pos = 0;
+            b->size = 0;
+        }
+        reader->current = 0;
+    }
+    LizardIO_syncWriter(writer);
+    if (fflush(writer->file)) EXM_THROW(52, "Pass-through error : %s", strerror(errno));
+
+    if (reader->map) {
+        loff_t offset = (loff_t)reader->pos;   /* mapped input is not read : file position is still 0 */
+        spliced = LizardIO_splice(fileno(reader->file), &offset, fileno(writer->file));
+        if (spliced != (U64)-1) reader->pos = reader->mapSize;
+    } else {
+        spliced = LizardIO_splice(reader->pipeFd, NULL, fileno(writer->file));
+        if (spliced != (U64)-1) reader->endOfFile = 1;
+        else for (n=0; n<reader->nbBuffers; n++) LizardIO_aioQueueRead(&reader->buffers[n]);   /* resume reading ahead */
+    }
+    if (spliced != (U64)-1) total += spliced;
+#else
+    (void)reader; (void)writer;
+#endif
+    return total;
+}
+
+static void LizardIO_aioWriteJob(void* opaque)
+{
+    LizardIO_aioBuffer_t* const b = (LizardIO_aioBuffer_t*)opaque;
+    LizardIO_aio_t* const aio = b->aio;
+    UTIL_time_t ioStart;
+    UTIL_getTime(&ioStart);
+    if (aio->error) {
+        /* output is abandoned : caller exits once it notices the error */
+    } else if (aio->table) {
+        LizardIO_fileTableWrite(aio->table, aio, b->buffer, b->size);
+    } else if (aio->pipeFd >= 0) {
+        if (LizardIO_writePipe(aio->pipeFd, b->buffer, b->size)) LizardIO_aioError(aio, 76, "Write error : %s", strerror(errno));
+    } else if (aio->sparse) {
+        LizardIO_fwriteSparse(aio, b->buffer, b->size);
+    } else {
+        size_t const sizeCheck = fwrite(b->buffer, 1, b->size, aio->file);
+        if (sizeCheck!=b->size) LizardIO_aioError(aio, 76, "Write error : %s", strerror(errno));
+    }
+    LizardIO_aioBufferDone(b, UTIL_clockSpanMicro(ioStart, aio->ticksPerSecond));
+}
+
+static void LizardIO_aioWriteEndJob(void* opaque)
+{
+    LizardIO_aio_t* const aio = (LizardIO_aio_t*)opaque;
+    if (!aio->error) LizardIO_fwriteSparseEnd(aio);
+    aio->storedSkips = 0;
+}
+
+/* `file` == NULL : output is discarded, unless `aio->table` is then set (solid archive extraction) */
+static void LizardIO_startWriter(LizardIO_aio_t* aio, FILE* file, int sparse)
+{
+    aio->file = file;
+    aio->current = 0;
+    aio->pipeFd = LizardIO_pipeFd(file);
+    aio->sparse = sparse && (aio->pipeFd < 0);   /* pipes can't seek */
+    aio->storedSkips = 0;
+    aio->table = NULL;
+    LizardIO_growPipe(aio->pipeFd);
+}
+
+/* waits for all pending writes; output can then be used directly */
+static void LizardIO_flushWriter(LizardIO_aio_t* aio)
+{
+    unsigned n;
+    for (n=0; n<aio->nbBuffers; n++) LizardIO_aioWaitBuffer(&aio->buffers[n]);
+}
+
+/* waits for all pending writes, including sparse skips : file can then be written directly */
+static void LizardIO_syncWriter(LizardIO_aio_t* aio)
+{
+    if (aio->file && aio->sparse) TPOOL_add(aio->pool, LizardIO_aioWriteEndJob, aio);
+    LizardIO_flushWriter(aio);
+    TPOOL_jobsCompleted(aio->pool);
+    LizardIO_aioCheckError(aio);
+}
+
+static void LizardIO_stopWriter(LizardIO_aio_t* aio)
+{
+    LizardIO_syncWriter(aio);
+    if (aio->table) LizardIO_fileTableEnd(aio->table, aio);
+    aio->table = NULL;
+    aio->file = NULL;
+}
+
+/*! LizardIO_aioWriteBuffer() :
+ *  @return : next buffer to fill, of size `*capacityPtr`, then handed to LizardIO_aioCommit() */
+static void* LizardIO_aioWriteBuffer(LizardIO_aio_t* aio, size_t* capacityPtr)
+{
+    LizardIO_aioBuffer_t* const b = &aio->buffers[aio->current];
+    LizardIO_aioWaitBuffer(b);
+    *capacityPtr = aio->bufferSize;
+    return b->buffer;
+}
+
+/* queues writing of `size` first bytes of buffer provided by LizardIO_aioWriteBuffer() */
+static void LizardIO_aioCommit(LizardIO_aio_t* aio, size_t size)
+{
+    LizardIO_aioBuffer_t* const b = &aio->buffers[aio->current];
+    if (!size) return;
+    if (aio->file || aio->table) {
+        b->size = size;
+        b->busy = 1;
+        TPOOL_add(aio->pool, LizardIO_aioWriteJob, b);
+    }
+    aio->current = (aio->current + 1) % aio->nbBuffers;
+}
+
+/* same as fwrite(), through a copy */
+static void LizardIO_aioWrite(LizardIO_aio_t* aio, const void* src, size_t size)
+{
+    if (!aio->file && !aio->table) return;
+    while (size) {
+        size_t capacity;
+        void* const dst = LizardIO_aioWriteBuffer(aio, &capacity);
+        if (capacity > size) capacity = size;
+        memcpy(dst, src, capacity);
+        LizardIO_aioCommit(aio, capacity);
+        src = (const char*)src + capacity;
+        size -= capacity;
+    }
+}
+
+/* displays, then resets, time spent on I/O since `wallStart` and `cpuStart` ; `reader` and `writer` must be idle */
+static void LizardIO_displayStats(LizardIO_aio_t* reader, LizardIO_aio_t* writer, UTIL_time_t wallStart, clock_t cpuStart)
+{
+    if (g_displayStats) {
+        double const wallTime = (double)UTIL_clockSpanMicro(wallStart, reader->ticksPerSecond) / 1000000;
+        double const cpuTime = (double)(clock() - cpuStart) / CLOCKS_PER_SEC;
+        DISPLAYLEVEL(1, "Stats : %.2f s elapsed, %.2f s cpu ; read %.2f s (waited %.2f s) ; write %.2f s (waited %.2f s) \n",
+                wallTime, cpuTime,
+                (double)reader->ioTime / 1000000, (double)reader->waitTime / 1000000,
+                (double)writer->ioTime / 1000000, (double)writer->waitTime / 1000000);
+    }
+    reader->ioTime = reader->waitTime = 0;
+    writer->ioTime = writer->waitTime = 0;
+}
+
+/* adds time spent on I/O through `aio` to `total`, then resets `aio` ; both must be idle */
+static void LizardIO_mergeStats(LizardIO_aio_t* total, LizardIO_aio_t* aio)
+{
+    if (total == aio) return;
+    total->ioTime += aio->ioTime;
+    total->waitTime += aio->waitTime;
+    aio->ioTime = aio->waitTime = 0;
+}
+
+/* aggregate result of multiple files, displayed at the end of the run */
+static void LizardIO_displayFilesSummary(const char* action, unsigned nbFiles, unsigned long long srcSize, unsigned long long dstSize, UTIL_time_t wallStart)
+{
+    int const displayLevel = g_displayStats ? 1 : 2;   /* --stats : always displayed */
+    UTIL_time_t ticksPerSecond;
+    double seconds;
+    UTIL_initTimer(&ticksPerSecond);
+    seconds = (double)UTIL_clockSpanMicro(wallStart, ticksPerSecond) / 1000000;
+    DISPLAYLEVEL(displayLevel, "%u files %s : %llu bytes into %llu bytes ; %.2f s, %.1f MB/s \n",
+            nbFiles, action, srcSize, dstSize, seconds, (double)(srcSize > dstSize ? srcSize : dstSize) / (1 MB) / (seconds > 0.001 ? seconds : 0.001));
+}
+
+
+/*********************************************
+*  Compression using Frame format
+*********************************************/
+
+typedef struct {
+    LizardIO_aio_t* reader;
+    LizardIO_aio_t* writer;
+    LizardF_compressionContext_t ctx;
+    LizardIO_mtCtx_t* mt;
+} cRess_t;
+
+/* `nbThreads` > 1 : each file is compressed by multiple threads */
+static cRess_t LizardIO_createCResources(unsigned nbThreads)
+{
+    const size_t blockSize = (size_t)LizardIO_GetBlockSize_FromBlockId (g_blockSizeId);
+    cRess_t ress;
+
+    LizardF_errorCode_t const errorCode = LizardF_createCompressionContext(&(ress.ctx), LIZARDF_VERSION);
+    if (LizardF_isError(errorCode)) EXM_THROW(30, "Allocation error : can't create LizardF context : %s", LizardF_getErrorName(errorCode));
+
+    /* Allocate Memory : input is read one block at a time */
+    ress.reader = LizardIO_createAio(blockSize);
+    {   LizardF_preferences_t prefs;   /* rsyncable : input is buffered until content-defined ends of blocks, which are shorter */
+        memset(&prefs, 0, sizeof(prefs));
+        prefs.frameInfo.blockSizeID = (LizardF_blockSizeID_t)g_blockSizeId;
+        prefs.frameInfo.contentChecksumFlag = LizardF_contentChecksumEnabled;
+        prefs.rsyncable = 1;
+        ress.writer = LizardIO_createAio(g_rsyncable ? LizardF_compressBound(blockSize, &prefs)
+                                                     : LizardF_compressFrameBound(blockSize, NULL));   /* cover worst case */
+    }
+
+    ress.mt = LizardIO_createMtCtx(nbThreads, 1);
+    return ress;
+}
+
+static void LizardIO_freeCResources(cRess_t ress)
+{
+    LizardIO_freeAio(ress.reader);
+    LizardIO_freeAio(ress.writer);
+    LizardIO_freeMtCtx(ress.mt);
+    { LizardF_errorCode_t const errorCode = LizardF_freeCompressionContext(ress.ctx);
+      if (LizardF_isError(errorCode)) EXM_THROW(38, "Error : can't free LizardF context resource : %s", LizardF_getErrorName(errorCode)); }
+}
+
+
+/*-************************************
+*  Adaptive compression level (--adapt)
+*  Level is raised when compression had to wait for input or output since previous block,
+*  and lowered when both I/O threads are idle, i.e. waiting for compression.
+**************************************/
+typedef struct {
+    int level;
+    int minLevel;
+    int maxLevel;
+    unsigned nbWaits;   /* reader + writer, at previous block */
+} LizardIO_adapt_t;
+
+static void LizardIO_initAdapt(LizardIO_adapt_t* adapt, int compressionLevel)
+{
+    if (compressionLevel < LIZARD_MIN_CLEVEL) compressionLevel = LIZARD_DEFAULT_CLEVEL;   /* same as library */
+    if (compressionLevel > LIZARD_MAX_CLEVEL) compressionLevel = LIZARD_MAX_CLEVEL;
+    adapt->minLevel = g_adaptMinLevel;
+    adapt->maxLevel = g_adaptMaxLevel;
+    if (!adapt->minLevel && !adapt->maxLevel) {   /* default : levels of same kind as starting level */
+        adapt->minLevel = (compressionLevel / 10) * 10;
+        adapt->maxLevel = adapt->minLevel + 9;
+    }
+    if (adapt->minLevel < LIZARD_MIN_CLEVEL) adapt->minLevel = LIZARD_MIN_CLEVEL;
+    if (adapt->maxLevel > LIZARD_MAX_CLEVEL) adapt->maxLevel = LIZARD_MAX_CLEVEL;
+    if (adapt->maxLevel < adapt->minLevel) adapt->maxLevel = adapt->minLevel;
+    adapt->level = compressionLevel;
+    if (adapt->level < adapt->minLevel) adapt->level = adapt->minLevel;
+    if (adapt->level > adapt->maxLevel) adapt->level = adapt->maxLevel;
+    adapt->nbWaits = 0;
+}
+
+/* called at block boundary, before committing last block : sets level of next block */
+static void LizardIO_adaptLevel(LizardIO_adapt_t* adapt, cRess_t ress)
+{
+    unsigned const nbWaits = ress.reader->nbWaits + ress.writer->nbWaits;
+    int level = adapt->level;
+
+    if (nbWaits != adapt->nbWaits) {
+        if (level < adapt->maxLevel) level++;   /* I/O is the bottleneck : spend more time compressing */
+    } else if (!LizardIO_aioPending(ress.writer) && !LizardIO_aioPending(ress.reader)) {
+        if (level > adapt->minLevel) level--;   /* compression is the bottleneck */
+    }
+    adapt->nbWaits = nbWaits;
+
+    if (level != adapt->level) {
+        size_t const errorCode = LizardF_setCompressionLevel(ress.ctx, level);
+        if (LizardF_isError(errorCode)) EXM_THROW(36, "Cannot change compression level : %s", LizardF_getErrorName(errorCode));
+        DISPLAYLEVEL(4, "\rAdaptive compression level : %i \n", level);
+        adapt->level = level;
+    }
+}
+
+
+/* window written in frame header by --window-size : largest window of levels [minLevel-maxLevel] a frame may be compressed with */
+static unsigned LizardIO_frameWindowLog(int minLevel, int maxLevel)
+{
+    unsigned windowLog = 0;
+    int level;
+    for (level = minLevel; level <= maxLevel; level++) {
+        Lizard_cParams_t cParams;
+        memset(&cParams, 0, sizeof(cParams));
+        (void)Lizard_getCParams(level, &cParams);   /* can't fail without overrides */
+        if (cParams.windowLog > windowLog) windowLog = cParams.windowLog;
+    }
+    if (windowLog > LIZARD_WINDOWLOG_MAX) windowLog = LIZARD_WINDOWLOG_MAX;
+    return windowLog;
+}
+
+/* history of linked blocks used by LizardF_compressBegin() : window of compression level, or a smaller requested one */
+static size_t LizardIO_compressWindowSize(const LizardF_preferences_t* prefs)
+{
+    Lizard_cParams_t cParams;
+    unsigned windowLog;
+    memset(&cParams, 0, sizeof(cParams));
+    (void)Lizard_getCParams(prefs->compressionLevel, &cParams);   /* can't fail without overrides */
+    windowLog = cParams.windowLog;
+    if (prefs->frameInfo.windowLog && (prefs->frameInfo.windowLog < windowLog)) windowLog = prefs->frameInfo.windowLog;
+    return (size_t)1 << windowLog;
+}
+
+/* compresses input of job, and its history if any, into a sequence of frame blocks */
+static void LizardIO_compressJob(void* opaque)
+{
+    LizardIO_job_t* const job = (LizardIO_job_t*)opaque;
+    LizardF_compressOptions_t options;
+    size_t result;
+
+    memset(&options, 0, sizeof(options));
+    options.stableSrc = 1;   /* history and input remain in srcBuffer during the whole job */
+
+    /* frame header is produced by caller : it gets overwritten by blocks */
+    result = LizardF_compressBegin_usingDict(job->ctx, job->dstBuffer, job->dstBufferSize, job->srcBuffer, job->prefixSize, job->prefs);
+    if (!LizardF_isError(result))
+        result = LizardF_compressUpdate(job->ctx, job->dstBuffer, job->dstBufferSize, (const char*)job->srcBuffer + job->prefixSize, job->srcSize, &options);
+    if (!LizardF_isError(result)) {
+        /* releases ctx for next job; endMark is not part of job result */
+        size_t const endSize = LizardF_compressEnd(job->ctx, (char*)job->dstBuffer + result, job->dstBufferSize - result, NULL);
+        if (LizardF_isError(endSize)) result = endSize;
+    }
+
+    job->dstSize = result;
+    LizardIO_jobCompleted(job);
+}
+
+/*
+ * LizardIO_compressFrameMT() :
+ * input is cut into jobs of whole blocks, compressed in parallel, and written in order as a single frame.
+ * With linked blocks, each job starts with the last window of previous input as history,
+ * so cutting input into jobs costs little compression ratio.
+ * result : compressed size
+ */
+static unsigned long long LizardIO_compressFrameMT(cRess_t ress, FILE* srcFile, const char* srcFileName,
+                                                   const LizardF_preferences_t* prefs, unsigned long long* filesizePtr)
+{
+    LizardIO_mtCtx_t* const mt = ress.mt;
+    size_t const blockSize = (size_t)LizardIO_GetBlockSize_FromBlockId(prefs->frameInfo.blockSizeID);
+    unsigned long long filesize = 0;
+    unsigned long long compressedfilesize = 0;
+    LizardF_preferences_t jobPrefs = *prefs;
+    XXH32_state_t xxh;
+    size_t windowSize = 0;
+    size_t jobSize;
+    unsigned nbJobs = 0, nbWritten = 0;
+    int endOfFile = 0;
+
+    /* jobs only produce blocks : content size and checksum are managed here */
+    jobPrefs.frameInfo.contentSize = 0;
+    jobPrefs.frameInfo.contentChecksumFlag = LizardF_noContentChecksum;
+    XXH32_reset(&xxh, 0);
+    if (prefs->frameInfo.blockMode == LizardF_blockLinked) windowSize = LizardIO_compressWindowSize(prefs);
+
+    /* Write Archive Header */
+    {   size_t dstCapacity;
+        void* const dstBuffer = LizardIO_aioWriteBuffer(ress.writer, &dstCapacity);
+        size_t const headerSize = LizardF_compressBegin(ress.ctx, dstBuffer, dstCapacity, prefs);
+        if (LizardF_isError(headerSize)) EXM_THROW(33, "File header generation failed : %s", LizardF_getErrorName(headerSize));
+        LizardIO_aioCommit(ress.writer, headerSize);
+        compressedfilesize += headerSize;
+        {   BYTE unusedEnd[8];   /* ress.ctx only provides header; this releases it for next frame */
+            (void)LizardF_compressEnd(ress.ctx, unusedEnd, sizeof(unusedEnd), NULL);
+    }   }
+
+    /* jobs are large compared to history, which is re-indexed by each job */
+    jobSize = (4 * windowSize > LIZARDIO_JOBSIZE_MIN) ? 4 * windowSize : LIZARDIO_JOBSIZE_MIN;
+    jobSize = ((jobSize + blockSize - 1) / blockSize) * blockSize;
+
+    /* Main Loop */
+    for (;;) {
+        /* Read and submit jobs while some are available */
+        while (!endOfFile && (nbJobs - nbWritten < mt->nbJobs)) {
+            LizardIO_job_t* const job = &mt->jobs[nbJobs % mt->nbJobs];
+            size_t prefixSize = 0;
+            LizardIO_reserveJobBuffers(job, windowSize + jobSize, LizardF_compressBound(jobSize, &jobPrefs));
+            if (windowSize && nbJobs) {   /* previous job is still in its buffer, either running or written */
+                const LizardIO_job_t* const prev = &mt->jobs[(nbJobs-1) % mt->nbJobs];
+                size_t const prevEnd = prev->prefixSize + prev->srcSize;
+                prefixSize = (prevEnd < windowSize) ? prevEnd : windowSize;
+                memcpy(job->srcBuffer, (const char*)prev->srcBuffer + prevEnd - prefixSize, prefixSize);
+            }
+            job->prefixSize = prefixSize;
+            job->srcSize = LizardIO_aioRead(ress.reader, (char*)job->srcBuffer + prefixSize, jobSize);
+            if (ferror(srcFile)) EXM_THROW(37, "Error reading %s ", srcFileName);
+            if (job->srcSize < jobSize) endOfFile = 1;
+            if (job->srcSize == 0) break;
+            if (prefs->frameInfo.contentChecksumFlag) XXH32_update(&xxh, (const char*)job->srcBuffer + prefixSize, job->srcSize);
+            filesize += job->srcSize;
+            job->prefs = &jobPrefs;
+            LizardIO_submitJob(job, LizardIO_compressJob);
+            nbJobs++;
+        }
+        if (nbWritten == nbJobs) break;
+
+        /* Write oldest job */
+        {   LizardIO_job_t* const job = &mt->jobs[nbWritten % mt->nbJobs];
+            LizardIO_waitJob(job);
+            if (LizardF_isError(job->dstSize)) EXM_THROW(35, "Compression failed : %s", LizardF_getErrorName(job->dstSize));
+            LizardIO_aioWrite(ress.writer, job->dstBuffer, job->dstSize);
+            compressedfilesize += job->dstSize;
+            nbWritten++;
+            DISPLAYUPDATE(2, "\rRead : %u MB   ==> %.2f%%   ", (unsigned)(filesize>>20), (double)compressedfilesize/filesize*100);
+    }   }
+
+    /* End of Stream mark */
+    if (prefs->frameInfo.contentSize && (prefs->frameInfo.contentSize != filesize))
+        EXM_THROW(38, "End of file generation failed : %s", LizardF_getErrorName((size_t)-LizardF_ERROR_frameSize_wrong));
+    {   BYTE frameEnd[8];
+        size_t endSize = 4;
+        LizardIO_writeLE32(frameEnd, 0);   /* endMark */
+        if (prefs->frameInfo.contentChecksumFlag) {
+            LizardIO_writeLE32(frameEnd + 4, XXH32_digest(&xxh));   /* content Checksum */
+            endSize += 4;
+        }
+        LizardIO_aioWrite(ress.writer, frameEnd, endSize);
+        compressedfilesize += endSize;
+    }
+
+    *filesizePtr = filesize;
+    return compressedfilesize;
+}
+
+/* copies owner, file permissions and modification time */
+static void LizardIO_copyFileStat(const char* srcFileName, const char* dstFileName)
+{
+    stat_t statbuf;
+    if (strcmp (srcFileName, stdinmark) && strcmp (dstFileName, stdoutmark) && UTIL_getFileStat(srcFileName, &statbuf))
+        UTIL_setFileStat(dstFileName, &statbuf);
+}
+
+/*
+ * LizardIO_compressFile() :
+ * compresses opened srcFile into opened dstFile, then closes both.
+ * result : compressed size ; `*filesizePtr` : source size
+ */
+static unsigned long long LizardIO_compressFile(cRess_t ress, FILE* srcFile, FILE* dstFile, const char* srcFileName, const char* dstFileName,
+                                                int compressionLevel, unsigned long long* filesizePtr)
+{
+    unsigned long long filesize = 0;
+    unsigned long long compressedfilesize = 0;
+    const size_t blockSize = (size_t)LizardIO_GetBlockSize_FromBlockId (g_blockSizeId);
+    const void* srcBuffer;
+    void* dstBuffer;
+    size_t dstBufferSize;
+    size_t readSize;
+    LizardF_compressionContext_t ctx = ress.ctx;   /* just a pointer */
+    LizardF_preferences_t prefs;
+    LizardF_compressOptions_t options;
+    LizardIO_adapt_t adapt;
+    LizardIO_holes_t holes;
+
+    /* Init */
+    memset(&prefs, 0, sizeof(prefs));
+    memset(&options, 0, sizeof(options));
+    memset(&adapt, 0, sizeof(adapt));
+    LizardIO_startReader(ress.reader, srcFile, !(g_adapt && !g_rsyncable && !ress.mt));   /* --adapt : reader must be able to wait for input */
+    LizardIO_startWriter(ress.writer, dstFile, 0);
+    options.stableSrc = LizardIO_aioIsStable(ress.reader);   /* mapped input : no need to save history */
+    LizardIO_initHoles(&holes, srcFile, options.stableSrc ? ress.reader->mapSize : 0);   /* holes of streamed input are read anyway */
+
+
+    /* Set compression parameters */
+    prefs.autoFlush = 1;   /* each update ends at a block boundary : required by --adapt */
+    if (g_rsyncable) {   /* blocks end where content says so, not at each update */
+        prefs.autoFlush = 0;
+        prefs.rsyncable = 1;
+        if (g_adapt) DISPLAYLEVEL(2, "Warning : --adapt is ignored with --rsyncable \n");
+        if (!g_blockIndependence) DISPLAYLEVEL(2, "Warning : -BD is ignored with --rsyncable \n");
+        if (ress.mt) DISPLAYLEVEL(2, "Warning : --rsyncable compresses files with a single thread \n");
+    }
+    if (g_adapt && !g_rsyncable) {
+        LizardIO_initAdapt(&adapt, compressionLevel);
+        compressionLevel = adapt.level;
+    }
+    prefs.compressionLevel = compressionLevel;
+    prefs.frameInfo.blockMode = (LizardF_blockMode_t)g_blockIndependence;
+    prefs.frameInfo.blockSizeID = (LizardF_blockSizeID_t)g_blockSizeId;
+    prefs.frameInfo.contentChecksumFlag = (LizardF_contentChecksum_t)g_streamChecksum;
+    if (g_contentSizeFlag) {
+      U64 const fileSize = UTIL_getFileSize(srcFileName);
+      prefs.frameInfo.contentSize = fileSize;   /* == 0 if input == stdin */
+      if (fileSize==0)
+          DISPLAYLEVEL(3, "Warning : cannot determine input content size \n");
+    }
+    if (g_windowSizeFlag && (prefs.frameInfo.blockMode == LizardF_blockLinked) && !g_rsyncable)
+        prefs.frameInfo.windowLog = (g_adapt && !ress.mt) ? LizardIO_frameWindowLog(adapt.minLevel, adapt.maxLevel)
+                                                          : LizardIO_frameWindowLog(compressionLevel, compressionLevel);
+
+    if (ress.mt && !g_rsyncable) {
+        /* multi-threaded */
+        if (g_adapt) DISPLAYLEVEL(2, "Warning : --adapt is ignored with multiple threads \n");
+        compressedfilesize = LizardIO_compressFrameMT(ress, srcFile, srcFileName, &prefs, &filesize);
+    } else {
+        /* read first block : reader provides whole blocks, except at end of file */
+        srcBuffer = LizardIO_aioPeek(ress.reader, &readSize);
+        if (ferror(srcFile)) EXM_THROW(30, "Error reading %s ", srcFileName);
+        filesize += readSize;
+
+        /* single-block file : block size would be reduced, so not when rsyncable, to keep same boundaries */
+        if ((readSize < blockSize) && !g_rsyncable) {
+            /* Compress in single pass */
+            size_t cSize;
+            dstBuffer = LizardIO_aioWriteBuffer(ress.writer, &dstBufferSize);
+            cSize = LizardF_compressFrame(dstBuffer, dstBufferSize, srcBuffer, readSize, &prefs);
+            if (LizardF_isError(cSize)) EXM_THROW(31, "Compression failed : %s", LizardF_getErrorName(cSize));
+            LizardIO_aioConsume(ress.reader, readSize);
+            compressedfilesize = cSize;
+            DISPLAYUPDATE(2, "\rRead : %u MB   ==> %.2f%%   ",
+                          (unsigned)(filesize>>20), (double)compressedfilesize/(filesize+!filesize)*100);   /* avoid division by zero */
+
+            /* Write Block */
+            LizardIO_aioCommit(ress.writer, cSize);
+        }
+
+        else
+
+        /* multiple-blocks file */
+        {
+            /* Write Archive Header */
+            size_t headerSize;
+            dstBuffer = LizardIO_aioWriteBuffer(ress.writer, &dstBufferSize);
+            headerSize = LizardF_compressBegin(ctx, dstBuffer, dstBufferSize, &prefs);
+            if (LizardF_isError(headerSize)) EXM_THROW(33, "File header generation failed : %s", LizardF_getErrorName(headerSize));
+            LizardIO_aioCommit(ress.writer, headerSize);
+            compressedfilesize += headerSize;
+
+            /* Main Loop */
+            while (readSize>0) {
+                size_t outSize;
+
+                /* Compress Block : previous output may still be written meanwhile */
+                dstBuffer = LizardIO_aioWriteBuffer(ress.writer, &dstBufferSize);
+                if (LizardIO_holeSize(&holes, filesize - readSize) >= readSize)
+                    outSize = LizardF_compressZeros(ctx, dstBuffer, dstBufferSize, readSize);   /* mapped hole : not read */
+                else
+                    outSize = LizardF_compressUpdate(ctx, dstBuffer, dstBufferSize, srcBuffer, readSize, &options);
+                if (LizardF_isError(outSize)) EXM_THROW(35, "Compression failed : %s", LizardF_getErrorName(outSize));
+                LizardIO_aioConsume(ress.reader, readSize);   /* history is kept within ctx, or still mapped */
+                compressedfilesize += outSize;
+                DISPLAYUPDATE(2, "\rRead : %u MB   ==> %.2f%%   ", (unsigned)(filesize>>20), (double)compressedfilesize/filesize*100);
+                if (g_adapt && !g_rsyncable) LizardIO_adaptLevel(&adapt, ress);
+
+                /* Write Block */
+                LizardIO_aioCommit(ress.writer, outSize);
+
+                /* Next block : already read ahead */
+                srcBuffer = LizardIO_aioPeek(ress.reader, &readSize);
+                filesize += readSize;
+            }
+            if (ferror(srcFile)) EXM_THROW(37, "Error reading %s ", srcFileName);
+
+            /* End of Stream mark */
+            dstBuffer = LizardIO_aioWriteBuffer(ress.writer, &dstBufferSize);
+            headerSize = LizardF_compressEnd(ctx, dstBuffer, dstBufferSize, NULL);
+            if (LizardF_isError(headerSize)) EXM_THROW(38, "End of file generation failed : %s", LizardF_getErrorName(headerSize));
+            LizardIO_aioCommit(ress.writer, headerSize);
+            compressedfilesize += headerSize;
+        }
+    }
+
+    /* Release files */
+    LizardIO_stopReader(ress.reader);
+    LizardIO_stopWriter(ress.writer);
+    fclose (srcFile);
+    fclose (dstFile);
+    LizardIO_copyFileStat(srcFileName, dstFileName);
+
+    if (g_removeSrcFile) { if (remove(srcFileName)) EXM_THROW(40, "Remove error : %s: %s", srcFileName, strerror(errno)); } /* remove source file : --rm */
+
+    *filesizePtr = filesize;
+    return compressedfilesize;
+}
+
+static void LizardIO_displayCompressionResult(unsigned long long filesize, unsigned long long compressedfilesize)
+{
+    DISPLAYLEVEL(2, "\r%79s\r", "");
+    DISPLAYLEVEL(2, "Compressed %llu bytes into %llu bytes ==> %.2f%%\n",
+        filesize, compressedfilesize, (double)compressedfilesize/(filesize + !filesize)*100);   /* avoid division by zero */
+}
+
+/*
+ * LizardIO_compressFilename_extRess()
+ * result : 0 : compression completed correctly
+ *          1 : missing or pb opening srcFileName
+ */
+static int LizardIO_compressFilename_extRess(cRess_t ress, const char* srcFileName, const char* dstFileName, int compressionLevel)
+{
+    unsigned long long filesize, compressedfilesize;
+    FILE* srcFile;
+    FILE* dstFile;
+    UTIL_time_t wallStart;
+    clock_t const cpuStart = clock();
+
+    /* Init */
+    UTIL_getTime(&wallStart);
+    srcFile = LizardIO_openSrcFile(srcFileName);
+    if (srcFile == NULL) return 1;
+    dstFile = LizardIO_openDstFile(dstFileName);
+    if (dstFile == NULL) { fclose(srcFile); return 1; }
+
+    compressedfilesize = LizardIO_compressFile(ress, srcFile, dstFile, srcFileName, dstFileName, compressionLevel, &filesize);
+    LizardIO_displayStats(ress.reader, ress.writer, wallStart, cpuStart);
+
+    /* Final Status */
+    LizardIO_displayCompressionResult(filesize, compressedfilesize);
+    return 0;
+}
+
+
+int LizardIO_compressFilename(const char* srcFileName, const char* dstFileName, int compressionLevel)
+{
+    clock_t const start = clock();
+    cRess_t const ress = LizardIO_createCResources(g_nbThreads);
+
+    int const issueWithSrcFile = LizardIO_compressFilename_extRess(ress, srcFileName, dstFileName, compressionLevel);
+
+    /* Free resources */
+    LizardIO_freeCResources(ress);
+
+    /* Final Status */
+    {   clock_t const end = clock();
+        double const seconds = (double)(end - start) / CLOCKS_PER_SEC;
+        DISPLAYLEVEL(4, "Completed in %.2f sec \n", seconds);
+    }
+
+    return issueWithSrcFile;
+}
+
+
+static void LizardIO_compressFileJob(void* ressPtr, LizardIO_fileJob_t* job)
+{
+    cRess_t const ress = *(const cRess_t*)ressPtr;
+    job->dstSize = LizardIO_compressFile(ress, job->srcFile, job->dstFile, job->srcFileName, job->dstFileName,
+                                         job->ctx->compressionLevel, &job->srcSize);
+}
+
+/*
+ * LizardIO_compressMultipleFilenames() :
+ * with multiple threads, files are compressed in parallel, one per thread.
+ * result : nb of files which could not be opened
+ */
+int LizardIO_compressMultipleFilenames(const char** inFileNamesTable, int ifntSize, const char* suffix, int compressionLevel)
+{
+    int i;
+    int missed_files = 0;
+    unsigned nbFiles = 0;
+    unsigned long long totalSrcSize = 0, totalDstSize = 0;
+    const size_t suffixSize = strlen(suffix);
+    unsigned const nbWorkers = (ifntSize < 1) ? 1 : (g_nbThreads < (unsigned)ifntSize) ? g_nbThreads : (unsigned)ifntSize;
+    cRess_t* const ress = (cRess_t*)malloc(nbWorkers * sizeof(cRess_t));
+    LizardIO_filesCtx_t* ctx;
+    UTIL_time_t wallStart;
+    clock_t const cpuStart = clock();
+    unsigned n;
+
+    UTIL_getTime(&wallStart);
+    if (ress == NULL) return ifntSize;   /* not enough memory */
+    for (n=0; n<nbWorkers; n++) ress[n] = LizardIO_createCResources(nbWorkers > 1 ? 1 : g_nbThreads);
+    ctx = LizardIO_createFilesCtx(nbWorkers, ress, sizeof(cRess_t), LizardIO_compressFileJob);
+    ctx->compressionLevel = compressionLevel;
+    if (nbWorkers > 1) g_displayProgress = 0;
+
+    /* loop on each file, then report last ones */
+    for (i=0; i<ifntSize+(int)ctx->nbJobs; i++) {
+        LizardIO_fileJob_t* const job = LizardIO_nextFileJob(ctx, (unsigned)i);
+        if (job->submitted) {
+            LizardIO_displayCompressionResult(job->srcSize, job->dstSize);
+            totalSrcSize += job->srcSize;
+            totalDstSize += job->dstSize;
+            nbFiles++;
+            job->submitted = 0;
+        }
+        if (i >= ifntSize) continue;
+
+        job->srcFileName = inFileNamesTable[i];
+        LizardIO_reserveFileName(job, strlen(job->srcFileName) + suffixSize + 1);
+        strcpy(job->dstFileName, job->srcFileName);
+        strcat(job->dstFileName, suffix);
+        job->srcFile = LizardIO_openSrcFile(job->srcFileName);
+        if (job->srcFile == NULL) { missed_files++; continue; }
+        job->dstFile = LizardIO_openDstFile(job->dstFileName);
+        if (job->dstFile == NULL) { fclose(job->srcFile); missed_files++; continue; }
+        LizardIO_submitFileJob(job);
+    }
+
+    /* Close & Free */
+    g_displayProgress = 1;
+    LizardIO_freeFilesCtx(ctx);
+    for (n=0; n<nbWorkers; n++) {
+        LizardIO_mergeStats(ress[0].reader, ress[n].reader);
+        LizardIO_mergeStats(ress[0].writer, ress[n].writer);
+    }
+    LizardIO_displayStats(ress[0].reader, ress[0].writer, wallStart, cpuStart);
+    LizardIO_displayFilesSummary("compressed", nbFiles, totalSrcSize, totalDstSize, wallStart);
+    for (n=0; n<nbWorkers; n++) LizardIO_freeCResources(ress[n]);
+    free(ress);
+
+    return missed_files;
+}
+
+
+/* ********************************************************************* */
 /* ********************** Lizard file-stream Decompression **************** */
 /* ********************************************************************* */
 
@@ -530,8 +1857,11 @@ static unsigned LizardIO_readLE32 (const void* s)
     return value32;
 }
 
-static unsigned LizardIO_fwriteSparse(FILE* file, const void* buffer, size_t bufferSize, unsigned storedSkips)
+/* called by writer's I/O thread ; @return : 0, or error code, recorded into `aio` */
+static int LizardIO_fwriteSparse(LizardIO_aio_t* aio, const void* buffer, size_t bufferSize)
 {
+    FILE* const file = aio->file;
+    unsigned storedSkips = aio->storedSkips;
     const size_t* const bufferT = (const size_t*)buffer;   /* Buffer is supposed malloc'ed, hence aligned on size_t */
     const size_t* ptrT = bufferT;
     size_t  bufferSizeT = bufferSize / sizeT;
@@ -540,14 +1870,14 @@ static unsigned LizardIO_fwriteSparse(FILE* file, const void* buffer, size_t buf
 
     if (!g_sparseFileSupport) {  /* normal write */
         size_t const sizeCheck = fwrite(buffer, 1, bufferSize, file);
-        if (sizeCheck != bufferSize) EXM_THROW(70, "Write error : cannot write decoded block");
+        if (sizeCheck != bufferSize) return LizardIO_aioError(aio, 70, "Write error : cannot write decoded block");
         return 0;
     }
 
     /* avoid int overflow */
     if (storedSkips > 1 GB) {
         int const seekResult = UTIL_fseek(file, 1 GB, SEEK_CUR);
-        if (seekResult != 0) EXM_THROW(71, "1 GB skip error (sparse file support)");
+        if (seekResult != 0) return LizardIO_aioError(aio, 71, "1 GB skip error (sparse file support)");
         storedSkips -= 1 GB;
     }
 
@@ -563,12 +1893,12 @@ static unsigned LizardIO_fwriteSparse(FILE* file, const void* buffer, size_t buf
 
         if (nb0T != seg0SizeT) {   /* not all 0s */
             int const seekResult = UTIL_fseek(file, storedSkips, SEEK_CUR);
-            if (seekResult) EXM_THROW(72, "Sparse skip error ; try --no-sparse");
+            if (seekResult) return LizardIO_aioError(aio, 72, "Sparse skip error ; try --no-sparse");
             storedSkips = 0;
             seg0SizeT -= nb0T;
             ptrT += nb0T;
             {   size_t const sizeCheck = fwrite(ptrT, sizeT, seg0SizeT, file);
-                if (sizeCheck != seg0SizeT) EXM_THROW(73, "Write error : cannot write decoded block");
+                if (sizeCheck != seg0SizeT) return LizardIO_aioError(aio, 73, "Write error : cannot write decoded block");
         }   }
         ptrT += seg0SizeT;
     }
@@ -582,41 +1912,44 @@ static unsigned LizardIO_fwriteSparse(FILE* file, const void* buffer, size_t buf
         storedSkips += (unsigned) (restPtr - restStart);
         if (restPtr != restEnd) {
             int const seekResult = UTIL_fseek(file, storedSkips, SEEK_CUR);
-            if (seekResult) EXM_THROW(74, "Sparse skip error ; try --no-sparse");
+            if (seekResult) return LizardIO_aioError(aio, 74, "Sparse skip error ; try --no-sparse");
             storedSkips = 0;
             {   size_t const sizeCheck = fwrite(restPtr, 1, restEnd - restPtr, file);
-                if (sizeCheck != (size_t)(restEnd - restPtr)) EXM_THROW(75, "Write error : cannot write decoded end of block");
+                if (sizeCheck != (size_t)(restEnd - restPtr)) return LizardIO_aioError(aio, 75, "Write error : cannot write decoded end of block");
         }   }
     }
 
-    return storedSkips;
+    aio->storedSkips = storedSkips;
+    return 0;
 }
 
-static void LizardIO_fwriteSparseEnd(FILE* file, unsigned storedSkips)
+/* called by writer's I/O thread ; @return : 0, or error code, recorded into `aio` */
+static int LizardIO_fwriteSparseEnd(LizardIO_aio_t* aio)
 {
+    unsigned const storedSkips = aio->storedSkips;
     if (storedSkips>0) {   /* implies g_sparseFileSupport>0 */
-        int const seekResult = UTIL_fseek(file, storedSkips-1, SEEK_CUR);
-        if (seekResult != 0) EXM_THROW(69, "Final skip error (sparse file)\n");
+        int const seekResult = UTIL_fseek(aio->file, storedSkips-1, SEEK_CUR);
+        if (seekResult != 0) return LizardIO_aioError(aio, 69, "Final skip error (sparse file)");
         {   const char lastZeroByte[1] = { 0 };
-            size_t const sizeCheck = fwrite(lastZeroByte, 1, 1, file);
-            if (sizeCheck != 1) EXM_THROW(69, "Write error : cannot write last zero\n");
+            size_t const sizeCheck = fwrite(lastZeroByte, 1, 1, aio->file);
+            if (sizeCheck != 1) return LizardIO_aioError(aio, 69, "Write error : cannot write last zero");
     }   }
+    return 0;
 }
 
 
 
 typedef struct {
-    void*  srcBuffer;
-    size_t srcBufferSize;
-    void*  dstBuffer;
-    size_t dstBufferSize;
+    LizardIO_aio_t* reader;
+    LizardIO_aio_t* writer;
     FILE*  dstFile;
     LizardF_decompressionContext_t dCtx;
+    LizardIO_mtCtx_t* mt;
 } dRess_t;
 
-static const size_t LizardIO_dBufferSize = 64 KB;
 static unsigned g_magicRead = 0;
-static dRess_t LizardIO_createDResources(void)
+/* `nbThreads` > 1 : each file is decompressed by multiple threads, when possible */
+static dRess_t LizardIO_createDResources(unsigned nbThreads)
 {
     dRess_t ress;
 
@@ -625,13 +1958,11 @@ static dRess_t LizardIO_createDResources(void)
     if (LizardF_isError(errorCode)) EXM_THROW(60, "Can't create LizardF context : %s", LizardF_getErrorName(errorCode));
 
     /* Allocate Memory */
-    ress.srcBufferSize = LizardIO_dBufferSize;
-    ress.srcBuffer = malloc(ress.srcBufferSize);
-    ress.dstBufferSize = LizardIO_dBufferSize;
-    ress.dstBuffer = malloc(ress.dstBufferSize);
-    if (!ress.srcBuffer || !ress.dstBuffer) EXM_THROW(61, "Allocation error : not enough memory");
+    ress.reader = LizardIO_createAio(LIZARDIO_AIO_DSRCSIZE);
+    ress.writer = LizardIO_createAio(LIZARDIO_AIO_DDSTSIZE);
 
     ress.dstFile = NULL;
+    ress.mt = LizardIO_createMtCtx(nbThreads, 0);
     return ress;
 }
 
@@ -639,147 +1970,244 @@ static void LizardIO_freeDResources(dRess_t ress)
 {
     LizardF_errorCode_t errorCode = LizardF_freeDecompressionContext(ress.dCtx);
     if (LizardF_isError(errorCode)) EXM_THROW(69, "Error : can't free LizardF context resource : %s", LizardF_getErrorName(errorCode));
-    free(ress.srcBuffer);
-    free(ress.dstBuffer);
+    LizardIO_freeAio(ress.reader);
+    LizardIO_freeAio(ress.writer);
+    LizardIO_freeMtCtx(ress.mt);
 }
 
 
-static unsigned long long LizardIO_decompressLizardF(dRess_t ress, FILE* srcFile, FILE* dstFile)
+/* decodes a sequence of independent blocks */
+static void LizardIO_decompressJob(void* opaque)
+{
+    LizardIO_job_t* const job = (LizardIO_job_t*)opaque;
+    const BYTE* ip = (const BYTE*)job->srcBuffer;
+    const BYTE* const iend = ip + job->srcSize;
+    BYTE* const ostart = (BYTE*)job->dstBuffer;
+    BYTE* op = ostart;
+    size_t result = 0;
+
+    while (ip < iend) {   /* block sizes were checked while reading */
+        unsigned const blockHeader = LizardIO_readLE32(ip);
+        size_t const cSize = blockHeader & ~LIZARDIO_BLOCKUNCOMPRESSED_FLAG;
+        ip += 4;
+        if (blockHeader & LIZARDIO_BLOCKUNCOMPRESSED_FLAG) {
+            memcpy(op, ip, cSize);
+            op += cSize;
+        } else {
+            int const dSize = Lizard_decompress_safe((const char*)ip, (char*)op, (int)cSize, (int)job->maxBlockSize);
+            if (dSize < 0) { result = (size_t)-LizardF_ERROR_decompressionFailed; break; }
+            op += dSize;
+        }
+        ip += cSize;
+    }
+
+    job->dstSize = result ? result : (size_t)(op - ostart);
+    LizardIO_jobCompleted(job);
+}
+
+/*
+ * LizardIO_decompressFrameMT() :
+ * decodes a frame of independent blocks : groups of blocks are decoded in parallel, and written in order.
+ * `frameInfo` : frame header, already consumed from srcFile and checked
+ */
+static unsigned long long LizardIO_decompressFrameMT(dRess_t ress, FILE* srcFile, const LizardF_frameInfo_t* frameInfo)
 {
+    LizardIO_mtCtx_t* const mt = ress.mt;
+    size_t const maxBlockSize = (size_t)LizardIO_GetBlockSize_FromBlockId(frameInfo->blockSizeID);
+    size_t const nbBlocksPerJob = (maxBlockSize >= LIZARDIO_JOBSIZE_MIN) ? 1 : LIZARDIO_JOBSIZE_MIN / maxBlockSize;
     unsigned long long filesize = 0;
+    XXH32_state_t xxh;
+    unsigned nbJobs = 0, nbWritten = 0;
+    int endMark = 0;
+
+    XXH32_reset(&xxh, 0);
+
+    /* Main Loop */
+    for (;;) {
+        /* Read and submit groups of blocks */
+        while (!endMark && (nbJobs - nbWritten < mt->nbJobs)) {
+            LizardIO_job_t* const job = &mt->jobs[nbJobs % mt->nbJobs];
+            size_t nbBlocks;
+            LizardIO_reserveJobBuffers(job, nbBlocksPerJob * (4 + maxBlockSize), nbBlocksPerJob * maxBlockSize);
+            job->srcSize = 0;
+            for (nbBlocks = 0; nbBlocks < nbBlocksPerJob; nbBlocks++) {
+                BYTE* const blockStart = (BYTE*)job->srcBuffer + job->srcSize;
+                size_t cSize;
+                if (LizardIO_aioRead(ress.reader, blockStart, 4) != 4) EXM_THROW(68, "Unfinished stream");
+                cSize = LizardIO_readLE32(blockStart) & ~LIZARDIO_BLOCKUNCOMPRESSED_FLAG;
+                if (cSize == 0) { endMark = 1; break; }
+                if (cSize > maxBlockSize) EXM_THROW(66, "Decompression error : %s", LizardF_getErrorName((size_t)-LizardF_ERROR_GENERIC));
+                if (LizardIO_aioRead(ress.reader, blockStart + 4, cSize) != cSize) EXM_THROW(68, "Unfinished stream");
+                job->srcSize += 4 + cSize;
+            }
+            if (job->srcSize == 0) break;
+            job->maxBlockSize = maxBlockSize;
+            LizardIO_submitJob(job, LizardIO_decompressJob);
+            nbJobs++;
+        }
+        if (nbWritten == nbJobs) break;
+
+        /* Write oldest group */
+        {   LizardIO_job_t* const job = &mt->jobs[nbWritten % mt->nbJobs];
+            LizardIO_waitJob(job);
+            if (LizardF_isError(job->dstSize)) EXM_THROW(66, "Decompression error : %s", LizardF_getErrorName(job->dstSize));
+            if (frameInfo->contentChecksumFlag) XXH32_update(&xxh, job->dstBuffer, job->dstSize);
+            LizardIO_aioWrite(ress.writer, job->dstBuffer, job->dstSize);
+            filesize += job->dstSize;
+            nbWritten++;
+            DISPLAYUPDATE(2, "\rDecompressed : %u MB  ", (unsigned)(filesize>>20));
+    }   }
+    if (ferror(srcFile)) EXM_THROW(67, "Read error");
+
+    /* Frame end : content size and checksum */
+    if (frameInfo->contentSize && (frameInfo->contentSize != filesize))
+        EXM_THROW(66, "Decompression error : %s", LizardF_getErrorName((size_t)-LizardF_ERROR_frameSize_wrong));
+    if (frameInfo->contentChecksumFlag) {
+        BYTE checksum[4];
+        if (LizardIO_aioRead(ress.reader, checksum, 4) != 4) EXM_THROW(68, "Unfinished stream");
+        if (LizardIO_readLE32(checksum) != XXH32_digest(&xxh))
+            EXM_THROW(66, "Decompression error : %s", LizardF_getErrorName((size_t)-LizardF_ERROR_contentChecksum_invalid));
+    }
+
+    return filesize;
+}
+
+
+static unsigned long long LizardIO_decompressLizardF(dRess_t ress, FILE* srcFile)
+{
+    unsigned long long filesize = 0;
+    unsigned long long contentSize = 0;
     LizardF_errorCode_t nextToLoad;
-    unsigned storedSkips = 0;
+    BYTE header[4+2+8+1];   /* magic number, FLG, BD, content size, HC */
+    size_t headerSize = MAGICNUMBER_SIZE;
+    LizardF_decompressOptions_t options;
+    BYTE* dstMap = NULL;
+    void* map = NULL;
+    size_t mapSize = 0;
+
+    /* read frame header : it selects how frame is decoded */
+    LizardIO_writeLE32(header, LIZARDIO_MAGICNUMBER);   /* already consumed from srcFile */
+    headerSize += LizardIO_aioRead(ress.reader, header + headerSize, 2);
+    if (headerSize == 6) {
+        size_t const remaining = 1 + ((header[4] & (1<<3)) ? 8 : 0);   /* Content Size flag */
+        LizardF_frameInfo_t frameInfo;
+        headerSize += LizardIO_aioRead(ress.reader, header + headerSize, remaining);
+        if (!LizardF_isError(LizardF_getHeaderInfo(&frameInfo, header, headerSize))) {   /* otherwise, error is reported by LizardF_decompress() */
+            contentSize = frameInfo.contentSize;
+            /* multi-threaded decoding requires independent blocks */
+            if (ress.mt && (frameInfo.blockMode == LizardF_blockIndependent))
+                return LizardIO_decompressFrameMT(ress, srcFile, &frameInfo);
+    }   }
 
-    /* Init feed with magic number (already consumed from FILE* sFile) */
-    {   size_t inSize = MAGICNUMBER_SIZE;
-        size_t outSize= 0;
-        LizardIO_writeLE32(ress.srcBuffer, LIZARDIO_MAGICNUMBER);
-        nextToLoad = LizardF_decompress(ress.dCtx, ress.dstBuffer, &outSize, ress.srcBuffer, &inSize, NULL);
+    /* Init feed with magic number, and header bytes read so far */
+    {   size_t inSize = headerSize;
+        size_t outSize;
+        void* const dstBuffer = LizardIO_aioWriteBuffer(ress.writer, &outSize);   /* header produces no output */
+        nextToLoad = LizardF_decompress(ress.dCtx, dstBuffer, &outSize, header, &inSize, NULL);
         if (LizardF_isError(nextToLoad)) EXM_THROW(62, "Header error : %s", LizardF_getErrorName(nextToLoad));
     }
 
-    /* Main Loop */
-    for (;nextToLoad;) {
-        size_t readSize;
-        size_t pos = 0;
-        size_t decodedBytes = ress.dstBufferSize;
-
-        /* Read input */
-        if (nextToLoad > ress.srcBufferSize) nextToLoad = ress.srcBufferSize;
-        readSize = fread(ress.srcBuffer, 1, nextToLoad, srcFile);
-        if (!readSize) break;   /* reached end of file or stream */
-
-        while ((pos < readSize) || (decodedBytes == ress.dstBufferSize)) {  /* still to read, or still to flush */
-            /* Decode Input (at least partially) */
-            size_t remaining = readSize - pos;
-            decodedBytes = ress.dstBufferSize;
-            nextToLoad = LizardF_decompress(ress.dCtx, ress.dstBuffer, &decodedBytes, (char*)(ress.srcBuffer)+pos, &remaining, NULL);
-            if (LizardF_isError(nextToLoad)) EXM_THROW(66, "Decompression error : %s", LizardF_getErrorName(nextToLoad));
-            pos += remaining;
+    /* known content size : frame is decoded directly into mapped output, unless sparse mode is on (it skips zeroes while writing) */
+    memset(&options, 0, sizeof(options));
+    if (contentSize && !(ress.writer->sparse && g_sparseFileSupport) && LizardIO_canMapOutput(ress.writer->file)) {
+        LizardIO_syncWriter(ress.writer);
+        dstMap = (BYTE*)LizardIO_mapOutput(ress.writer->file, contentSize, &map, &mapSize);
+        options.stableDst = (dstMap != NULL);   /* whole frame remains in dstMap : no need to save history */
+    }
 
-            /* Write Block */
-            if (decodedBytes) {
-                if (!g_testMode)
-                    storedSkips = LizardIO_fwriteSparse(dstFile, ress.dstBuffer, decodedBytes, storedSkips);
-                filesize += decodedBytes;
-                DISPLAYUPDATE(2, "\rDecompressed : %u MB  ", (unsigned)(filesize>>20));
-            }
+    /* Main Loop : decoder reads from input read ahead, and writes into output written behind */
+    while (nextToLoad) {
+        size_t inSize, decodedBytes;
+        const void* const srcBuffer = LizardIO_aioPeek(ress.reader, &inSize);
+        void* const dstBuffer = dstMap ? dstMap + filesize : LizardIO_aioWriteBuffer(ress.writer, &decodedBytes);
+        if (dstMap) decodedBytes = (size_t)(contentSize - filesize);
+        if (inSize > nextToLoad) inSize = nextToLoad;   /* never beyond end of frame */
+
+        /* Decode Input (at least partially) */
+        nextToLoad = LizardF_decompress(ress.dCtx, dstBuffer, &decodedBytes, srcBuffer, &inSize, &options);
+        if (LizardF_isError(nextToLoad)) {
+            if (dstMap) LizardIO_unmapOutput(ress.writer->file, map, mapSize, filesize);   /* output ends with last decoded block */
+            EXM_THROW(66, "Decompression error : %s", LizardF_getErrorName(nextToLoad));
+        }
+        LizardIO_aioConsume(ress.reader, inSize);
 
-            if (!nextToLoad) break;
+        /* Write Block */
+        if (decodedBytes) {
+            if (!dstMap) LizardIO_aioCommit(ress.writer, decodedBytes);   /* output buffer is changed only after being used */
+            filesize += decodedBytes;
+            DISPLAYUPDATE(2, "\rDecompressed : %u MB  ", (unsigned)(filesize>>20));
+        } else if (!inSize) {
+            break;   /* no progress : reached end of file or stream */
         }
     }
-    /* can be out because readSize == 0, which could be an fread() error */
+    if (dstMap) LizardIO_unmapOutput(ress.writer->file, map, mapSize, filesize);
+    /* can be out because of no input, which could be an fread() error */
     if (ferror(srcFile)) EXM_THROW(67, "Read error");
 
-    if (!g_testMode) LizardIO_fwriteSparseEnd(dstFile, storedSkips);
     if (nextToLoad!=0) EXM_THROW(68, "Unfinished stream");
 
     return filesize;
 }
 
 
-#define PTSIZE  (64 KB)
-#define PTSIZET (PTSIZE / sizeof(size_t))
-static unsigned long long LizardIO_passThrough(FILE* finput, FILE* foutput, unsigned char MNstore[MAGICNUMBER_SIZE])
+static unsigned long long LizardIO_passThrough(dRess_t ress, FILE* finput, unsigned char MNstore[MAGICNUMBER_SIZE])
 {
-	size_t buffer[PTSIZET];
-    size_t readBytes = 1;
     unsigned long long total = MAGICNUMBER_SIZE;
-    unsigned storedSkips = 0;
-
-    size_t const sizeCheck = fwrite(MNstore, 1, MAGICNUMBER_SIZE, foutput);
-    if (sizeCheck != MAGICNUMBER_SIZE) EXM_THROW(50, "Pass-through write error");
+    size_t readBytes;
 
-    while (readBytes) {
-        readBytes = fread(buffer, 1, PTSIZE, finput);
+    LizardIO_aioWrite(ress.writer, MNstore, MAGICNUMBER_SIZE);
+    total += LizardIO_aioSplice(ress.reader, ress.writer);   /* where supported : whole input, then nothing left to read */
+    do {
+        const void* const buffer = LizardIO_aioPeek(ress.reader, &readBytes);
+        LizardIO_aioWrite(ress.writer, buffer, readBytes);
+        LizardIO_aioConsume(ress.reader, readBytes);
         total += readBytes;
-        storedSkips = LizardIO_fwriteSparse(foutput, buffer, readBytes, storedSkips);
-    }
+    } while (readBytes);
     if (ferror(finput)) EXM_THROW(51, "Read Error")
 
-    LizardIO_fwriteSparseEnd(foutput, storedSkips);
     return total;
 }
 
 
-/** Safely handle cases when (unsigned)offset > LONG_MAX */
-static int fseek_u32(FILE *fp, unsigned offset, int where)
-{
-    const unsigned stepMax = 1U << 30;
-    int errorNb = 0;
-
-    if (where != SEEK_CUR) return -1;  /* Only allows SEEK_CUR */
-    while (offset > 0) {
-        unsigned s = offset;
-        if (s > stepMax) s = stepMax;
-        errorNb = UTIL_fseek(fp, (long) s, SEEK_CUR);
-        if (errorNb != 0) break;
-        offset -= s;
-    }
-    return errorNb;
-}
-
 #define ENDOFSTREAM ((unsigned long long)-1)
-static unsigned long long selectDecoder(dRess_t ress, FILE* finput, FILE* foutput)
+static unsigned long long selectDecoder(dRess_t ress, FILE* finput, int firstStream)
 {
     unsigned char MNstore[MAGICNUMBER_SIZE];
     unsigned magicNumber;
-    static unsigned nbCalls = 0;
-
-    /* init */
-    nbCalls++;
+    int isFileTable;
 
     /* Check Archive Header */
     if (g_magicRead) {  /* magic number already read from finput (see legacy frame)*/
       magicNumber = g_magicRead;
       g_magicRead = 0;
     } else {
-      size_t const nbReadBytes = fread(MNstore, 1, MAGICNUMBER_SIZE, finput);
-      if (nbReadBytes==0) { nbCalls = 0; return ENDOFSTREAM; }   /* EOF */
+      size_t const nbReadBytes = LizardIO_aioRead(ress.reader, MNstore, MAGICNUMBER_SIZE);
+      if (nbReadBytes==0) return ENDOFSTREAM;   /* EOF */
       if (nbReadBytes != MAGICNUMBER_SIZE) EXM_THROW(40, "Unrecognized header : Magic Number unreadable");
       magicNumber = LizardIO_readLE32(MNstore);   /* Little Endian format */
     }
+    isFileTable = (magicNumber == LIZARDIO_FILETABLE_MAGIC) && (ress.writer->table != NULL);   /* extracting a solid archive */
     if (LizardIO_isSkippableMagicNumber(magicNumber)) magicNumber = LIZARDIO_SKIPPABLE0;  /* fold skippable magic numbers */
 
     switch(magicNumber)
     {
     case LIZARDIO_MAGICNUMBER:
-        return LizardIO_decompressLizardF(ress, finput, foutput);
+        return LizardIO_decompressLizardF(ress, finput);
     case LIZARDIO_SKIPPABLE0:
         DISPLAYLEVEL(4, "Skipping detected skippable area \n");
-        { size_t const nbReadBytes = fread(MNstore, 1, 4, finput);
+        { size_t const nbReadBytes = LizardIO_aioRead(ress.reader, MNstore, 4);
           if (nbReadBytes != 4) EXM_THROW(42, "Stream error : skippable size unreadable"); }
         { unsigned const size = LizardIO_readLE32(MNstore);     /* Little Endian format */
-          int const errorNb = fseek_u32(finput, size, SEEK_CUR);
+          int errorNb = 0;
+          if (isFileTable) LizardIO_readFileTable(ress.writer->table, ress.reader, ress.writer, size);
+          else errorNb = LizardIO_aioSkip(ress.reader, size);
           if (errorNb != 0) EXM_THROW(43, "Stream error : cannot skip skippable area"); }
         return 0;
     EXTENDED_FORMAT;  /* macro extension for custom formats */
     default:
-        if (nbCalls == 1) {  /* just started */
-            if (!g_testMode && g_overwrite) {
-                nbCalls = 0;
-                return LizardIO_passThrough(finput, foutput, MNstore);
-            }
+        if (firstStream) {  /* just started */
+            if (!g_testMode && g_overwrite)
+                return LizardIO_passThrough(ress, finput, MNstore);
             EXM_THROW(44,"Unrecognized header : file cannot be decoded");   /* Wrong magic number at the beginning of 1st stream */
         }
         DISPLAYLEVEL(2, "Stream followed by undecodable data\n");
@@ -788,31 +2216,58 @@ static unsigned long long selectDecoder(dRess_t ress, FILE* finput, FILE* foutpu
 }
 
 
-static int LizardIO_decompressSrcFile(dRess_t ress, const char* input_filename, const char* output_filename)
+/* decodes all streams of opened finput, then closes it ; output is written through ress.writer, already started.
+ * result : decoded size */
+static unsigned long long LizardIO_decompressFile(dRess_t ress, FILE* finput, const char* input_filename)
 {
-    FILE* const foutput = ress.dstFile;
     unsigned long long filesize = 0, decodedSize=0;
-    FILE* finput;
+    int firstStream = 1;
 
     /* Init */
-    finput = LizardIO_openSrcFile(input_filename);
-    if (finput==NULL) return 1;
+    LizardIO_startReader(ress.reader, finput, 1);
 
     /* Loop over multiple streams */
     do {
-        decodedSize = selectDecoder(ress, finput, foutput);
+        decodedSize = selectDecoder(ress, finput, firstStream);
+        firstStream = 0;
         if (decodedSize != ENDOFSTREAM)
             filesize += decodedSize;
     } while (decodedSize != ENDOFSTREAM);
 
     /* Close */
+    LizardIO_stopReader(ress.reader);
+    LizardIO_flushWriter(ress.writer);
     fclose(finput);
 
     if (g_removeSrcFile) { if (remove(input_filename)) EXM_THROW(45, "Remove error : %s: %s", input_filename, strerror(errno)); }  /* remove source file : --rm */
 
-    /* Final Status */
+    return filesize;
+}
+
+static void LizardIO_displayDecompressionResult(const char* input_filename, unsigned long long filesize)
+{
     DISPLAYLEVEL(2, "\r%79s\r", "");
     DISPLAYLEVEL(2, "%-20.20s : decoded %llu bytes \n", input_filename, filesize);
+}
+
+/* output is written through ress.writer, already started */
+static int LizardIO_decompressSrcFile(dRess_t ress, const char* input_filename, const char* output_filename)
+{
+    unsigned long long filesize;
+    FILE* finput;
+    UTIL_time_t wallStart;
+    clock_t const cpuStart = clock();
+
+    /* Init */
+    UTIL_getTime(&wallStart);
+    finput = LizardIO_openSrcFile(input_filename);
+    if (finput==NULL) return 1;
+
+    filesize = LizardIO_decompressFile(ress, finput, input_filename);
+    LizardIO_displayStats(ress.reader, ress.writer, wallStart, cpuStart);
+
+    /* Final Status */
+    LizardIO_displayDecompressionResult(input_filename, filesize);
     (void)output_filename;
 
     return 0;
@@ -828,15 +2283,12 @@ static int LizardIO_decompressDstFile(dRess_t ress, const char* input_filename,
     if (foutput==NULL) return 1;   /* failure */
 
     ress.dstFile = foutput;
+    LizardIO_startWriter(ress.writer, g_testMode ? NULL : foutput, 1);
     LizardIO_decompressSrcFile(ress, input_filename, output_filename);
+    LizardIO_stopWriter(ress.writer);
 
     fclose(foutput);
-
-    /* Copy owner, file permissions and modification time */
-    {   stat_t statbuf;
-        if (strcmp (input_filename, stdinmark) && strcmp (output_filename, stdoutmark) && UTIL_getFileStat(input_filename, &statbuf))
-            UTIL_setFileStat(output_filename, &statbuf);
-    }
+    LizardIO_copyFileStat(input_filename, output_filename);
 
     return 0;
 }
@@ -844,7 +2296,7 @@ static int LizardIO_decompressDstFile(dRess_t ress, const char* input_filename,
 
 int LizardIO_decompressFilename(const char* input_filename, const char* output_filename)
 {
-    dRess_t const ress = LizardIO_createDResources();
+    dRess_t const ress = LizardIO_createDResources(g_nbThreads);
     clock_t const start = clock();
 
     int const missingFiles = LizardIO_decompressDstFile(ress, input_filename, output_filename);
@@ -859,38 +2311,647 @@ int LizardIO_decompressFilename(const char* input_filename, const char* output_f
 }
 
 
+static void LizardIO_decompressFileJob(void* ressPtr, LizardIO_fileJob_t* job)
+{
+    dRess_t ress = *(const dRess_t*)ressPtr;
+    ress.dstFile = job->dstFile;
+    LizardIO_startWriter(ress.writer, g_testMode ? NULL : job->dstFile, 1);
+    job->dstSize = LizardIO_decompressFile(ress, job->srcFile, job->srcFileName);
+    LizardIO_stopWriter(ress.writer);
+    fclose(job->dstFile);
+    LizardIO_copyFileStat(job->srcFileName, job->dstFileName);
+}
+
+/* all files are decoded, in order, into stdout */
+static int LizardIO_decompressFilenamesToStdout(const char** inFileNamesTable, int ifntSize)
+{
+    int i;
+    int missingFiles = 0;
+    dRess_t ress = LizardIO_createDResources(g_nbThreads);
+
+    ress.dstFile = LizardIO_openDstFile(stdoutmark);
+    LizardIO_startWriter(ress.writer, g_testMode ? NULL : ress.dstFile, 1);
+    for (i=0; i<ifntSize; i++)
+        missingFiles += LizardIO_decompressSrcFile(ress, inFileNamesTable[i], stdoutmark);
+    LizardIO_stopWriter(ress.writer);
+
+    LizardIO_freeDResources(ress);
+    return missingFiles;
+}
+
+/*
+ * LizardIO_decompressMultipleFilenames() :
+ * with multiple threads, files are decompressed in parallel, one per thread.
+ * result : nb of files which could not be opened or were skipped
+ */
 int LizardIO_decompressMultipleFilenames(const char** inFileNamesTable, int ifntSize, const char* suffix)
 {
     int i;
     int skippedFiles = 0;
     int missingFiles = 0;
-    char* outFileName = (char*)malloc(FNSPACE);
-    size_t ofnSize = FNSPACE;
+    unsigned nbFiles = 0;
+    unsigned long long totalSrcSize = 0, totalDstSize = 0;
     size_t const suffixSize = strlen(suffix);
-    dRess_t ress = LizardIO_createDResources();
+    unsigned const nbWorkers = (ifntSize < 1) ? 1 : (g_nbThreads < (unsigned)ifntSize) ? g_nbThreads : (unsigned)ifntSize;
+    dRess_t* ress;
+    LizardIO_filesCtx_t* ctx;
+    UTIL_time_t wallStart;
+    clock_t const cpuStart = clock();
+    unsigned n;
+
+    if (!strcmp(suffix, stdoutmark)) return LizardIO_decompressFilenamesToStdout(inFileNamesTable, ifntSize);
+
+    UTIL_getTime(&wallStart);
+    ress = (dRess_t*)malloc(nbWorkers * sizeof(dRess_t));
+    if (ress == NULL) return ifntSize;   /* not enough memory */
+    for (n=0; n<nbWorkers; n++) ress[n] = LizardIO_createDResources(nbWorkers > 1 ? 1 : g_nbThreads);
+    ctx = LizardIO_createFilesCtx(nbWorkers, ress, sizeof(dRess_t), LizardIO_decompressFileJob);
+    if (nbWorkers > 1) g_displayProgress = 0;
+
+    /* loop on each file, then report last ones */
+    for (i=0; i<ifntSize+(int)ctx->nbJobs; i++) {
+        LizardIO_fileJob_t* const job = LizardIO_nextFileJob(ctx, (unsigned)i);
+        if (job->submitted) {
+            LizardIO_displayDecompressionResult(job->srcFileName, job->dstSize);
+            totalSrcSize += job->srcSize;
+            totalDstSize += job->dstSize;
+            nbFiles++;
+            job->submitted = 0;
+        }
+        if (i >= ifntSize) continue;
+
+        job->srcFileName = inFileNamesTable[i];
+        {   size_t const ifnSize = strlen(job->srcFileName);
+            if (ifnSize <= suffixSize  ||  strcmp(job->srcFileName + ifnSize - suffixSize, suffix) != 0) {
+                DISPLAYLEVEL(1, "File extension doesn't match expected LIZARD_EXTENSION (%4s); will not process file: %s\n", suffix, job->srcFileName);
+                skippedFiles++;
+                continue;
+            }
+            LizardIO_reserveFileName(job, ifnSize - suffixSize + 1);
+            memcpy(job->dstFileName, job->srcFileName, ifnSize - suffixSize);
+            job->dstFileName[ifnSize-suffixSize] = '\0';
+        }
+        job->srcFile = LizardIO_openSrcFile(job->srcFileName);
+        if (job->srcFile == NULL) { missingFiles++; continue; }
+        job->dstFile = LizardIO_openDstFile(job->dstFileName);
+        if (job->dstFile == NULL) { fclose(job->srcFile); missingFiles++; continue; }
+        job->srcSize = UTIL_getFileSize(job->srcFileName);   /* before --rm */
+        LizardIO_submitFileJob(job);
+    }
 
-    if (outFileName==NULL) return ifntSize;   /* not enough memory */
-    ress.dstFile = LizardIO_openDstFile(stdoutmark);
+    /* Close & Free */
+    g_displayProgress = 1;
+    LizardIO_freeFilesCtx(ctx);
+    for (n=0; n<nbWorkers; n++) {
+        LizardIO_mergeStats(ress[0].reader, ress[n].reader);
+        LizardIO_mergeStats(ress[0].writer, ress[n].writer);
+    }
+    LizardIO_displayStats(ress[0].reader, ress[0].writer, wallStart, cpuStart);
+    LizardIO_displayFilesSummary("decompressed", nbFiles, totalSrcSize, totalDstSize, wallStart);
+    for (n=0; n<nbWorkers; n++) LizardIO_freeDResources(ress[n]);
+    free(ress);
+
+    return missingFiles + skippedFiles;
+}
+
+
+
+/* ********************************************************************* */
+/* **************   Solid mode : many files, one frame   *************** */
+/* ********************************************************************* */
+/* Files are compressed one after another into a single frame of linked blocks : each one can use previous ones as dictionary.
+ * Frame is preceded by a skippable frame (LIZARDIO_FILETABLE_MAGIC) listing them in order :
+ *   nbFiles (LE32), then for each file : size (LE64), name length (LE32), name (not 0-terminated).
+ * Without --solid, decompression skips this table : files are decoded concatenated. */
+
+struct LizardIO_fileTable_s {
+    unsigned nbFiles;
+    const char** names;
+    U64* sizes;
+    char* nameBuffer;     /* extraction : names read from archive */
+    /* extraction state, owned by writer's I/O thread */
+    unsigned next;        /* next file to create */
+    FILE* file;           /* file being written */
+    U64 remaining;        /* bytes still to write into `file` */
+};
+
+static int LizardIO_isSeparator(char c) { return (c == '/') || (c == '\\'); }
+
+/*! LizardIO_solidName() :
+ *  @return : `fileName` without its root, drive or leading "./", as stored in archive,
+ *            or NULL if it contains a ".." component, which could be extracted outside of current directory */
+static const char* LizardIO_solidName(const char* fileName)
+{
+    const char* p;
+    if (fileName[0] && (fileName[1] == ':')) fileName += 2;   /* drive */
+    for (;;) {
+        if (LizardIO_isSeparator(fileName[0])) { fileName++; continue; }
+        if ((fileName[0] == '.') && LizardIO_isSeparator(fileName[1])) { fileName += 2; continue; }
+        break;
+    }
+    for (p = fileName; *p; p++) {
+        if ((p == fileName) || LizardIO_isSeparator(p[-1]))
+            if ((p[0] == '.') && (p[1] == '.') && ((p[2] == 0) || LizardIO_isSeparator(p[2]))) return NULL;
+    }
+    return fileName;
+}
+
+static void LizardIO_freeFileTable(LizardIO_fileTable_t* table)
+{
+    free((void*)table->names);
+    free(table->sizes);
+    free(table->nameBuffer);
+    memset(table, 0, sizeof(*table));
+}
 
+/* creates directories of `fileName`, if they don't exist ; @return : 0, or error code, recorded into `writer` */
+static int LizardIO_createParentDirectories(const char* fileName, LizardIO_aio_t* writer)
+{
+    size_t const length = strlen(fileName);
+    char* const path = (char*)malloc(length + 1);
+    size_t i;
+    if (path == NULL) return LizardIO_aioError(writer, 80, "Allocation error : not enough memory");
+    memcpy(path, fileName, length + 1);
+    for (i = 1; i < length; i++) {
+        if (!LizardIO_isSeparator(path[i])) continue;
+        path[i] = 0;
+        if (!UTIL_isDirectory(path) && LIZARDIO_MKDIR(path)) {
+            int const error = LizardIO_aioError(writer, 80, "Cannot create directory %s : %s", path, strerror(errno));
+            free(path);
+            return error;
+        }
+        path[i] = fileName[i];
+    }
+    free(path);
+    return 0;
+}
+
+/* opens next file of `table` with some content ; empty files are just created.
+ * @return : 0, or error code, recorded into `writer` */
+static int LizardIO_fileTableOpenNext(LizardIO_fileTable_t* table, LizardIO_aio_t* writer)
+{
+    while ((table->file == NULL) && (table->next < table->nbFiles)) {
+        const char* const fileName = table->names[table->next];
+        table->remaining = table->sizes[table->next];
+        table->next++;
+        {   int const error = LizardIO_createParentDirectories(fileName, writer);
+            if (error) return error; }
+        table->file = fopen(fileName, "wb");
+        if (table->file == NULL) return LizardIO_aioError(writer, 81, "%s : %s", fileName, strerror(errno));
+        DISPLAYLEVEL(3, "%s \n", fileName);
+        if (table->remaining == 0) { fclose(table->file); table->file = NULL; }
+    }
+    return 0;
+}
+
+/* same as fwrite(), into successive files of `table` ; called by writer's I/O thread.
+ * @return : 0, or error code, recorded into `writer` */
+static int LizardIO_fileTableWrite(LizardIO_fileTable_t* table, LizardIO_aio_t* writer, const void* buffer, size_t size)
+{
+    while (size) {
+        size_t toWrite = size;
+        {   int const error = LizardIO_fileTableOpenNext(table, writer);
+            if (error) return error; }
+        if (table->names == NULL) return LizardIO_aioError(writer, 82, "Not a solid archive : no file table");
+        if (table->file == NULL) return LizardIO_aioError(writer, 82, "Corrupted solid archive : more data than listed files");
+        if (toWrite > table->remaining) toWrite = (size_t)table->remaining;
+        if (fwrite(buffer, 1, toWrite, table->file) != toWrite) return LizardIO_aioError(writer, 76, "Write error : %s", strerror(errno));
+        buffer = (const char*)buffer + toWrite;
+        size -= toWrite;
+        table->remaining -= toWrite;
+        if (table->remaining == 0) {
+            int const closeError = fclose(table->file);
+            table->file = NULL;
+            if (closeError) return LizardIO_aioError(writer, 76, "Write error : %s", strerror(errno));
+    }   }
+    return 0;
+}
+
+/* all data was written : remaining files must be empty ; called by caller, once `writer` is idle */
+static void LizardIO_fileTableEnd(LizardIO_fileTable_t* table, LizardIO_aio_t* writer)
+{
+    if (LizardIO_fileTableOpenNext(table, writer)) LizardIO_aioCheckError(writer);
+    if (table->file) EXM_THROW(83, "Corrupted solid archive : %s is truncated", table->names[table->next-1]);
+}
+
+/* reads file table of `size` bytes, after its skippable frame header ; previous archive, if any, must be fully written */
+static void LizardIO_readFileTable(LizardIO_fileTable_t* table, LizardIO_aio_t* reader, LizardIO_aio_t* writer, size_t size)
+{
+    BYTE* const buffer = (BYTE*)malloc(size + 1);
+    size_t pos = 4;
+    unsigned u;
+
+    LizardIO_flushWriter(writer);
+    LizardIO_fileTableEnd(table, writer);
+    LizardIO_freeFileTable(table);
+    if (buffer == NULL) EXM_THROW(80, "Allocation error : not enough memory");
+    if (LizardIO_aioRead(reader, buffer, size) != size) EXM_THROW(84, "Corrupted solid archive : truncated file table");
+    if (size < 4) EXM_THROW(84, "Corrupted solid archive : invalid file table");
+    table->nbFiles = LizardIO_readLE32(buffer);
+    if (table->nbFiles > size / 12) EXM_THROW(84, "Corrupted solid archive : invalid file table");
+    table->names = (const char**)malloc(table->nbFiles * sizeof(*table->names));
+    table->sizes = (U64*)malloc(table->nbFiles * sizeof(*table->sizes));
+    table->nameBuffer = (char*)buffer;   /* names are 0-terminated in place, overwriting next size field */
+    if ((table->names == NULL) || (table->sizes == NULL)) EXM_THROW(80, "Allocation error : not enough memory");
+
+    for (u = 0; u < table->nbFiles; u++) {
+        size_t nameLength;
+        char* name;
+        if (size - pos < 12) EXM_THROW(84, "Corrupted solid archive : invalid file table");
+        table->sizes[u] = LizardIO_readLE32(buffer + pos) + ((U64)LizardIO_readLE32(buffer + pos + 4) << 32);
+        nameLength = LizardIO_readLE32(buffer + pos + 8);
+        pos += 12;
+        if ((nameLength == 0) || (nameLength > size - pos)) EXM_THROW(84, "Corrupted solid archive : invalid file table");
+        name = (char*)buffer + pos - 12;   /* size and length fields are already read */
+        memmove(name, buffer + pos, nameLength);
+        name[nameLength] = 0;
+        pos += nameLength;
+        table->names[u] = name;
+        if ((LizardIO_solidName(name) != name) || memchr(name, 0, nameLength))
+            EXM_THROW(85, "Unsafe file name in solid archive : %s", name);
+        if (!g_overwrite && UTIL_isRegFile(name))
+            EXM_THROW(86, "%s already exists ; use -f to overwrite", name);
+    }
+}
+
+/*! LizardIO_compressSolid() :
+ *  compresses all regular files of `inFileNamesTable` into a single archive, `dstFileName` ; see above for format
+ *  @return : nb of files which couldn't be compressed */
+int LizardIO_compressSolid(const char** inFileNamesTable, int ifntSize, const char* dstFileName, int compressionLevel)
+{
+    const size_t blockSize = (size_t)LizardIO_GetBlockSize_FromBlockId(g_blockSizeId);
+    LizardIO_fileTable_t table;
+    LizardF_preferences_t prefs;
+    LizardF_compressOptions_t options;
+    cRess_t ress;
+    FILE* dstFile;
+    unsigned long long totalSize = 0, readSize = 0, compressedSize = 0;
+    size_t tableSize = 4;
+    int i, missingFiles = 0;
+    unsigned u;
+
+    /* list files */
+    memset(&table, 0, sizeof(table));
+    table.names = (const char**)malloc(ifntSize * sizeof(*table.names));
+    table.sizes = (U64*)malloc(ifntSize * sizeof(*table.sizes));
+    if ((table.names == NULL) || (table.sizes == NULL)) EXM_THROW(80, "Allocation error : not enough memory");
     for (i=0; i<ifntSize; i++) {
-        size_t const ifnSize = strlen(inFileNamesTable[i]);
-        const char* const suffixPtr = inFileNamesTable[i] + ifnSize - suffixSize;
-        if (!strcmp(suffix, stdoutmark)) {
-            missingFiles += LizardIO_decompressSrcFile(ress, inFileNamesTable[i], stdoutmark);
-            continue;
+        const char* const name = LizardIO_solidName(inFileNamesTable[i]);
+        if (!UTIL_isRegFile(inFileNamesTable[i])) {
+            DISPLAYLEVEL(1, "%s : not a regular file, ignored \n", inFileNamesTable[i]);
+            missingFiles++; continue;
         }
-        if (ofnSize <= ifnSize-suffixSize+1) { free(outFileName); ofnSize = ifnSize + 20; outFileName = (char*)malloc(ofnSize); if (outFileName==NULL)  return ifntSize; }
-        if (ifnSize <= suffixSize  ||  strcmp(suffixPtr, suffix) != 0) {
-            DISPLAYLEVEL(1, "File extension doesn't match expected LIZARD_EXTENSION (%4s); will not process file: %s\n", suffix, inFileNamesTable[i]);
-            skippedFiles++;
-            continue;
+        if ((name == NULL) || (name[0] == 0)) {
+            DISPLAYLEVEL(1, "%s : file name can't be stored in a solid archive, ignored \n", inFileNamesTable[i]);
+            missingFiles++; continue;
+        }
+        table.names[table.nbFiles] = inFileNamesTable[i];   /* stored name is LizardIO_solidName() */
+        table.sizes[table.nbFiles] = UTIL_getFileSize(inFileNamesTable[i]);
+        totalSize += table.sizes[table.nbFiles];
+        tableSize += 12 + strlen(name);
+        table.nbFiles++;
+    }
+    if (tableSize > LIZARDIO_BLOCKUNCOMPRESSED_FLAG) EXM_THROW(87, "Too many files for a solid archive");
+    dstFile = LizardIO_openDstFile(dstFileName);
+    if (dstFile == NULL) { LizardIO_freeFileTable(&table); return ifntSize; }
+
+    /* Init : blocks are filled across files, hence may end anywhere */
+    memset(&prefs, 0, sizeof(prefs));
+    memset(&options, 0, sizeof(options));
+    prefs.autoFlush = 0;
+    prefs.compressionLevel = compressionLevel;
+    prefs.frameInfo.blockMode = LizardF_blockLinked;
+    prefs.frameInfo.blockSizeID = (LizardF_blockSizeID_t)g_blockSizeId;
+    prefs.frameInfo.contentChecksumFlag = (LizardF_contentChecksum_t)g_streamChecksum;
+    prefs.frameInfo.contentSize = totalSize;
+    if (g_windowSizeFlag) prefs.frameInfo.windowLog = LizardIO_frameWindowLog(compressionLevel, compressionLevel);
+    ress = LizardIO_createCResources(1);
+    LizardIO_freeAio(ress.writer);
+    ress.writer = LizardIO_createAio(LizardF_compressBound(blockSize, &prefs));   /* a whole block, on top of buffered input */
+    LizardIO_startWriter(ress.writer, dstFile, 0);
+
+    /* file table */
+    {   BYTE* const buffer = (BYTE*)malloc(8 + tableSize);
+        size_t pos = 12;
+        if (buffer == NULL) EXM_THROW(80, "Allocation error : not enough memory");
+        LizardIO_writeLE32(buffer, LIZARDIO_FILETABLE_MAGIC);
+        LizardIO_writeLE32(buffer + 4, (unsigned)tableSize);
+        LizardIO_writeLE32(buffer + 8, table.nbFiles);
+        for (u=0; u<table.nbFiles; u++) {
+            const char* const name = LizardIO_solidName(table.names[u]);
+            size_t const nameLength = strlen(name);
+            LizardIO_writeLE32(buffer + pos, (unsigned)table.sizes[u]);
+            LizardIO_writeLE32(buffer + pos + 4, (unsigned)(table.sizes[u] >> 32));
+            LizardIO_writeLE32(buffer + pos + 8, (unsigned)nameLength);
+            memcpy(buffer + pos + 12, name, nameLength);
+            pos += 12 + nameLength;
+        }
+        LizardIO_aioWrite(ress.writer, buffer, pos);
+        compressedSize += pos;
+        free(buffer);
+    }
+
+    /* frame header */
+    {   size_t dstBufferSize;
+        void* const dstBuffer = LizardIO_aioWriteBuffer(ress.writer, &dstBufferSize);
+        size_t const headerSize = LizardF_compressBegin(ress.ctx, dstBuffer, dstBufferSize, &prefs);
+        if (LizardF_isError(headerSize)) EXM_THROW(33, "File header generation failed : %s", LizardF_getErrorName(headerSize));
+        LizardIO_aioCommit(ress.writer, headerSize);
+        compressedSize += headerSize;
+    }
+
+    /* files : input is provided up to block boundaries, so that each update produces at most one block */
+    for (u=0; u<table.nbFiles; u++) {
+        FILE* const srcFile = LizardIO_openSrcFile(table.names[u]);
+        unsigned long long fileSize = 0;
+        if (srcFile == NULL) EXM_THROW(30, "Error reading %s ", table.names[u]);
+        DISPLAYLEVEL(3, "%s \n", table.names[u]);
+        LizardIO_startReader(ress.reader, srcFile, 1);
+        for (;;) {
+            size_t available, outSize, dstBufferSize;
+            const void* const srcBuffer = LizardIO_aioPeek(ress.reader, &available);
+            size_t const blockRemaining = blockSize - (size_t)(readSize % blockSize);
+            void* dstBuffer;
+            if (!available) break;
+            if (available > blockRemaining) available = blockRemaining;
+            if (fileSize + available > table.sizes[u]) break;   /* grown since listed */
+            dstBuffer = LizardIO_aioWriteBuffer(ress.writer, &dstBufferSize);
+            outSize = LizardF_compressUpdate(ress.ctx, dstBuffer, dstBufferSize, srcBuffer, available, &options);
+            if (LizardF_isError(outSize)) EXM_THROW(35, "Compression failed : %s", LizardF_getErrorName(outSize));
+            LizardIO_aioConsume(ress.reader, available);
+            LizardIO_aioCommit(ress.writer, outSize);
+            fileSize += available;
+            readSize += available;
+            compressedSize += outSize;
+            DISPLAYUPDATE(2, "\rRead : %u MB   ==> %.2f%%   ", (unsigned)(readSize>>20), (double)compressedSize/(readSize+!readSize)*100);
         }
-        memcpy(outFileName, inFileNamesTable[i], ifnSize - suffixSize);
-        outFileName[ifnSize-suffixSize] = '\0';
-        missingFiles += LizardIO_decompressDstFile(ress, inFileNamesTable[i], outFileName);
+        if (ferror(srcFile)) EXM_THROW(37, "Error reading %s ", table.names[u]);
+        if (fileSize != table.sizes[u]) EXM_THROW(88, "%s : size changed during compression", table.names[u]);
+        LizardIO_stopReader(ress.reader);
+        fclose(srcFile);
+    }
+
+    /* End of Stream mark */
+    {   size_t dstBufferSize;
+        void* const dstBuffer = LizardIO_aioWriteBuffer(ress.writer, &dstBufferSize);
+        size_t const endSize = LizardF_compressEnd(ress.ctx, dstBuffer, dstBufferSize, NULL);
+        if (LizardF_isError(endSize)) EXM_THROW(38, "End of file generation failed : %s", LizardF_getErrorName(endSize));
+        LizardIO_aioCommit(ress.writer, endSize);
+        compressedSize += endSize;
+    }
+    LizardIO_stopWriter(ress.writer);
+    if (dstFile != stdout) fclose(dstFile);
+    LizardIO_freeCResources(ress);
+
+    if (g_removeSrcFile) {   /* --rm : only once archive is complete */
+        for (u=0; u<table.nbFiles; u++)
+            if (remove(table.names[u])) EXM_THROW(40, "Remove error : %s: %s", table.names[u], strerror(errno));
     }
 
+    DISPLAYLEVEL(2, "\r%79s\r", "");
+    DISPLAYLEVEL(2, "Compressed %u files, %llu bytes into %llu bytes ==> %.2f%%\n",
+                 table.nbFiles, readSize, compressedSize, (double)compressedSize/(readSize+!readSize)*100);
+    LizardIO_freeFileTable(&table);
+    return missingFiles;
+}
+
+/*! LizardIO_decompressSolid() :
+ *  extracts files of solid archive `srcFileName`, with their stored names, relative to current directory
+ *  @return : 0 on success */
+int LizardIO_decompressSolid(const char* srcFileName)
+{
+    dRess_t const ress = LizardIO_createDResources(1);
+    LizardIO_fileTable_t table;
+    unsigned long long decodedSize;
+    FILE* const srcFile = LizardIO_openSrcFile(srcFileName);
+
+    if (srcFile == NULL) { LizardIO_freeDResources(ress); return 1; }
+    memset(&table, 0, sizeof(table));
+    LizardIO_startWriter(ress.writer, NULL, 0);
+    ress.writer->table = &table;   /* set by LizardIO_readFileTable() */
+    decodedSize = LizardIO_decompressFile(ress, srcFile, srcFileName);
+    LizardIO_stopWriter(ress.writer);
+
+    DISPLAYLEVEL(2, "\r%79s\r", "");
+    DISPLAYLEVEL(2, "%-20.20s : extracted %u files, %llu bytes \n", srcFileName, table.nbFiles, decodedSize);
+    LizardIO_freeFileTable(&table);
     LizardIO_freeDResources(ress);
-    free(outFileName);
-    return missingFiles + skippedFiles;
+    return 0;
+}
+
+
+
+/* ********************************************************************* */
+/* ******************   List : no data is decoded   ******************** */
+/* ********************************************************************* */
+
+#define DISPLAYOUT(...)      fprintf(stdout, __VA_ARGS__)
+
+typedef struct {
+    unsigned nbFrames;
+    unsigned nbSkippableFrames;
+    unsigned long long nbBlocks;
+    unsigned long long compressedSize;
+    unsigned long long decompressedSize;
+    int decompressedSizeKnown;
+    int minLevel, maxLevel;            /* of compressed blocks ; 0 : none */
+    LizardF_frameInfo_t frameInfo;     /* of first frame */
+    int mixedBlockSize;                /* set when a frame doesn't share this parameter with first frame */
+    int mixedBlockMode;
+    int mixedChecksum;
+} LizardIO_fileInfo_t;
+
+/* `frameInfo` becomes reference of `info` if `isFirst`, otherwise each parameter it doesn't share with reference is flagged */
+static void LizardIO_addFrameParameters(LizardIO_fileInfo_t* info, const LizardF_frameInfo_t* frameInfo, int isFirst)
+{
+    if (isFirst) { info->frameInfo = *frameInfo; return; }
+    info->mixedBlockSize |= (frameInfo->blockSizeID != info->frameInfo.blockSizeID);
+    info->mixedBlockMode |= (frameInfo->blockMode != info->frameInfo.blockMode);
+    info->mixedChecksum |= (frameInfo->contentChecksumFlag != info->frameInfo.contentChecksumFlag);
+}
+
+/* same as fseek(SEEK_CUR) forward, which also works on pipes ; @return : 0 on success */
+static int LizardIO_fskip(FILE* file, unsigned long long size)
+{
+    char buffer[4 KB];
+    if ((file != stdin) && !UTIL_fseek(file, (off_t)size, SEEK_CUR)) return 0;
+    while (size) {
+        size_t const toRead = (size < sizeof(buffer)) ? (size_t)size : sizeof(buffer);
+        if (fread(buffer, 1, toRead, file) != toRead) return 1;
+        size -= toRead;
+    }
+    return 0;
+}
+
+/*! LizardIO_getFrameInfo() :
+ *  reads a Lizard frame, after its magic number : header is decoded, then blocks are skipped, using their size field.
+ *  Only first byte of compressed blocks is read : it is their compression level.
+ *  @return : 0 on success, or an error message */
+static const char* LizardIO_getFrameInfo(LizardIO_fileInfo_t* info, FILE* srcFile)
+{
+    BYTE header[4+2+8+1];   /* magic number, FLG, BD, content size, HC */
+    size_t headerSize = MAGICNUMBER_SIZE;
+    LizardF_decompressionContext_t dctx;
+    LizardF_frameInfo_t frameInfo;
+    unsigned long long rawSize = 0;
+    int compressedBlocks = 0;
+    size_t blockMaxSize;
+
+    /* frame header */
+    headerSize += fread(header + headerSize, 1, 2, srcFile);
+    if (headerSize != 6) return "truncated frame header";
+    if (header[4] & (1<<3)) headerSize += fread(header + headerSize, 1, 8, srcFile);
+    headerSize += fread(header + headerSize, 1, 1, srcFile);
+    LizardIO_writeLE32(header, LIZARDIO_MAGICNUMBER);
+    {   LizardF_errorCode_t const errorCode = LizardF_createDecompressionContext(&dctx, LIZARDF_VERSION);
+        if (LizardF_isError(errorCode)) EXM_THROW(60, "Can't create Lizard context : %s", LizardF_getErrorName(errorCode));
+    }
+    {   size_t readSize = headerSize;
+        size_t const errorCode = LizardF_getFrameInfo(dctx, &frameInfo, header, &readSize);
+        LizardF_freeDecompressionContext(dctx);
+        if (LizardF_isError(errorCode) || (readSize != headerSize)) return "invalid frame header";
+    }
+    LizardIO_addFrameParameters(info, &frameInfo, info->nbFrames == 0);
+    info->nbFrames++;
+    info->compressedSize += headerSize;
+    blockMaxSize = LizardIO_GetBlockSize_FromBlockId(frameInfo.blockSizeID);
+
+    /* blocks */
+    for (;;) {
+        BYTE blockHeader[4+1];   /* size, compression level */
+        unsigned blockSize;
+        if (fread(blockHeader, 1, 4, srcFile) != 4) return "truncated block header";
+        info->compressedSize += 4;
+        blockSize = LizardIO_readLE32(blockHeader);
+        if (blockSize == 0) break;   /* end mark */
+        info->nbBlocks++;
+        info->compressedSize += blockSize & ~LIZARDIO_BLOCKUNCOMPRESSED_FLAG;
+        if (blockSize & LIZARDIO_BLOCKUNCOMPRESSED_FLAG) {
+            blockSize &= ~LIZARDIO_BLOCKUNCOMPRESSED_FLAG;
+            if (blockSize > blockMaxSize) return "invalid block size";
+            rawSize += blockSize;
+            if (LizardIO_fskip(srcFile, blockSize)) return "truncated block";
+            continue;
+        }
+        if (fread(blockHeader+4, 1, 1, srcFile) != 1) return "truncated block";
+        if ((blockHeader[4] < LIZARD_MIN_CLEVEL) || (blockHeader[4] > LIZARD_MAX_CLEVEL)) return "invalid block";
+        if ((info->minLevel == 0) || (blockHeader[4] < info->minLevel)) info->minLevel = blockHeader[4];
+        if (blockHeader[4] > info->maxLevel) info->maxLevel = blockHeader[4];
+        compressedBlocks = 1;
+        if (LizardIO_fskip(srcFile, blockSize-1)) return "truncated block";
+    }
+    if (frameInfo.contentChecksumFlag) {
+        if (LizardIO_fskip(srcFile, 4)) return "truncated content checksum";
+        info->compressedSize += 4;
+    }
+
+    /* decoded size : from frame header, or when no block needs to be decoded */
+    if (frameInfo.contentSize) info->decompressedSize += frameInfo.contentSize;
+    else if (!compressedBlocks) info->decompressedSize += rawSize;
+    else info->decompressedSizeKnown = 0;
+    return NULL;
+}
+
+/* @return : 0 on success, 1 if `srcFileName` can't be listed (error is displayed) */
+static int LizardIO_getFileInfo(LizardIO_fileInfo_t* info, const char* srcFileName)
+{
+    FILE* const srcFile = LizardIO_openSrcFile(srcFileName);
+    const char* error = NULL;
+
+    memset(info, 0, sizeof(*info));
+    info->decompressedSizeKnown = 1;
+    if (srcFile == NULL) return 1;
+
+    /* all frames, as decoder would read them */
+    while (!error) {
+        BYTE MNstore[MAGICNUMBER_SIZE];
+        size_t const nbReadBytes = fread(MNstore, 1, MAGICNUMBER_SIZE, srcFile);
+        unsigned magicNumber;
+        if (nbReadBytes == 0) break;   /* EOF */
+        if (nbReadBytes != MAGICNUMBER_SIZE) { error = "magic number unreadable"; break; }
+        magicNumber = LizardIO_readLE32(MNstore);
+        if (magicNumber == LIZARDIO_MAGICNUMBER) {
+            error = LizardIO_getFrameInfo(info, srcFile);
+        } else if (LizardIO_isSkippableMagicNumber(magicNumber)) {
+            if (fread(MNstore, 1, 4, srcFile) != 4) { error = "skippable size unreadable"; break; }
+            if (LizardIO_fskip(srcFile, LizardIO_readLE32(MNstore))) { error = "truncated skippable frame"; break; }
+            info->nbSkippableFrames++;
+            info->compressedSize += 8 + LizardIO_readLE32(MNstore);
+        } else if (info->nbFrames + info->nbSkippableFrames) {
+            DISPLAYLEVEL(2, "%s : stream followed by undecodable data\n", srcFileName);
+            break;
+        } else {
+            error = "not a .liz file";
+        }
+    }
+    if (!error && !info->nbFrames) error = "no Lizard frame";
+    if (ferror(srcFile)) error = strerror(errno);
+    if (srcFile != stdin) fclose(srcFile);
+
+    if (error) { DISPLAYLEVEL(1, "%s : %s \n", srcFileName, error); return 1; }
+    return 0;
+}
+
+static void LizardIO_displayFileInfo(const LizardIO_fileInfo_t* info, const char* fileName)
+{
+    char levels[16] = "-";
+    char decompressedSize[24] = "-";
+    char ratio[16] = "-";
+    char blockSize[16] = "-";
+    const char* blockMode = "-";
+    const char* check = "-";
+
+    if (info->minLevel == info->maxLevel) { if (info->minLevel) snprintf(levels, sizeof(levels), "%i", info->minLevel); }
+    else snprintf(levels, sizeof(levels), "%i-%i", info->minLevel, info->maxLevel);
+    if (info->decompressedSizeKnown) {
+        snprintf(decompressedSize, sizeof(decompressedSize), "%llu", info->decompressedSize);
+        if (info->compressedSize) snprintf(ratio, sizeof(ratio), "%.3f", (double)info->decompressedSize / info->compressedSize);
+    }
+    if (info->nbFrames) {
+        size_t const bSize = LizardIO_GetBlockSize_FromBlockId(info->frameInfo.blockSizeID);
+        if (info->mixedBlockSize) strcpy(blockSize, "mixed");
+        else if (bSize >= 1 MB) snprintf(blockSize, sizeof(blockSize), "%u MB", (unsigned)(bSize >> 20));
+        else snprintf(blockSize, sizeof(blockSize), "%u KB", (unsigned)(bSize >> 10));
+        if (info->mixedBlockMode) blockMode = "mixed";
+        else blockMode = (info->frameInfo.blockMode == LizardF_blockIndependent) ? "indep" : "linked";
+        if (info->mixedChecksum) check = "mixed";
+        else check = info->frameInfo.contentChecksumFlag ? "XXH32" : "-";
+    }
+    DISPLAYOUT("%6u %8llu %14llu %14s %7s %6s %8s %7s %6s  %s\n",
+               info->nbFrames, info->nbBlocks, info->compressedSize, decompressedSize, ratio,
+               levels, blockSize, blockMode, check, fileName);
+}
+
+int LizardIO_listMultipleFilenames(const char** inFileNamesTable, int ifntSize)
+{
+    LizardIO_fileInfo_t total;
+    int i, nbFiles = 0, missingFiles = 0;
+
+    memset(&total, 0, sizeof(total));
+    total.decompressedSizeKnown = 1;
+    DISPLAYOUT("%6s %8s %14s %14s %7s %6s %8s %7s %6s  %s\n",
+               "Frames", "Blocks", "Compressed", "Decompressed", "Ratio", "Level", "Block", "Mode", "Check", "Filename");
+    for (i=0; i<ifntSize; i++) {
+        LizardIO_fileInfo_t info;
+        if (LizardIO_getFileInfo(&info, inFileNamesTable[i])) { missingFiles++; continue; }
+        LizardIO_displayFileInfo(&info, inFileNamesTable[i]);
+        LizardIO_addFrameParameters(&total, &info.frameInfo, !nbFiles);
+        total.mixedBlockSize |= info.mixedBlockSize;
+        total.mixedBlockMode |= info.mixedBlockMode;
+        total.mixedChecksum |= info.mixedChecksum;
+        total.nbFrames += info.nbFrames;
+        total.nbBlocks += info.nbBlocks;
+        total.compressedSize += info.compressedSize;
+        total.decompressedSize += info.decompressedSize;
+        total.decompressedSizeKnown &= info.decompressedSizeKnown;
+        if (info.minLevel && ((total.minLevel == 0) || (info.minLevel < total.minLevel))) total.minLevel = info.minLevel;
+        if (info.maxLevel > total.maxLevel) total.maxLevel = info.maxLevel;
+        nbFiles++;
+    }
+    if (nbFiles > 1) {
+        char name[32];
+        snprintf(name, sizeof(name), "(%i files)", nbFiles);
+        LizardIO_displayFileInfo(&total, name);
+    }
+    return missingFiles;
 }
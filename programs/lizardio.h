@@ -59,6 +59,20 @@ int LizardIO_decompressFilename(const char* input_filename, const char* output_f
 int LizardIO_compressMultipleFilenames(const char** inFileNamesTable, int ifntSize, const char* suffix, int compressionlevel);
 int LizardIO_decompressMultipleFilenames(const char** inFileNamesTable, int ifntSize, const char* suffix);
 
+/* Solid mode : all files are compressed into a single frame of linked blocks, within `dstFileName`,
+   so that each file can use previous ones as dictionary. A skippable frame before it lists their names and sizes.
+   Regular decompression ignores this list, and produces files concatenated.
+   return : nb of files which couldn't be compressed */
+int LizardIO_compressSolid(const char** inFileNamesTable, int ifntSize, const char* dstFileName, int compressionLevel);
+/* extracts files of solid archive `srcFileName`, with their stored names, relative to current directory
+   return : 0 on success */
+int LizardIO_decompressSolid(const char* srcFileName);
+
+/* displays frames, blocks, sizes and parameters of each .liz file, reading only headers : no data is decoded.
+   Decompressed size is known from frame header (--content-size), or when no block is compressed.
+   return : nb of files which couldn't be listed */
+int LizardIO_listMultipleFilenames(const char** inFileNamesTable, int ifntSize);
+
 
 /* ************************************************** */
 /* ****************** Parameters ******************** */
@@ -95,7 +109,45 @@ int LizardIO_setSparseFile(int enable);
 /* Default setting : 0 (disabled) */
 int LizardIO_setContentSize(int enable);
 
+/* Default setting : 0 (disabled)
+   Frame header of linked blocks carries window of compression level, so decoders keep no more history.
+   Such frames can't be read by v1.0 decoders. */
+int LizardIO_setWindowSize(int enable);
+
 void LizardIO_setRemoveSrcFile(unsigned flag);
 
+/* Default setting : 1 (single-threaded)
+   Compression splits input into jobs of whole blocks; decompression is parallel for independent blocks only.
+   With multiple files (-m, -r), whole files are processed in parallel instead, one per thread.
+   return : nb of threads used (1 if multi-threading is not supported by this build) */
+unsigned LizardIO_setNbThreads(unsigned nbThreads);
+
+/* Default setting : 0 (disabled)
+   1 : after each file, display elapsed and cpu time, and time spent reading and writing,
+       including time (de)compression had to wait for I/O */
+int LizardIO_setDisplayStats(int enable);
+
+/* Default setting : 1 (enabled, where supported)
+   Regular input files are memory-mapped. Frames with known content size are decoded into mapped output
+   (not sparse). Holes of mapped sparse input files are neither read nor parsed.
+   Pipes, stdin and stdout are always streamed.
+   return : 1 if memory mapping is used */
+int LizardIO_setMemoryMap(int enable);
+
+/* Default setting : 0 (disabled)
+   Compression level is adjusted between blocks, within [minLevel, maxLevel] :
+   raised while compression waits for input or output, lowered while I/O waits for compression.
+   minLevel == maxLevel == 0 : range of starting level (e.g. 10-19 for -17).
+   Single-threaded compression only.
+   return : 1 if enabled */
+int LizardIO_setAdaptiveMode(int enable, int minLevel, int maxLevel);
+
+/* Default setting : 0 (disabled)
+   1 : independent blocks also end at content-defined boundaries (rolling hash),
+       so that a local change of input only changes a few blocks of output (rsync, deduplication).
+   Implies independent blocks; --adapt is ignored, and each file is compressed by a single thread.
+   return : 1 if enabled */
+int LizardIO_setRsyncable(int enable);
+
 
 #endif  /* LIZARDIO_H_237902873 */
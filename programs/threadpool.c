@@ -0,0 +1,170 @@
+/*
+    threadpool.c - minimal thread pool for command line tools
+    Copyright (C) 2016-present, Przemyslaw Skibinski, Yann Collet
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+
+/* *************************************
+*  Includes
+***************************************/
+#include <stdlib.h>      /* malloc, calloc, free */
+#include "threadpool.h"
+
+
+/* *************************************
+*  Constants
+***************************************/
+#define TPOOL_MAX_THREADS 256
+
+
+typedef struct {
+    TPOOL_function function;
+    void* opaque;
+} TPOOL_job;
+
+struct TPOOL_ctx_s {
+#if defined(LIZARD_MULTITHREAD)
+    pthread_t* threads;
+#endif
+    unsigned nbThreads;
+    TPOOL_job* queue;
+    unsigned queueSize;
+    unsigned queueHead;
+    unsigned queueNb;     /* nb of jobs waiting in queue */
+    unsigned nbRunning;   /* nb of jobs being executed */
+    int shutdown;
+    TP_mutex_t mutex;
+    TP_cond_t queuePush;  /* signaled when a job is added, or on shutdown */
+    TP_cond_t queuePop;   /* signaled when a job is taken or completed */
+};
+
+
+unsigned TPOOL_maxThreads(void)
+{
+#if defined(LIZARD_MULTITHREAD)
+    return TPOOL_MAX_THREADS;
+#else
+    return 1;
+#endif
+}
+
+
+#if defined(LIZARD_MULTITHREAD)
+
+static void* TPOOL_thread(void* opaque)
+{
+    TPOOL_ctx* const ctx = (TPOOL_ctx*)opaque;
+    for (;;) {
+        TPOOL_job job;
+        TP_mutex_lock(&ctx->mutex);
+        while (!ctx->queueNb && !ctx->shutdown) TP_cond_wait(&ctx->queuePush, &ctx->mutex);
+        if (!ctx->queueNb) {   /* shutdown, and nothing left to do */
+            TP_mutex_unlock(&ctx->mutex);
+            return opaque;
+        }
+        job = ctx->queue[ctx->queueHead];
+        ctx->queueHead = (ctx->queueHead + 1) % ctx->queueSize;
+        ctx->queueNb--;
+        ctx->nbRunning++;
+        TP_cond_broadcast(&ctx->queuePop);
+        TP_mutex_unlock(&ctx->mutex);
+
+        job.function(job.opaque);
+
+        TP_mutex_lock(&ctx->mutex);
+        ctx->nbRunning--;
+        TP_cond_broadcast(&ctx->queuePop);
+        TP_mutex_unlock(&ctx->mutex);
+    }
+}
+
+#endif
+
+
+TPOOL_ctx* TPOOL_create(unsigned nbThreads, unsigned queueSize)
+{
+    TPOOL_ctx* const ctx = (TPOOL_ctx*)calloc(1, sizeof(TPOOL_ctx));
+    if (!ctx) return NULL;
+    if (nbThreads > TPOOL_maxThreads()) nbThreads = TPOOL_maxThreads();
+    if (queueSize < 1) queueSize = 1;
+    ctx->queueSize = queueSize;
+    ctx->queue = (TPOOL_job*)malloc(queueSize * sizeof(TPOOL_job));
+    if (!ctx->queue) { free(ctx); return NULL; }
+    TP_mutex_init(&ctx->mutex);
+    TP_cond_init(&ctx->queuePush);
+    TP_cond_init(&ctx->queuePop);
+#if defined(LIZARD_MULTITHREAD)
+    ctx->threads = (pthread_t*)malloc(nbThreads * sizeof(pthread_t));
+    if (nbThreads && !ctx->threads) { TPOOL_free(ctx); return NULL; }
+    for ( ; ctx->nbThreads < nbThreads; ctx->nbThreads++) {
+        if (pthread_create(&ctx->threads[ctx->nbThreads], NULL, TPOOL_thread, ctx)) {
+            TPOOL_free(ctx);
+            return NULL;
+    }   }
+#else
+    ctx->nbThreads = nbThreads;
+#endif
+    return ctx;
+}
+
+
+void TPOOL_free(TPOOL_ctx* ctx)
+{
+    if (!ctx) return;
+    TP_mutex_lock(&ctx->mutex);
+    ctx->shutdown = 1;
+    TP_cond_broadcast(&ctx->queuePush);
+    TP_mutex_unlock(&ctx->mutex);
+#if defined(LIZARD_MULTITHREAD)
+    {   unsigned n;
+        for (n=0; n<ctx->nbThreads; n++) pthread_join(ctx->threads[n], NULL);
+    }
+    free(ctx->threads);
+#endif
+    TP_cond_destroy(&ctx->queuePop);
+    TP_cond_destroy(&ctx->queuePush);
+    TP_mutex_destroy(&ctx->mutex);
+    free(ctx->queue);
+    free(ctx);
+}
+
+
+void TPOOL_add(TPOOL_ctx* ctx, TPOOL_function function, void* opaque)
+{
+#if defined(LIZARD_MULTITHREAD)
+    if (ctx->nbThreads) {
+        TP_mutex_lock(&ctx->mutex);
+        while (ctx->queueNb == ctx->queueSize) TP_cond_wait(&ctx->queuePop, &ctx->mutex);
+        ctx->queue[(ctx->queueHead + ctx->queueNb) % ctx->queueSize].function = function;
+        ctx->queue[(ctx->queueHead + ctx->queueNb) % ctx->queueSize].opaque = opaque;
+        ctx->queueNb++;
+        TP_cond_signal(&ctx->queuePush);
+        TP_mutex_unlock(&ctx->mutex);
+        return;
+    }
+#endif
+    (void)ctx;
+    function(opaque);   /* no worker thread : run synchronously */
+}
+
+
+void TPOOL_jobsCompleted(TPOOL_ctx* ctx)
+{
+    TP_mutex_lock(&ctx->mutex);
+    while (ctx->queueNb || ctx->nbRunning) TP_cond_wait(&ctx->queuePop, &ctx->mutex);
+    TP_mutex_unlock(&ctx->mutex);
+}
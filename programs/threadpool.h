@@ -0,0 +1,96 @@
+/*
+    threadpool.h - minimal thread pool for command line tools
+    Copyright (C) 2016-present, Przemyslaw Skibinski, Yann Collet
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+*/
+
+#ifndef THREADPOOL_H_MODULE
+#define THREADPOOL_H_MODULE
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+
+/*-****************************************
+*  Synchronization primitives
+*  LIZARD_MULTITHREAD enables POSIX threads.
+*  Without it, no thread is started : mutexes and conditions are no-op,
+*  and jobs are run synchronously by TPOOL_add().
+******************************************/
+#if defined(LIZARD_MULTITHREAD)
+#  include <pthread.h>
+#  define TP_mutex_t              pthread_mutex_t
+#  define TP_mutex_init(m)        pthread_mutex_init((m), NULL)
+#  define TP_mutex_destroy(m)     pthread_mutex_destroy(m)
+#  define TP_mutex_lock(m)        pthread_mutex_lock(m)
+#  define TP_mutex_unlock(m)      pthread_mutex_unlock(m)
+#  define TP_cond_t               pthread_cond_t
+#  define TP_cond_init(c)         pthread_cond_init((c), NULL)
+#  define TP_cond_destroy(c)      pthread_cond_destroy(c)
+#  define TP_cond_wait(c, m)      pthread_cond_wait((c), (m))
+#  define TP_cond_signal(c)       pthread_cond_signal(c)
+#  define TP_cond_broadcast(c)    pthread_cond_broadcast(c)
+#else
+#  define TP_mutex_t              int
+#  define TP_mutex_init(m)        ((void)(m))
+#  define TP_mutex_destroy(m)     ((void)(m))
+#  define TP_mutex_lock(m)        ((void)(m))
+#  define TP_mutex_unlock(m)      ((void)(m))
+#  define TP_cond_t               int
+#  define TP_cond_init(c)         ((void)(c))
+#  define TP_cond_destroy(c)      ((void)(c))
+#  define TP_cond_wait(c, m)      ((void)(c), (void)(m))
+#  define TP_cond_signal(c)       ((void)(c))
+#  define TP_cond_broadcast(c)    ((void)(c))
+#endif
+
+
+/*-****************************************
+*  Thread pool
+******************************************/
+typedef struct TPOOL_ctx_s TPOOL_ctx;
+typedef void (*TPOOL_function)(void* opaque);
+
+/*! TPOOL_create() :
+ *  Starts `nbThreads` worker threads, sharing a queue of up to `queueSize` pending jobs.
+ *  With `nbThreads` == 0, jobs are run synchronously by TPOOL_add().
+ *  @return : pool, or NULL if allocation or thread creation failed */
+TPOOL_ctx* TPOOL_create(unsigned nbThreads, unsigned queueSize);
+
+/*! TPOOL_free() :
+ *  Waits for all queued jobs, then stops worker threads and releases the pool. */
+void TPOOL_free(TPOOL_ctx* ctx);
+
+/*! TPOOL_add() :
+ *  Queues `function(opaque)` for execution by a worker thread.
+ *  Blocks while the queue is full. */
+void TPOOL_add(TPOOL_ctx* ctx, TPOOL_function function, void* opaque);
+
+/*! TPOOL_jobsCompleted() :
+ *  Blocks until the queue is empty and no job is running. */
+void TPOOL_jobsCompleted(TPOOL_ctx* ctx);
+
+/*! TPOOL_maxThreads() :
+ *  @return : 1 if built without LIZARD_MULTITHREAD, an arbitrary upper limit otherwise */
+unsigned TPOOL_maxThreads(void);
+
+
+#if defined (__cplusplus)
+}
+#endif
+
+#endif /* THREADPOOL_H_MODULE */
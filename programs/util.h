@@ -144,6 +144,15 @@ extern "C" {
 *  Time functions
 ******************************************/
 #if (PLATFORM_POSIX_VERSION >= 1)
+#include <time.h>        /* clock_gettime, CLOCK_MONOTONIC */
+#endif
+#if (PLATFORM_POSIX_VERSION >= 1) && defined(CLOCK_MONOTONIC)   /* nanosecond resolution, not affected by clock changes */
+   typedef U64 UTIL_time_t;   /* nanoseconds */
+   UTIL_STATIC void UTIL_initTimer(UTIL_time_t* ticksPerSecond) { *ticksPerSecond = 1000000000ULL; }
+   UTIL_STATIC void UTIL_getTime(UTIL_time_t* x) { struct timespec t; clock_gettime(CLOCK_MONOTONIC, &t); *x = ((U64)t.tv_sec * 1000000000ULL) + (U64)t.tv_nsec; }
+   UTIL_STATIC U64 UTIL_getSpanTimeMicro(UTIL_time_t ticksPerSecond, UTIL_time_t clockStart, UTIL_time_t clockEnd) { (void)ticksPerSecond; return (clockEnd - clockStart) / 1000; }
+   UTIL_STATIC U64 UTIL_getSpanTimeNano(UTIL_time_t ticksPerSecond, UTIL_time_t clockStart, UTIL_time_t clockEnd) { (void)ticksPerSecond; return clockEnd - clockStart; }
+#elif (PLATFORM_POSIX_VERSION >= 1)   /* 10 ms resolution */
 #include <unistd.h>
 #include <sys/times.h>   /* times */
    typedef U64 UTIL_time_t;
@@ -175,6 +184,15 @@ UTIL_STATIC U64 UTIL_clockSpanMicro( UTIL_time_t clockStart, UTIL_time_t ticksPe
 }
 
 
+/* returns time span in nanoseconds */
+UTIL_STATIC U64 UTIL_clockSpanNano( UTIL_time_t clockStart, UTIL_time_t ticksPerSecond )
+{
+    UTIL_time_t clockEnd;
+    UTIL_getTime(&clockEnd);
+    return UTIL_getSpanTimeNano(ticksPerSecond, clockStart, clockEnd);
+}
+
+
 UTIL_STATIC void UTIL_waitForNextTick(UTIL_time_t ticksPerSecond)
 {
     UTIL_time_t clockStart, clockEnd;
@@ -185,6 +203,45 @@ UTIL_STATIC void UTIL_waitForNextTick(UTIL_time_t ticksPerSecond)
 }
 
 
+/*-****************************************
+*  System information
+******************************************/
+/* returns number of online logical cores, or 1 if unknown */
+UTIL_STATIC int UTIL_countCores(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO sysinfo;
+    GetSystemInfo(&sysinfo);
+    return (int)sysinfo.dwNumberOfProcessors;
+#elif (PLATFORM_POSIX_VERSION >= 1) && defined(_SC_NPROCESSORS_ONLN)
+    long const nbCores = sysconf(_SC_NPROCESSORS_ONLN);
+    return (nbCores > 0) ? (int)nbCores : 1;
+#else
+    return 1;
+#endif
+}
+
+
+#if (PLATFORM_POSIX_VERSION >= 1)
+#include <sys/resource.h>   /* getrusage */
+#endif
+/* returns peak resident memory of process so far, in bytes, or 0 if unknown */
+UTIL_STATIC U64 UTIL_getPeakMemory(void)
+{
+#if (PLATFORM_POSIX_VERSION >= 1)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage)) return 0;
+#  if defined(__APPLE__)
+    return (U64)usage.ru_maxrss;          /* bytes */
+#  else
+    return (U64)usage.ru_maxrss * 1024;   /* kilobytes */
+#  endif
+#else
+    return 0;
+#endif
+}
+
+
 
 /*-****************************************
 *  File functions
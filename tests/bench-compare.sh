@@ -0,0 +1,113 @@
+#!/bin/sh
+# bench-compare.sh : compares two result files of `lizard -b --format=csv|json`
+# usage : bench-compare.sh OLD NEW [THRESHOLD]
+# Records are matched by file, level, block size and nb of threads.
+# Median speeds and ratio lower than OLD by more than THRESHOLD % (default : 5) are reported as regressions.
+# exit code : 0 if no regression, 1 if any, 2 on usage error
+
+if [ $# -lt 2 ] || [ ! -r "$1" ] || [ ! -r "$2" ]; then
+    echo "usage : $0 OLD NEW [THRESHOLD]" >&2
+    exit 2
+fi
+
+awk -v threshold="${3:-5}" '
+# reads the json string starting at pos (opening quote), unescaping it ; pos ends after closing quote
+function jsonString(s,    c, out) {
+    out = ""
+    for (pos++; pos <= length(s); pos++) {
+        c = substr(s, pos, 1)
+        if (c == "\"") { pos++; return out }
+        if (c == "\\") {
+            c = substr(s, ++pos, 1)
+            if (c == "u") { c = sprintf("%c", hexValue(substr(s, pos+1, 4))); pos += 4 }
+            else if (c == "n") c = "\n"
+            else if (c == "t") c = "\t"
+        }
+        out = out c
+    }
+    return out
+}
+
+function hexValue(h,    i, v) {
+    v = 0
+    for (i = 1; i <= length(h); i++) v = v * 16 + index("0123456789abcdef", tolower(substr(h, i, 1))) - 1
+    return v
+}
+
+# splits csv line s into fields[] : quoted fields may hold commas, "" within them is a quote
+function csvSplit(s, fields,    n, i, c, f, quoted) {
+    n = 0; f = ""; quoted = 0
+    for (i = 1; i <= length(s); i++) {
+        c = substr(s, i, 1)
+        if (quoted) {
+            if (c != "\"") f = f c
+            else if (substr(s, i+1, 1) == "\"") { f = f c; i++ }
+            else quoted = 0
+        }
+        else if (c == "\"") quoted = 1
+        else if (c == ",") { fields[++n] = f; f = "" }
+        else f = f c
+    }
+    fields[++n] = f
+    return n
+}
+
+# fills rec[] with fields of current line, csv (after its header) or json (one flat object per line)
+function parse(    n, i, c, name, start, fields) {
+    split("", rec)
+    if (substr($0, 1, 1) == "{") {
+        pos = 2
+        while (pos <= length($0)) {
+            if (substr($0, pos, 1) != "\"") { pos++; continue }
+            name = jsonString($0)
+            while (substr($0, pos, 1) == " " || substr($0, pos, 1) == ":") pos++
+            if (substr($0, pos, 1) == "\"") { rec[name] = jsonString($0); continue }
+            start = pos
+            while (pos <= length($0) && (c = substr($0, pos, 1)) != "," && c != "}") pos++
+            rec[name] = substr($0, start, pos - start)
+        }
+        return 1
+    }
+    if (substr($0, 1, 5) == "file,") {   # csv header
+        nbCols = csvSplit($0, header)
+        return 0
+    }
+    n = csvSplit($0, fields)
+    for (i = 1; i <= n && i <= nbCols; i++) rec[header[i]] = fields[i]
+    return n > 1
+}
+
+function key() { return rec["file"] " -" rec["level"] " B" rec["block_size"] " T" rec["threads"] }
+
+function compare(name, oldValue, newValue,    delta) {
+    if (oldValue <= 0) return
+    delta = (newValue - oldValue) / oldValue * 100
+    flag = ""
+    if (delta < -threshold) { flag = "  <== REGRESSION"; regressions++ }
+    printf "%-40s %-14s %10.2f %10.2f %+7.1f%%%s\n", k, name, oldValue, newValue, delta, flag
+}
+
+FNR == 1 { fileNb++; nbCols = 0 }
+
+fileNb == 1 {
+    if (!parse()) next
+    k = key()
+    oldRatio[k] = rec["ratio"]; oldC[k] = rec["c_mbs_median"]; oldD[k] = rec["d_mbs_median"]
+    next
+}
+
+{
+    if (!parse()) next
+    k = key()
+    if (!(k in oldRatio)) { printf "%-40s only in new results\n", k; next }
+    compare("ratio", oldRatio[k], rec["ratio"])
+    compare("compression", oldC[k], rec["c_mbs_median"])
+    compare("decompression", oldD[k], rec["d_mbs_median"])
+    matched++
+}
+
+END {
+    printf "%d records compared, %d regressions beyond %s%%\n", matched, regressions, threshold
+    exit (regressions > 0)
+}
+' "$1" "$2"
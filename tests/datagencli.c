@@ -27,6 +27,7 @@
 *  Includes
 **************************************/
 #include <stdio.h>     /* fprintf, stderr */
+#include <string.h>    /* strncmp */
 #include "datagen.h"   /* RDG_generate */
 
 
@@ -86,6 +87,12 @@ static int usage(char* programName)
     DISPLAY( " -g#    : generate # data (default:%i)\n", SIZE_DEFAULT);
     DISPLAY( " -s#    : Select seed (default:%i)\n", SEED_DEFAULT);
     DISPLAY( " -P#    : Select compressibility in %% (default:%i%%)\n", COMPRESSIBILITY_DEFAULT);
+    DISPLAY( "--type=NAME : Select generator (default:lz) : \n");
+    DISPLAY( "         lz      : matches and literals, compressibility set by -P# \n");
+    DISPLAY( "         logs    : text log lines \n");
+    DISPLAY( "         json    : nested JSON documents, one per line \n");
+    DISPLAY( "         columns : sorted and delta-friendly integer columns \n");
+    DISPLAY( "         binary  : code, strings and tables, with incompressible sections \n");
     DISPLAY( " -h     : display help and exit\n");
     DISPLAY( "Special values :\n");
     DISPLAY( " -P0    : generate incompressible noise\n");
@@ -101,6 +108,7 @@ int main(int argc, char** argv)
     double litProba = 0.0;
     U64 size = SIZE_DEFAULT;
     U32 seed = SEED_DEFAULT;
+    RDG_type_e type = RDG_lz;
     char* programName;
 
     /* Check command line */
@@ -111,6 +119,13 @@ int main(int argc, char** argv)
 
         if(!argument) continue;   /* Protection if argument empty */
 
+        if (!strncmp(argument, "--type=", 7))
+        {
+            type = RDG_typeFromName(argument + 7);
+            if (type == RDG_nbTypes) { DISPLAY("unknown generator : %s \n", argument + 7); return 1; }
+            continue;
+        }
+
         /* Handle commands. Aggregated commands are allowed */
         if (*argument=='-')
         {
@@ -183,9 +198,10 @@ int main(int argc, char** argv)
 
     DISPLAYLEVEL(4, "Data Generator %s \n", ZSTD_VERSION);
     DISPLAYLEVEL(3, "Seed = %u \n", seed);
+    if (type!=RDG_lz) DISPLAYLEVEL(3, "Generator : %s\n", RDG_typeName(type));
     if (proba!=COMPRESSIBILITY_DEFAULT) DISPLAYLEVEL(3, "Compressibility : %i%%\n", (U32)(proba*100));
 
-    RDG_genOut(size, proba, litProba, seed);
+    RDG_genTypedOut(size, type, proba, litProba, seed);
     DISPLAYLEVEL(1, "\n");
 
     return 0;
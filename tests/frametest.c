@@ -95,6 +95,7 @@ static const U32 prime2 = 2246822519U;
 /*-************************************
 *  Macros
 **************************************/
+#define MIN(a,b)              ( (a) < (b) ? (a) : (b) )
 #define DISPLAY(...)          fprintf(stderr, __VA_ARGS__)
 #define DISPLAYLEVEL(l, ...)  if (displayLevel>=l) { DISPLAY(__VA_ARGS__); }
 #define DISPLAYUPDATE(l, ...) if (displayLevel>=l) { \
@@ -395,6 +396,233 @@ int basicTests(U32 seed, double compressibility)
     if (LizardF_isError(cSize)) goto _output_error;
     DISPLAYLEVEL(3, "Compressed %i bytes into a %i bytes frame \n", (int)testSize, (int)cSize);
 
+    DISPLAYLEVEL(3, "Linked blocks, window size not requested : readable by v1.0 decoders : \n");
+    memset(&prefs, 0, sizeof(prefs));
+    prefs.frameInfo.blockMode = LizardF_blockLinked;
+    prefs.compressionLevel = LIZARD_MIN_CLEVEL;
+    cSize = LizardF_compressFrame(compressedBuffer, LizardF_compressFrameBound(testSize, &prefs), CNBuffer, testSize, &prefs);
+    if (LizardF_isError(cSize)) goto _output_error;
+    if ((((const BYTE*)compressedBuffer)[5] & 15) != 0) goto _output_error;   /* window size field of BD byte */
+    DISPLAYLEVEL(3, "Compressed %i bytes into a %i bytes frame \n", (int)testSize, (int)cSize);
+
+    DISPLAYLEVEL(3, "LizardF_getHeaderInfo() : default window of linked blocks, corrupted header \n");
+    {   LizardF_frameInfo_t fi;
+        BYTE* const hc = (BYTE*)compressedBuffer + 6;   /* header checksum, without content size */
+        size_t const hSize = LizardF_getHeaderInfo(&fi, compressedBuffer, cSize);
+        if (hSize != 7) goto _output_error;
+        if ((fi.blockMode != LizardF_blockLinked) || (fi.windowLog != 24)) goto _output_error;
+        if (LizardF_getHeaderInfo(&fi, compressedBuffer, 6) != (size_t)-LizardF_ERROR_frameHeader_incomplete) goto _output_error;
+        (*hc)++;
+        if (LizardF_getHeaderInfo(&fi, compressedBuffer, cSize) != (size_t)-LizardF_ERROR_headerChecksum_invalid) goto _output_error;
+        (*hc)--;
+    }
+
+    DISPLAYLEVEL(3, "Linked blocks with requested level window : \n");
+    {   size_t errorCode;
+        BYTE* const ostart = (BYTE*)compressedBuffer;
+        BYTE* op = ostart;
+        const BYTE* ip = (const BYTE*)CNBuffer;
+        const BYTE* const iend = ip + testSize;
+        LizardF_frameInfo_t fi;
+        U64 crcDest;
+
+        memset(&prefs, 0, sizeof(prefs));
+        prefs.frameInfo.blockMode = LizardF_blockLinked;
+        prefs.compressionLevel = LIZARD_MIN_CLEVEL;   /* LZ4 codewords : 64 KB window */
+        prefs.frameInfo.windowLog = 16;
+        errorCode = LizardF_createCompressionContext(&cctx, LIZARDF_VERSION);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        errorCode = LizardF_compressBegin(cctx, op, LizardF_compressFrameBound(testSize, &prefs), &prefs);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        op += errorCode;
+        while (ip < iend) {
+            size_t const iSize = MIN(40 KB, (size_t)(iend-ip));   /* not a multiple of block size, forces tmp buffer wrap */
+            errorCode = LizardF_compressUpdate(cctx, op, LizardF_compressBound(iSize, &prefs), ip, iSize, NULL);
+            if (LizardF_isError(errorCode)) goto _output_error;
+            op += errorCode;
+            ip += iSize;
+        }
+        errorCode = LizardF_compressEnd(cctx, op, LizardF_compressBound(0, &prefs), NULL);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        op += errorCode;
+        cSize = op - ostart;
+        errorCode = LizardF_freeCompressionContext(cctx);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        cctx = NULL;
+        DISPLAYLEVEL(3, "Compressed %i bytes into a %i bytes frame \n", (int)testSize, (int)cSize);
+
+        errorCode = LizardF_createDecompressionContext(&dCtx, LIZARDF_VERSION);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        {   size_t iSize = cSize;
+            errorCode = LizardF_getFrameInfo(dCtx, &fi, compressedBuffer, &iSize);
+            if (LizardF_isError(errorCode)) goto _output_error;
+            if (fi.windowLog != 16) goto _output_error;
+            DISPLAYLEVEL(3, "windowLog=%u \n", fi.windowLog);
+            ip = (const BYTE*)compressedBuffer + iSize;
+        }
+        {   BYTE* dp = (BYTE*)decodedBuffer;
+            BYTE* const dend = dp + testSize;
+            const BYTE* const cend = (const BYTE*)compressedBuffer + cSize;
+            while (ip < cend) {
+                size_t oSize = MIN(3000, (size_t)(dend-dp));   /* smaller than a block : decodes through tmpOut */
+                size_t iSize = cend - ip;
+                errorCode = LizardF_decompress(dCtx, dp, &oSize, ip, &iSize, NULL);
+                if (LizardF_isError(errorCode)) goto _output_error;
+                dp += oSize;
+                ip += iSize;
+            }
+        }
+        crcDest = XXH64(decodedBuffer, testSize, 1);
+        if (crcDest != crcOrig) goto _output_error;
+        errorCode = LizardF_freeDecompressionContext(dCtx);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        dCtx = NULL;
+        DISPLAYLEVEL(3, "Regenerated %i bytes \n", (int)testSize);
+        memset(&prefs, 0, sizeof(prefs));
+    }
+
+    DISPLAYLEVEL(3, "Linked blocks with tmp buffer wraparound : \n");
+    {   size_t errorCode;
+        BYTE* const ostart = (BYTE*)compressedBuffer;
+        BYTE* op = ostart;
+        const BYTE* ip = (const BYTE*)CNBuffer;
+        const BYTE* const iend = ip + testSize;
+        U64 crcDest;
+
+        prefs.frameInfo.blockMode = LizardF_blockLinked;
+        prefs.frameInfo.windowLog = 17;   /* window >= block size : tmp buffer is reused as a ring buffer */
+        prefs.compressionLevel = 20;
+        errorCode = LizardF_createCompressionContext(&cctx, LIZARDF_VERSION);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        errorCode = LizardF_compressBegin(cctx, op, LizardF_compressFrameBound(testSize, &prefs), &prefs);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        op += errorCode;
+        while (ip < iend) {
+            size_t const iSize = MIN(40 KB, (size_t)(iend-ip));
+            errorCode = LizardF_compressUpdate(cctx, op, LizardF_compressBound(iSize, &prefs), ip, iSize, NULL);
+            if (LizardF_isError(errorCode)) goto _output_error;
+            op += errorCode;
+            ip += iSize;
+        }
+        errorCode = LizardF_compressEnd(cctx, op, LizardF_compressBound(0, &prefs), NULL);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        op += errorCode;
+        cSize = op - ostart;
+        errorCode = LizardF_freeCompressionContext(cctx);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        cctx = NULL;
+        DISPLAYLEVEL(3, "Compressed %i bytes into a %i bytes frame \n", (int)testSize, (int)cSize);
+
+        errorCode = LizardF_createDecompressionContext(&dCtx, LIZARDF_VERSION);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        {   size_t oSize = COMPRESSIBLE_NOISE_LENGTH;
+            size_t iSize = cSize;
+            errorCode = LizardF_decompress(dCtx, decodedBuffer, &oSize, compressedBuffer, &iSize, NULL);
+            if (errorCode != 0) goto _output_error;
+            if (oSize != testSize) goto _output_error;
+        }
+        crcDest = XXH64(decodedBuffer, testSize, 1);
+        if (crcDest != crcOrig) goto _output_error;
+        errorCode = LizardF_freeDecompressionContext(dCtx);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        dCtx = NULL;
+        DISPLAYLEVEL(3, "Regenerated %i bytes \n", (int)testSize);
+        memset(&prefs, 0, sizeof(prefs));
+    }
+
+    DISPLAYLEVEL(3, "Direct decoding of linked blocks (stableDst, known content size) : \n");
+    {   size_t errorCode;
+        size_t const srcSize = testSize - 100 KB;   /* last block is shorter than maxBlockSize */
+        LizardF_decompressOptions_t dOptions;
+        U64 crcDest;
+
+        prefs.frameInfo.blockMode = LizardF_blockLinked;
+        prefs.frameInfo.blockSizeID = LizardF_max256KB;
+        prefs.frameInfo.contentSize = srcSize;
+        cSize = LizardF_compressFrame(compressedBuffer, LizardF_compressFrameBound(srcSize, &prefs), CNBuffer, srcSize, &prefs);
+        if (LizardF_isError(cSize)) goto _output_error;
+        DISPLAYLEVEL(3, "Compressed %i bytes into a %i bytes frame \n", (int)srcSize, (int)cSize);
+
+        memset(&dOptions, 0, sizeof(dOptions));
+        dOptions.stableDst = 1;
+        errorCode = LizardF_createDecompressionContext(&dCtx, LIZARDF_VERSION);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        {   const BYTE* ip = (const BYTE*)compressedBuffer;
+            const BYTE* const cend = ip + cSize;
+            BYTE* dp = (BYTE*)decodedBuffer;
+            BYTE* const dend = dp + srcSize;   /* exactly sized : last block decoded in place */
+            while (ip < cend) {
+                size_t oSize = dend - dp;
+                size_t iSize = MIN(1000, (size_t)(cend-ip));
+                errorCode = LizardF_decompress(dCtx, dp, &oSize, ip, &iSize, &dOptions);
+                if (LizardF_isError(errorCode)) goto _output_error;
+                dp += oSize;
+                ip += iSize;
+            }
+            if (dp != dend) goto _output_error;
+        }
+        if (LizardF_getDecodedCopied(dCtx) != 0) goto _output_error;   /* no block went through tmpOut, no history was moved */
+        crcDest = XXH64(decodedBuffer, srcSize, 1);
+        if (crcDest != XXH64(CNBuffer, srcSize, 1)) goto _output_error;
+        errorCode = LizardF_freeDecompressionContext(dCtx);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        dCtx = NULL;
+        DISPLAYLEVEL(3, "Regenerated %i bytes \n", (int)srcSize);
+        memset(&prefs, 0, sizeof(prefs));
+    }
+
+    DISPLAYLEVEL(3, "Zero-copy linked blocks (stableSrc) : \n");
+    {   size_t errorCode;
+        BYTE* const ostart = (BYTE*)compressedBuffer;
+        BYTE* op = ostart;
+        const BYTE* ip = (const BYTE*)CNBuffer;
+        const BYTE* const iend = ip + testSize;
+        LizardF_compressOptions_t cOptions;
+        U64 crcDest;
+
+        memset(&cOptions, 0, sizeof(cOptions));
+        cOptions.stableSrc = 1;
+        prefs.frameInfo.blockMode = LizardF_blockLinked;
+        errorCode = LizardF_createCompressionContext(&cctx, LIZARDF_VERSION);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        errorCode = LizardF_compressBegin(cctx, op, LizardF_compressFrameBound(testSize, &prefs), &prefs);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        op += errorCode;
+        while (ip < iend) {
+            size_t const iSize = MIN(128 KB, (size_t)(iend-ip));   /* whole blocks : nothing buffered within cctx */
+            errorCode = LizardF_compressUpdate(cctx, op, LizardF_compressBound(iSize, &prefs), ip, iSize, &cOptions);
+            if (LizardF_isError(errorCode)) goto _output_error;
+            if (errorCode == 0) goto _output_error;
+            op += errorCode;
+            ip += iSize;
+        }
+        if (LizardF_getHistoryCopied(cctx) != 0) goto _output_error;   /* history referenced in place */
+        errorCode = LizardF_compressEnd(cctx, op, LizardF_compressBound(0, &prefs), NULL);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        op += errorCode;
+        cSize = op - ostart;
+        errorCode = LizardF_freeCompressionContext(cctx);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        cctx = NULL;
+        DISPLAYLEVEL(3, "Compressed %i bytes into a %i bytes frame \n", (int)testSize, (int)cSize);
+
+        errorCode = LizardF_createDecompressionContext(&dCtx, LIZARDF_VERSION);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        {   size_t oSize = COMPRESSIBLE_NOISE_LENGTH;
+            size_t iSize = cSize;
+            errorCode = LizardF_decompress(dCtx, decodedBuffer, &oSize, compressedBuffer, &iSize, NULL);
+            if (errorCode != 0) goto _output_error;
+            if (oSize != testSize) goto _output_error;
+        }
+        crcDest = XXH64(decodedBuffer, testSize, 1);
+        if (crcDest != crcOrig) goto _output_error;
+        errorCode = LizardF_freeDecompressionContext(dCtx);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        dCtx = NULL;
+        DISPLAYLEVEL(3, "Regenerated %i bytes \n", (int)testSize);
+        memset(&prefs, 0, sizeof(prefs));
+    }
+
     {   size_t errorCode;
         BYTE* const ostart = (BYTE*)compressedBuffer;
         BYTE* op = ostart;
@@ -445,6 +673,41 @@ int basicTests(U32 seed, double compressibility)
         cctx = NULL;
     }
 
+    DISPLAYLEVEL(3, "rsyncable, incompressible input : output within LizardF_compressBound() : \n");
+    {   size_t errorCode;
+        BYTE* op = (BYTE*)compressedBuffer;
+        const BYTE* ip = (const BYTE*)decodedBuffer;
+        const BYTE* const iend = ip + (256 KB);
+        U32 noiseState = seed;
+
+        FUZ_fillCompressibleNoiseBuffer(decodedBuffer, 256 KB, 0.0, &noiseState);
+        memset(&prefs, 0, sizeof(prefs));
+        prefs.frameInfo.blockSizeID = LizardF_max128KB;
+        prefs.rsyncable = 1;
+        errorCode = LizardF_createCompressionContext(&cctx, LIZARDF_VERSION);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        errorCode = LizardF_compressBegin(cctx, op, LizardF_compressFrameBound(256 KB, &prefs), &prefs);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        op += errorCode;
+        while (ip < iend) {
+            size_t const iSize = MIN((FUZ_rand(&randState) & (32 KB - 1)) + 1, (size_t)(iend-ip));
+            size_t const oSize = LizardF_compressBound(iSize, &prefs);
+            errorCode = LizardF_compressUpdate(cctx, op, oSize, ip, iSize, NULL);
+            if (LizardF_isError(errorCode)) goto _output_error;
+            if (errorCode > oSize) goto _output_error;
+            op += errorCode;
+            ip += iSize;
+        }
+        errorCode = LizardF_compressEnd(cctx, op, LizardF_compressBound(0, &prefs), NULL);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        op += errorCode;
+        DISPLAYLEVEL(3, "Compressed %i bytes into a %i bytes frame \n", (int)(256 KB), (int)(op - (BYTE*)compressedBuffer));
+        errorCode = LizardF_freeCompressionContext(cctx);
+        if (LizardF_isError(errorCode)) goto _output_error;
+        cctx = NULL;
+        memset(&prefs, 0, sizeof(prefs));
+    }
+
     DISPLAYLEVEL(3, "Skippable frame test : \n");
     {   size_t decodedBufferSize = COMPRESSIBLE_NOISE_LENGTH;
         unsigned maxBits = FUZ_highbit((U32)decodedBufferSize);
@@ -603,6 +866,7 @@ int fuzzerTests(U32 seed, unsigned nbTests, unsigned startTest, double compressi
         prefs.frameInfo.contentChecksumFlag = (LizardF_contentChecksum_t)CCflag;
         prefs.frameInfo.contentSize = frameContentSize;
         prefs.autoFlush = autoflush;
+        prefs.rsyncable = ((FUZ_rand(&randState) & 0x7) == 1);
         prefs.compressionLevel = LIZARD_MIN_CLEVEL + (FUZ_rand(&randState) % (1+LIZARD_MAX_CLEVEL-LIZARD_MIN_CLEVEL));
         if ((FUZ_rand(&randState) & 0x1F) == 1) prefsPtr = NULL;
 
@@ -637,6 +901,7 @@ int fuzzerTests(U32 seed, unsigned nbTests, unsigned startTest, double compressi
 
                 result = LizardF_compressUpdate(cCtx, op, oSize, ip, iSize, &cOptions);
                 CHECK(LizardF_isError(result), "Compression failed (error %i) iSize=%d oSize=%d", (int)result, (int)iSize, (int)oSize);
+                CHECK(result > oSize, "Compression overflow : %i bytes written, oSize=%d", (int)result, (int)oSize);
                 op += result;
                 ip += iSize;
 
@@ -644,6 +909,11 @@ int fuzzerTests(U32 seed, unsigned nbTests, unsigned startTest, double compressi
                     result = LizardF_flush(cCtx, op, oend-op, &cOptions);
                     CHECK(LizardF_isError(result), "Compression flush failed (error %i)", (int)result);
                     op += result;
+                    if ((FUZ_rand(&randState) & 3) == 1) {   /* block boundary : level can change */
+                        int const cLevel = LIZARD_MIN_CLEVEL + (FUZ_rand(&randState) % (1+LIZARD_MAX_CLEVEL-LIZARD_MIN_CLEVEL));
+                        result = LizardF_setCompressionLevel(cCtx, cLevel);
+                        CHECK(LizardF_isError(result), "Compression level change failed (error %i)", (int)result);
+                    }
                 }
             }
             result = LizardF_compressEnd(cCtx, op, oend-op, &cOptions);
@@ -58,6 +58,7 @@
 #include "lizard_decompress.h"
 #include "lizard_common.h"  /* Lizard_compress_MinLevel, Lizard_createStream_MinLevel */
 #include "lizard_frame.h"
+#include "lizard_frame_static.h"   /* LizardF_getHistoryCopied */
 
 #include "xxhash/xxhash.h"
 
@@ -307,6 +308,46 @@ static int local_LizardF_compressFrame(const char* in, char* out, int inSize)
     return (int)LizardF_compressFrame(out, 2*inSize + 16, in, inSize, NULL);
 }
 
+/* LizardF_compressUpdate() fed with whole blocks, history either copied (stableSrc==0) or referenced in place (stableSrc==1) */
+static LizardF_compressionContext_t g_cCtx;
+static size_t g_frameDstSize;
+static unsigned g_stableSrc;
+static U64 g_historyCopied;
+
+static int local_LizardF_compressUpdate(const char* in, char* out, int inSize)
+{
+    LizardF_preferences_t prefs;
+    LizardF_compressOptions_t options;
+    size_t const blockSize = LIZARD_BLOCK_SIZE;
+    size_t const inputSize = (size_t)inSize;
+    size_t pos = 0, result;
+    char* op = out;
+    char* const oend = out + g_frameDstSize;
+
+    memset(&prefs, 0, sizeof(prefs));
+    prefs.autoFlush = 1;
+    memset(&options, 0, sizeof(options));
+    options.stableSrc = g_stableSrc;
+
+    result = LizardF_compressBegin(g_cCtx, op, oend-op, &prefs);
+    if (LizardF_isError(result)) { DISPLAY("Error starting frame : %s \n", LizardF_getErrorName(result)); exit(8); }
+    op += result;
+
+    while (pos < inputSize) {
+        size_t const toRead = (inputSize - pos < blockSize) ? inputSize - pos : blockSize;
+        result = LizardF_compressUpdate(g_cCtx, op, oend-op, in+pos, toRead, &options);
+        if (LizardF_isError(result)) { DISPLAY("Error compressing block : %s \n", LizardF_getErrorName(result)); exit(8); }
+        op += result;
+        pos += toRead;
+    }
+
+    g_historyCopied = LizardF_getHistoryCopied(g_cCtx);
+    result = LizardF_compressEnd(g_cCtx, op, oend-op, NULL);
+    if (LizardF_isError(result)) { DISPLAY("Error ending frame : %s \n", LizardF_getErrorName(result)); exit(8); }
+    op += result;
+    return (int)(op - out);
+}
+
 static LizardF_decompressionContext_t g_dCtx;
 
 static int local_LizardF_decompress(const char* in, char* out, int inSize, int outSize)
@@ -330,6 +371,8 @@ int fullSpeedBench(const char** fileNamesTable, int nbFiles)
     /* Init */
     { size_t const errorCode = LizardF_createDecompressionContext(&g_dCtx, LIZARDF_VERSION);
       if (LizardF_isError(errorCode)) { DISPLAY("dctx allocation issue \n"); return 10; } }
+    { size_t const errorCode = LizardF_createCompressionContext(&g_cCtx, LIZARDF_VERSION);
+      if (LizardF_isError(errorCode)) { DISPLAY("cctx allocation issue \n"); return 10; } }
 
   Lizard_streamPtr = Lizard_createStream(0);
   if (!Lizard_streamPtr) { DISPLAY("Lizard_streamPtr allocation issue \n"); return 10; }
@@ -370,7 +413,7 @@ int fullSpeedBench(const char** fileNamesTable, int nbFiles)
       orig_buff = (char*) malloc(benchedSize);
       nbChunks = (int) ((benchedSize + (g_chunkSize-1)) / g_chunkSize);
       maxCompressedChunkSize = Lizard_compressBound(g_chunkSize);
-      compressedBuffSize = nbChunks * maxCompressedChunkSize;
+      compressedBuffSize = nbChunks * maxCompressedChunkSize + (int)LizardF_compressBound(LIZARD_BLOCK_SIZE, NULL);   /* room for frame header and block headers */
       compressed_buff = (char*)malloc((size_t)compressedBuffSize);
       if(!chunkP || !orig_buff || !compressed_buff) {
           DISPLAY("\nError: not enough memory!\n");
@@ -446,6 +489,14 @@ int fullSpeedBench(const char** fileNamesTable, int nbFiles)
             case 30: compressionFunction = local_LizardF_compressFrame; compressorName = "LizardF_compressFrame";
                         chunkP[0].origSize = (int)benchedSize; nbChunks=1;
                         break;
+            case 31: compressionFunction = local_LizardF_compressUpdate; compressorName = "LizardF_compressUpdate(copy)";
+                        g_stableSrc = 0; g_frameDstSize = compressedBuffSize;
+                        chunkP[0].origSize = (int)benchedSize; nbChunks=1;
+                        break;
+            case 32: compressionFunction = local_LizardF_compressUpdate; compressorName = "LizardF_compressUpdate(ref)";
+                        g_stableSrc = 1; g_frameDstSize = compressedBuffSize;
+                        chunkP[0].origSize = (int)benchedSize; nbChunks=1;
+                        break;
             case 40: compressionFunction = local_Lizard_saveDict; compressorName = "Lizard_saveDict";
                         Lizard_loadDict(Lizard_stream, chunkP[0].origBuffer, chunkP[0].origSize);
                         break;
@@ -494,6 +545,8 @@ int fullSpeedBench(const char** fileNamesTable, int nbFiles)
                 DISPLAY("%2i-%-28.28s :%9i ->%9i (%5.2f%%),%7.1f MB/s\n", cAlgNb, compressorName, (int)benchedSize, (int)cSize, ratio, (double)benchedSize / bestTime / 1000000);
             else
                 DISPLAY("%2i-%-28.28s :%9i ->%9i (%5.1f%%),%7.1f MB/s\n", cAlgNb, compressorName, (int)benchedSize, (int)cSize, ratio, (double)benchedSize / bestTime / 100000);
+            if (compressionFunction == local_LizardF_compressUpdate)
+                DISPLAY("%31s : history copied :%9u (%5.2f%% of input)\n", "", (unsigned)g_historyCopied, (double)g_historyCopied/(double)benchedSize*100.);
         }
 
         /* Prepare layout for decompression */
@@ -593,6 +646,7 @@ int fullSpeedBench(const char** fileNamesTable, int nbFiles)
     Lizard_freeStream(Lizard_stream);
     Lizard_freeStream(Lizard_streamPtr);
     LizardF_freeDecompressionContext(g_dCtx);
+    LizardF_freeCompressionContext(g_cCtx);
     if (g_pause) { printf("press enter...\n"); (void)getchar(); }
 
     return 0;
@@ -299,6 +299,7 @@ static int FUZ_test(U32 seed, U32 nbCycles, const U32 startCycle, const double c
     decodedBuffer = (char*)malloc(FUZ_MAX_DICT_SIZE + FUZ_MAX_BLOCK_SIZE);
 
     if (!stateLizard || !stateLizardHC || !Lizarddict || !Lizard_streamHCPtr || !CNBuffer || !compressedBuffer || !decodedBuffer) goto _output_error;
+    memset(stateLizardHC, 0xA5, Lizard_sizeofState(0));   /* states provided by caller are not initialized */
 
     FUZ_fillCompressibleNoiseBuffer(CNBuffer, COMPRESSIBLE_NOISE_LENGTH, compressibility, &randState);
 
@@ -359,6 +360,34 @@ static int FUZ_test(U32 seed, U32 nbCycles, const U32 startCycle, const double c
         ret = Lizard_compress_extState(stateLizardHC, block, compressedBuffer, blockSize, Lizard_compressBound(blockSize), 0);
         FUZ_CHECKTEST(ret==0, "Lizard_compress_extState() failed");
 
+        /* Test compression with overridden parameters, at a level using them (hash chain, lowest price) */
+        FUZ_DISPLAYTEST;
+        {   Lizard_cParams_t cParams;
+            int const cLevel = 13 + (FUZ_rand(&randState) % 13);   /* 13-25 */
+            void* state;
+            memset(&cParams, 0, sizeof(cParams));   /* 0 : default of level */
+            cParams.windowLog = LIZARD_WINDOWLOG_MIN + (FUZ_rand(&randState) % 7);   /* valid for all levels */
+            cParams.hashLog = LIZARD_HASHLOG_MIN + (FUZ_rand(&randState) % 11);
+            cParams.searchNum = FUZ_rand(&randState) % 65;
+            cParams.searchLength = (FUZ_rand(&randState) & 1) ? LIZARD_SEARCHLENGTH_MIN + (FUZ_rand(&randState) % 4) : 0;
+            cParams.sufficientLength = FUZ_rand(&randState) % 256;
+            state = malloc(Lizard_sizeofState_advanced(cLevel, cParams));
+            FUZ_CHECKTEST(state==NULL, "Lizard_sizeofState_advanced() allocation failed");
+            ret = Lizard_compress_advanced(state, block, compressedBuffer, blockSize, Lizard_compressBound(blockSize), cLevel, cParams);
+            FUZ_CHECKTEST(ret==0, "Lizard_compress_advanced() failed");
+            compressedSize = ret;
+            ret = Lizard_decompress_safe(compressedBuffer, decodedBuffer, compressedSize, blockSize);
+            FUZ_CHECKTEST(ret!=blockSize, "Lizard_decompress_safe() failed on Lizard_compress_advanced() output");
+            FUZ_CHECKTEST(memcmp(block, decodedBuffer, blockSize), "Lizard_compress_advanced() output corrupted");
+            cParams.hashLog = LIZARD_HASHLOG_MAX + 1;
+            ret = Lizard_compress_advanced(state, block, compressedBuffer, blockSize, Lizard_compressBound(blockSize), cLevel, cParams);
+            FUZ_CHECKTEST(ret!=0, "Lizard_compress_advanced() should have failed, due to invalid hashLog");
+            free(state);
+            memset(&cParams, 0, sizeof(cParams));
+            FUZ_CHECKTEST(!Lizard_getCParams(10 + (FUZ_rand(&randState) % 2), &cParams), "Lizard_getCParams() failed");
+            FUZ_CHECKTEST(cParams.hashLog || cParams.contentLog || cParams.searchNum || !cParams.windowLog, "Lizard_getCParams() : parameters unused by fast levels should be 0");
+        }
+
         /* Test compression using external state */
         FUZ_DISPLAYTEST;
         ret = Lizard_compress_extState_MinLevel(stateLizard, block, compressedBuffer, blockSize, Lizard_compressBound(blockSize));
@@ -384,6 +413,20 @@ static int FUZ_test(U32 seed, U32 nbCycles, const U32 startCycle, const double c
         crcCheck = XXH32(decodedBuffer, blockSize, 0);
         FUZ_CHECKTEST(crcCheck!=crcOrig, "Lizard_decompress_safe corrupted decoded data");
 
+        /* Test block statistics : each byte of compressed data is accounted for */
+        FUZ_DISPLAYTEST;
+        {   Lizard_blockStats_t stats;
+            unsigned long long storedSize = 0;
+            int type;
+            memset(&stats, 0, sizeof(stats));
+            ret = Lizard_getBlockStats(compressedBuffer, compressedSize, &stats);
+            FUZ_CHECKTEST(ret, "Lizard_getBlockStats() failed");
+            for (type=0; type<Lizard_stream_count; type++) storedSize += stats.storedSize[type];
+            FUZ_CHECKTEST(storedSize + stats.nbSubBlocks + stats.nbBlocks != (unsigned long long)compressedSize, "Lizard_getBlockStats() sizes do not add up");
+            ret = Lizard_getBlockStats(compressedBuffer, compressedSize-1, &stats);
+            FUZ_CHECKTEST(ret==0 && compressedSize > 2, "Lizard_getBlockStats() should have failed, due to input size being one byte too short");
+        }
+
         // Test decoding with more than enough output size => must work
         FUZ_DISPLAYTEST;
         decodedBuffer[blockSize] = 0;
@@ -855,6 +898,62 @@ static void FUZ_unitTests(U32 seed)
             }
         }
 
+        /* stream-owned ring buffer test */
+        {   XXH64_state_t xxhOrig;
+            XXH64_state_t xxhNew;
+            Lizard_streamDecode_t decodeState;
+            const U32 maxMessageSizeLog = 10;
+            const U32 maxMessageSizeMask = (1<<maxMessageSizeLog) - 1;
+            U32 messageSize = (FUZ_rand(&randState) & maxMessageSizeMask) + 1;
+            U32 iNext = 0;
+            U32 dNext = 0;
+            const U32 dBufferSize = ringBufferSize + maxMessageSizeMask;
+
+            XXH64_reset(&xxhOrig, 0);
+            XXH64_reset(&xxhNew, 0);
+            streamPtr = Lizard_resetStream(streamPtr, 0);
+            FUZ_CHECKTEST(streamPtr==NULL, "Lizard_resetStream failed");
+            result = Lizard_setRingBuffer(streamPtr, ringBufferSize);
+            FUZ_CHECKTEST(result!=ringBufferSize, "Lizard_setRingBuffer() failed");
+            Lizard_setStreamDecode(&decodeState, NULL, 0);
+
+            while (iNext + messageSize < testCompressedSize) {
+                const char* src = testInput + iNext;
+                XXH64_update(&xxhOrig, testInput + iNext, messageSize);
+                crcOrig = XXH64_digest(&xxhOrig);
+
+                if (FUZ_rand(&randState) & 1) {   /* append in place */
+                    char* const ringPtr = Lizard_getRingBuffer(streamPtr, messageSize);
+                    FUZ_CHECKTEST(ringPtr==NULL, "Lizard_getRingBuffer() failed");
+                    memcpy(ringPtr, testInput + iNext, messageSize);
+                    src = ringPtr;
+                }
+                result = Lizard_compress_ringBuffer(streamPtr, src, testCompressed, messageSize, testCompressedSize-ringBufferSize);
+                FUZ_CHECKTEST(result==0, "Lizard_compress_ringBuffer() compression failed");
+
+                result = Lizard_decompress_safe_continue(&decodeState, testCompressed, testVerify + dNext, result, messageSize);
+                FUZ_CHECKTEST(result!=(int)messageSize, "owned ringBuffer : Lizard_decompress_safe() test failed");
+
+                XXH64_update(&xxhNew, testVerify + dNext, messageSize);
+                crcNew = XXH64_digest(&xxhNew);
+                FUZ_CHECKTEST(crcOrig!=crcNew, "Lizard_compress_ringBuffer() decompression corruption");
+
+                /* prepare next message */
+                iNext += messageSize;
+                dNext += messageSize;
+                messageSize = (FUZ_rand(&randState) & maxMessageSizeMask) + 1;
+                if (dNext + messageSize > dBufferSize) dNext = 0;
+            }
+
+            /* stream used as state of one-shot compression keeps its ring buffer, released below */
+            {   char* const ringPtr = Lizard_getRingBuffer(streamPtr, 1);
+                result = Lizard_compress_extState(streamPtr, testInput, testCompressed, messageSize, testCompressedSize, 0);
+                FUZ_CHECKTEST(result==0, "Lizard_compress_extState() failed on a stream owning a ring buffer");
+                FUZ_CHECKTEST(Lizard_getRingBuffer(streamPtr, 1)!=ringPtr, "Lizard_compress_extState() lost ring buffer of stream");
+            }
+            Lizard_setRingBuffer(streamPtr, 0);
+        }
+
         /* small decoder-side ring buffer test */
         {   XXH64_state_t xxhOrig;
             XXH64_state_t xxhNew;